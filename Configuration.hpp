@@ -212,6 +212,17 @@
 #define GYRO_AXIS_SWAP 1
 #endif
 
+/**
+ * @brief ST-4 guide port configuration.
+ * Set USE_GUIDE_PORT to 1 to guide from the ST-4 port of an autoguider, 0 or #undef to exclude it from configuration.
+ * Requires 4 digital inputs (GUIDE_PORT_NORTH_PIN, GUIDE_PORT_EAST_PIN, GUIDE_PORT_SOUTH_PIN, GUIDE_PORT_WEST_PIN),
+ * which the guider pulls to ground. On ATmega they must be pin change interrupt pins (default A8-A11), and the
+ * guide port cannot be used with SoftwareSerial (DRIVER_TYPE_TMC2209_UART). On ESP32 any GPIO with a pull-up works.
+ */
+#ifndef USE_GUIDE_PORT
+#define USE_GUIDE_PORT 0
+#endif
+
 /**
  * @brief Automated azimuth/altitude adjustment configuration.
  * Set AZIMUTH_ALTITUDE_MOTORS to 1 to enable, 0 or #undef to exclude AZ/ALT from configuration.
@@ -273,6 +284,8 @@
 // Platform
 #if defined(ESP32) || defined(__AVR_ATmega2560__)
   // Valid platform
+#elif defined(OAT_HOST_BUILD)
+  // Host build (env:native) for tests and simulation, uses the ATmega2560 pin layout
 #else
   #error Unsupported platform configuration. Use at own risk.
 #endif
@@ -280,6 +293,8 @@
 // Display & keypad configurations
 #if defined(ESP32) && ((DISPLAY_TYPE == DISPLAY_TYPE_NONE) || (DISPLAY_TYPE == DISPLAY_TYPE_LCD_JOY_I2C_SSD1306))
   // Valid display for ESP32
+#elif defined(OAT_HOST_BUILD) && (DISPLAY_TYPE == DISPLAY_TYPE_NONE)
+  // Valid display for host build
 #elif defined(__AVR_ATmega2560__) && ((DISPLAY_TYPE == DISPLAY_TYPE_NONE) || (DISPLAY_TYPE == DISPLAY_TYPE_LCD_KEYPAD) \
   || (DISPLAY_TYPE_LCD_KEYPAD_I2C_MCP23008) || (DISPLAY_TYPE_LCD_KEYPAD_I2C_MCP23017))
   // Valid display for ATmega
@@ -306,6 +321,14 @@
   #error Unsupported DEC stepper & driver combination. Use at own risk.
 #endif
 
+#if (RA_HARDWARE_TRACKING == 0)
+  // Baseline configuration steps TRK in the stepper interrupt
+#elif (RA_STEPPER_TYPE == STEPPER_TYPE_NEMA17) && (defined(__AVR_ATmega2560__) || defined(OAT_HOST_BUILD))
+  // Hardware tracking needs a STEP/DIR driver and one of the 16-bit timers of the ATmega2560
+#else
+  #error Unsupported RA hardware tracking configuration (STEP/DIR driver on ATmega2560 only). Use at own risk.
+#endif
+
 #if (RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART)
   #ifndef RA_DRIVER_ADDRESS
     // Serial bus address must be specified for TMC2209 in UART mode
@@ -379,6 +402,32 @@
   #error Configuration does not support AZ/ALT. Use at own risk.
 #endif 
 
+// Microstepping
+#if (RA_TRACKING_MICROSTEPPING % RA_SLEW_MICROSTEPPING) != 0
+  // The tracking speed is scaled by RA_TRACKING_MICROSTEPPING / RA_SLEW_MICROSTEPPING in integers
+  #error RA_TRACKING_MICROSTEPPING must be a multiple of RA_SLEW_MICROSTEPPING.
+#endif
+#if (DEC_GUIDE_MICROSTEPPING % DEC_SLEW_MICROSTEPPING) != 0
+  #error DEC_GUIDE_MICROSTEPPING must be a multiple of DEC_SLEW_MICROSTEPPING.
+#endif
+
+// Slew speeds. The stepper interrupt makes at most STEPPER_MAX_STEP_RATE steps per second on a motor,
+// so a faster speed only slews at that rate. Tracking and guiding rates are checked in StepRates.hpp.
+#if (STEPPER_MAX_STEP_RATE > 0)
+  #if (RA_STEPPER_SPEED > STEPPER_MAX_STEP_RATE)
+    #warning RA_STEPPER_SPEED is faster than the stepper interrupt can step, RA slews at STEPPER_MAX_STEP_RATE. Set it to STEPPER_MAX_STEP_RATE or lower.
+  #endif
+  #if (DEC_STEPPER_SPEED > STEPPER_MAX_STEP_RATE)
+    #warning DEC_STEPPER_SPEED is faster than the stepper interrupt can step, DEC slews at STEPPER_MAX_STEP_RATE. Set it to STEPPER_MAX_STEP_RATE or lower.
+  #endif
+  #if (AZIMUTH_ALTITUDE_MOTORS == 1) && (AZ_STEPPER_SPEED > STEPPER_MAX_STEP_RATE)
+    #warning AZ_STEPPER_SPEED is faster than the stepper interrupt can step, AZ moves at STEPPER_MAX_STEP_RATE. Set it to STEPPER_MAX_STEP_RATE or lower.
+  #endif
+  #if (AZIMUTH_ALTITUDE_MOTORS == 1) && (ALT_STEPPER_SPEED > STEPPER_MAX_STEP_RATE)
+    #warning ALT_STEPPER_SPEED is faster than the stepper interrupt can step, ALT moves at STEPPER_MAX_STEP_RATE. Set it to STEPPER_MAX_STEP_RATE or lower.
+  #endif
+#endif
+
 // Interfaces
 #if (BLUETOOTH_ENABLED == 0)
   // Baseline configuration without Bluetooth is valid
@@ -433,6 +482,18 @@
   #error Unsupported gyro configuration. Use at own risk.
 #endif
 
+#if (USE_GUIDE_PORT == 0)
+  // Baseline configuration without guide port is valid
+#elif defined(__AVR_ATmega2560__) && ((RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART))
+  #error Unsupported guide port configuration (SoftwareSerial uses the pin change interrupts on ATmega). Use at own risk.
+#elif defined(__AVR_ATmega2560__) && (AZIMUTH_ALTITUDE_MOTORS == 1) && ((AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART))
+  #error Unsupported guide port configuration (SoftwareSerial uses the pin change interrupts on ATmega). Use at own risk.
+#elif defined(ESP32) || defined(__AVR_ATmega2560__) || defined(OAT_HOST_BUILD)
+  // Guide port is supported on ESP32 and ATmega, and on the pin model of the host build
+#else
+  #error Unsupported guide port configuration. Use at own risk.
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //                            ////////
 // VALIDATE PIN ASSIGNMENTS   ////////
@@ -484,6 +545,13 @@
   #endif
 #endif
 
+#if (RA_HARDWARE_TRACKING == 1)
+  #if (RA_STEP_PIN != 5) && (RA_STEP_PIN != 6) && (RA_STEP_PIN != 46)
+     // A timer can only toggle its own output compare pin
+     #error RA_HARDWARE_TRACKING needs RA_STEP_PIN on pin 5 (OC3A), 6 (OC4A) or 46 (OC5A)
+  #endif
+#endif
+
 #if (AZIMUTH_ALTITUDE_MOTORS == 1)
   #if (AZ_DRIVER_TYPE == DRIVER_TYPE_ULN2003)
     #if !defined(AZ_IN1_PIN) || !defined(AZ_IN2_PIN) || !defined(AZ_IN3_PIN) || !defined(AZ_IN4_PIN)
@@ -547,6 +615,14 @@
   #endif
 #endif
 
+// Guide port
+#if (USE_GUIDE_PORT == 1)
+  #if !defined(GUIDE_PORT_NORTH_PIN) || !defined(GUIDE_PORT_EAST_PIN) || !defined(GUIDE_PORT_SOUTH_PIN) || !defined(GUIDE_PORT_WEST_PIN)
+     // Required pin assignments missing
+     #error Missing pin assignments for configured ST-4 guide port
+  #endif
+#endif
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //                                ////////
 // VALIDATE CRITICAL PARAMETERS   ////////
@@ -24,7 +24,11 @@
 #elif RA_STEPPER_TYPE == STEPPER_TYPE_NEMA17
   #define RA_STEPPER_SPR            400   // 28BYJ-48 = 4096  |  NEMA 0.9° = 400  |  NEMA 1.8° = 200
   #ifndef RA_STEPPER_SPEED
-    #define RA_STEPPER_SPEED          1200  // You can change the speed and acceleration of the steppers here. Max. Speed = 3000. 
+    #if defined(ESP32)
+      #define RA_STEPPER_SPEED        1000  // The ESP32 makes at most 1000 steps per second (STEPPER_MAX_STEP_RATE)
+    #else
+      #define RA_STEPPER_SPEED        1200  // You can change the speed and acceleration of the steppers here. Max. Speed = 3000. 
+    #endif
   #endif
   #ifndef RA_STEPPER_ACCELERATION
     #define RA_STEPPER_ACCELERATION   6000
@@ -44,7 +48,11 @@
 #elif DEC_STEPPER_TYPE == STEPPER_TYPE_NEMA17
   #define DEC_STEPPER_SPR            400   // 28BYJ-48 = 4096  |  NEMA 0.9° = 400  |  NEMA 1.8° = 200
   #ifndef DEC_STEPPER_SPEED
-    #define DEC_STEPPER_SPEED          1300  // You can change the speed and acceleration of the steppers here. Max. Speed = 3000. 
+    #if defined(ESP32)
+      #define DEC_STEPPER_SPEED        1000  // The ESP32 makes at most 1000 steps per second (STEPPER_MAX_STEP_RATE)
+    #else
+      #define DEC_STEPPER_SPEED        1300  // You can change the speed and acceleration of the steppers here. Max. Speed = 3000. 
+    #endif
   #endif
   #ifndef DEC_STEPPER_ACCELERATION
     #define DEC_STEPPER_ACCELERATION   6000
@@ -62,9 +70,9 @@
 //
 // NOTE: The previous implmentation allowed dynamic switching between microstep rates for slew and tracking 
 // if the TMC2209 driver was used. This was intended to allow fine control when tracking & guiding.
-// Unfortunately it breaks most functionality that depends on AccelStepper::position(): essentially AccelStepper
+// Unfortunately it breaks most functionality that depends on the axis position: essentially the axis
 // counts steps, and is unaware of the microstep mode configured in TMC2209Stepper, which in turn affects angle moved per step.
-// Therefore dynamically changing microstep mode causes errors when deriving angle from AccelStepper::position(). 
+// Therefore dynamically changing microstep mode causes errors when deriving angle from the axis position. 
 // Even though the ULN2003 does not support microstepping, using different modes (full/half-step) between
 // tracking/guiding & slewing has the problem.
 // Consequently slewing, tracking, guiding now use the same microstep configuration regardless of mode.
@@ -108,7 +116,18 @@
   #define USE_AUTOHOME 0        // Autohome with TMC2209 stall detection:  ON = 1  |  OFF = 0   
   //                  ^^^ leave at 0 for now, doesnt work properly yet
   #define RA_AUDIO_FEEDBACK  0 // If one of these are set to 1, the respective driver will shut off the stealthchop mode, resulting in a audible whine
-  #define DEC_AUDIO_FEEDBACK 0 // of the stepper coils. Use this to verify that UART is working properly. 
+  #define DEC_AUDIO_FEEDBACK 0 // of the stepper coils. Use this to verify that UART is working properly.
+#endif
+
+// HARDWARE TRACKING (ATmega2560 with a STEP/DIR RA driver only)
+// Set this to 1 to have a 16-bit timer generate the RA steps while tracking and guiding, instead of
+// the stepper interrupt. The timer toggles the STEP pin by itself at the exact tracking rate, without
+// the jitter of the 500us interrupt, and the firmware only counts the steps.
+// This needs RA STEP on an output compare pin: 5 (OC3A, Timer3), 6 (OC4A, Timer4) or 46 (OC5A, Timer5).
+// None of the supported boards have it there, so define RA_STEP_PIN in your local configuration
+// and rewire the STEP input of the RA driver to that pin. Slews still step in software on the same pin.
+#ifndef RA_HARDWARE_TRACKING
+  #define RA_HARDWARE_TRACKING 0
 #endif
 
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -175,6 +194,37 @@
   #error New DEC Stepper type? Add it here...
 #endif
 
+// How long a dither (:XO commands) waits after its guide pulses before it reports that the mount settled, in ms
+#define DITHER_SETTLE_TIME 2000
+
+// The guide pulses a guider sends while the mount tracks are added up (:XT commands). With GUIDE_AUTO_CALIBRATION
+// the mount also corrects its speed calibration (and stores it) from how far the RA pulses moved it over every
+// GUIDE_CALIBRATION_INTERVAL seconds that had at least GUIDE_CALIBRATION_PULSES pulses, by at most GUIDE_CALIBRATION_MAX_STEP
+// at a time, so a guider that keeps pushing one way stops having to. :XTA turns it on or off.
+#ifndef GUIDE_AUTO_CALIBRATION
+  #define GUIDE_AUTO_CALIBRATION 0
+#endif
+#define GUIDE_CALIBRATION_INTERVAL  300
+#define GUIDE_CALIBRATION_PULSES    5
+#define GUIDE_CALIBRATION_MAX_STEP  0.001f
+
+// A line of the ST-4 guide port (USE_GUIDE_PORT) that stays active ends its guide pulse after this many ms
+#define GUIDE_PORT_MAX_PULSE 10000
+
+// The session log (:XR commands) records the stepper positions every SESSION_LOG_INTERVAL ms, the guide pulses, slews
+// and status changes in a RAM ring of SESSION_LOG_SIZE bytes (0 to leave it out). Samples that only show TRK moving at
+// the tracking rate are left out, so plain tracking takes about 6 bytes a minute, but each guide pulse takes 5 to 15
+// bytes. The 512 bytes of the Mega hold the last few minutes of a guided session, the ESP32 several hours.
+// Once it is full the oldest records make room. session_log.py downloads and decodes it.
+#ifndef SESSION_LOG_SIZE
+  #if defined(ESP32)
+    #define SESSION_LOG_SIZE 16384
+  #else
+    #define SESSION_LOG_SIZE 512
+  #endif
+#endif
+#define SESSION_LOG_INTERVAL 1000
+
 
 ////////////////////////////
 //
@@ -322,6 +372,38 @@
 // This is set to 1 for boards that do not support interrupt timers
 #define RUN_STEPPERS_IN_MAIN_LOOP 0
 
+// The stepper interrupt (ATmega2560) follows the fastest moving motor: every STEPPER_INTERRUPT_MIN_PERIOD us
+// while slewing, slowing down in steps of two to STEPPER_INTERRUPT_MAX_PERIOD us while only tracking or guiding,
+// and off while no motor moves. It always runs at least twice per step of the fastest motor.
+#define STEPPER_INTERRUPT_MIN_PERIOD 500   // 2 kHz, more interferes with serial communications
+#define STEPPER_INTERRUPT_MAX_PERIOD 4000
+
+// The most steps per second the stepper interrupt can make on one motor, which is one step each time it runs.
+// The build checks the configured slew, tracking and guiding rates against it (see StepRates.hpp).
+#if (RUN_STEPPERS_IN_MAIN_LOOP != 0)
+  #define STEPPER_MAX_STEP_RATE 0     // Depends on how busy the main loop is, not checked
+#elif defined(ESP32)
+  #define STEPPER_MAX_STEP_RATE 1000  // stepperControlTask() runs every ms
+#else
+  #define STEPPER_MAX_STEP_RATE (1000000L / STEPPER_INTERRUPT_MIN_PERIOD)
+#endif
+
+// FAST BOOT
+// Set this to 1 to start tracking as soon as the mount has read its configuration, instead of after a second
+// of splash screen and a second for the driver UARTs to boot. The "Start Tracking, n ms after power-on" log
+// line (DEBUG_ANY) shows when it does. The splash screen still stays up for its second, but without holding up
+// the boot. TMC2209 UART drivers are configured as soon as they answer (tracking waits for the RA and DEC
+// drivers, at most BOOT_DRIVER_TIMEOUT), and WiFi starts once the mount tracks. Until then keys, serial and
+// Bluetooth commands wait, as during the slow boot.
+#ifndef FAST_BOOT
+  #define FAST_BOOT 0
+#endif
+#define BOOT_SPLASH_TIME      1000  // ms the splash screen stays up
+#define BOOT_DRIVER_TIMEOUT   1000  // ms after power-on to wait for a TMC2209 UART driver to answer before configuring it anyway
+
+// The most targets a sequence (:XQ commands) can hold. Each takes 20 bytes of RAM.
+#define SEQUENCE_MAX_TARGETS 10
+
 // The port number to access OAT control over WiFi (ESP32 only)
 #define WIFI_PORT 4030
 
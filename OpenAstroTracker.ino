@@ -6,8 +6,6 @@
     1. Connect your Arduino, under tools choose the board you're using (e.g. Arduino Mega), set the right Port and set "Arduino ISP" as the Programmer.
     2. Hit upload (Ctrl-U)
 
-    You might need to download the "AccelStepper" library by Mike McCauley
-
     Authors: /u/intercipere
              /u/clutchplate
              /u/EorEquis
@@ -122,6 +122,20 @@
   #define ALT_IN4_PIN 52
 #endif
 
+// USE_GUIDE_PORT requires 4 digital inputs with pin change interrupts in Arduino pin numbering
+#ifndef GUIDE_PORT_WEST_PIN
+  #define GUIDE_PORT_WEST_PIN  62   // A8, ST-4 RA+
+#endif
+#ifndef GUIDE_PORT_NORTH_PIN
+  #define GUIDE_PORT_NORTH_PIN 63   // A9, ST-4 DEC+
+#endif
+#ifndef GUIDE_PORT_SOUTH_PIN
+  #define GUIDE_PORT_SOUTH_PIN 64   // A10, ST-4 DEC-
+#endif
+#ifndef GUIDE_PORT_EAST_PIN
+  #define GUIDE_PORT_EAST_PIN  65   // A11, ST-4 RA-
+#endif
+
 //GPS pin configuration
 #ifndef GPS_SERIAL_PORT
   #define GPS_SERIAL_PORT Serial1
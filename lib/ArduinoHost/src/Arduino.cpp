@@ -0,0 +1,170 @@
+#include "Arduino.h"
+#include "EEPROM.h"
+
+HostSerial Serial;
+EEPROMClass EEPROM;
+
+namespace
+{
+unsigned long long nowMicros = 0;
+host::IdleHook idleHook = nullptr;
+int pins[256] = {0};
+void (*pinInterrupts[256])() = {nullptr};
+int pinInterruptModes[256] = {0};
+unsigned long randomState = 1;
+} // namespace
+
+namespace host
+{
+void setMicros(unsigned long long now) { nowMicros = now; }
+void advanceMicros(unsigned long long delta) { nowMicros += delta; }
+unsigned long long currentMicros() { return nowMicros; }
+void setIdleHook(IdleHook hook) { idleHook = hook; }
+int pinState(uint8_t pin) { return pins[pin]; }
+void setPinState(uint8_t pin, int value)
+{
+  int before = pins[pin];
+  pins[pin] = value;
+  int mode = pinInterruptModes[pin];
+  if ((pinInterrupts[pin] != nullptr) && (value != before)
+      && ((mode == CHANGE) || ((mode == RISING) && (value == HIGH)) || ((mode == FALLING) && (value == LOW))))
+  {
+    pinInterrupts[pin]();
+  }
+}
+} // namespace host
+
+unsigned long millis() { return (unsigned long)(nowMicros / 1000ULL); }
+unsigned long micros() { return (unsigned long)nowMicros; }
+
+// Sleeping advances virtual time in small slices so that the idle hook (usually
+// the stepper interrupt) keeps running at roughly its real-world rate.
+void delayMicroseconds(unsigned int us)
+{
+  unsigned long long end = nowMicros + us;
+  while (nowMicros < end)
+  {
+    unsigned long long slice = end - nowMicros;
+    nowMicros += slice > 500 ? 500 : slice;
+    if (idleHook)
+    {
+      idleHook(nowMicros);
+    }
+  }
+}
+
+void delay(unsigned long ms)
+{
+  while (ms--)
+  {
+    delayMicroseconds(1000);
+  }
+}
+
+void yield()
+{
+  // A blocking wait loop that only yields would never see time pass otherwise.
+  delayMicroseconds(50);
+}
+
+void pinMode(uint8_t pin, uint8_t mode)
+{
+  if (mode == INPUT_PULLUP)
+  {
+    pins[pin] = HIGH;
+  }
+}
+void digitalWrite(uint8_t pin, uint8_t value) { pins[pin] = value; }
+int digitalRead(uint8_t pin) { return pins[pin]; }
+int analogRead(uint8_t pin) { return pins[pin]; }
+void analogWrite(uint8_t pin, int value) { pins[pin] = value; }
+void noInterrupts() {}
+void interrupts() {}
+
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode)
+{
+  pinInterrupts[interruptNum] = isr;
+  pinInterruptModes[interruptNum] = mode;
+}
+
+void detachInterrupt(uint8_t interruptNum) { pinInterrupts[interruptNum] = nullptr; }
+
+char *dtostrf(double val, signed char width, unsigned char prec, char *sout)
+{
+  sprintf(sout, "%*.*f", width, prec, val);
+  return sout;
+}
+
+// The same sequence on every run, like an Arduino that was never seeded
+void randomSeed(unsigned long seed)
+{
+  if (seed != 0)
+  {
+    randomState = seed;
+  }
+}
+
+long random(long howBig)
+{
+  if (howBig <= 0)
+  {
+    return 0;
+  }
+  randomState = randomState * 1103515245UL + 12345UL;
+  return (long)((randomState >> 16) % (unsigned long)howBig);
+}
+
+long random(long howSmall, long howBig)
+{
+  if (howSmall >= howBig)
+  {
+    return howSmall;
+  }
+  return howSmall + random(howBig - howSmall);
+}
+
+size_t Stream::readBytes(char *buffer, size_t length)
+{
+  size_t count = 0;
+  while (count < length && available() > 0)
+  {
+    buffer[count++] = (char)read();
+  }
+  return count;
+}
+
+String Stream::readStringUntil(char terminator)
+{
+  String result;
+  while (available() > 0)
+  {
+    int c = read();
+    if (c == terminator)
+    {
+      break;
+    }
+    result += (char)c;
+  }
+  return result;
+}
+
+int HostSerial::read()
+{
+  if (_rx.empty())
+  {
+    return -1;
+  }
+  char c = _rx.front();
+  _rx.pop_front();
+  return (unsigned char)c;
+}
+
+size_t HostSerial::write(uint8_t c)
+{
+  _tx += (char)c;
+  if (_baud != 0)
+  {
+    delayMicroseconds((unsigned int)(10000000UL / _baud));
+  }
+  return 1;
+}
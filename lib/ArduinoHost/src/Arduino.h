@@ -0,0 +1,159 @@
+#pragma once
+
+// Minimal Arduino core for building the firmware logic on the host (env:native).
+// Time is virtual: it only advances when the test calls host::advanceMicros() or
+// when the firmware calls delay()/delayMicroseconds().
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <cmath>
+#include <string>
+#include <deque>
+#include <type_traits>
+#include "WString.h"
+#include "binary.h"
+
+#ifndef ARDUINO
+#define ARDUINO 10813
+#endif
+#define HIGH 0x1
+#define LOW 0x0
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const unsigned char *)(addr))
+#define pgm_read_word(addr) (*(const unsigned short *)(addr))
+#define pgm_read_dword(addr) (*(const unsigned long *)(addr))
+#define pgm_read_float(addr) (*(const float *)(addr))
+#define memcpy_P memcpy
+#define DEC 10
+#define HEX 16
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+using std::abs;
+
+// Returned by value: for arguments of the same type the conditional is an lvalue of a parameter.
+template <typename T, typename U> auto min(T a, U b) -> typename std::decay<decltype(a < b ? a : b)>::type { return (a < b) ? a : b; }
+template <typename T, typename U> auto max(T a, U b) -> typename std::decay<decltype(a > b ? a : b)>::type { return (a > b) ? a : b; }
+template <typename T, typename L, typename H> T constrain(T x, L lo, H hi) { return x < lo ? lo : (x > hi ? hi : x); }
+
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+void yield();
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t value);
+int digitalRead(uint8_t pin);
+int analogRead(uint8_t pin);
+void analogWrite(uint8_t pin, int value);
+void noInterrupts();
+void interrupts();
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t interruptNum, void (*isr)(), int mode);
+void detachInterrupt(uint8_t interruptNum);
+char *dtostrf(double val, signed char width, unsigned char prec, char *sout);
+void randomSeed(unsigned long seed);
+long random(long howBig);
+long random(long howSmall, long howBig);
+
+class Print
+{
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t *buffer, size_t size)
+  {
+    size_t n = 0;
+    while (size--)
+    {
+      n += write(*buffer++);
+    }
+    return n;
+  }
+  size_t write(const char *str) { return write((const uint8_t *)str, strlen(str)); }
+
+  size_t print(const String &s) { return write((const uint8_t *)s.c_str(), s.length()); }
+  size_t print(const char *s) { return write(s); }
+  size_t print(const __FlashStringHelper *s) { return print(reinterpret_cast<const char *>(s)); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(int n, int base = DEC) { return print(String(n, (unsigned char)base)); }
+  size_t print(unsigned int n, int base = DEC) { return print(String(n, (unsigned char)base)); }
+  size_t print(long n, int base = DEC) { return print(String(n, (unsigned char)base)); }
+  size_t print(unsigned long n, int base = DEC) { return print(String(n, (unsigned char)base)); }
+  size_t print(double n, int digits = 2) { return print(String(n, (unsigned char)digits)); }
+  template <typename T> size_t println(const T &value) { size_t n = print(value); return n + print("\r\n"); }
+  size_t println() { return print("\r\n"); }
+};
+
+class Stream : public Print
+{
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  void setTimeout(unsigned long timeout) { _timeout = timeout; }
+  size_t readBytes(char *buffer, size_t length);
+  String readStringUntil(char terminator);
+
+protected:
+  unsigned long _timeout = 1000;
+};
+
+// An in-memory serial port. Tests push bytes into the receive queue and inspect
+// what the firmware wrote back.
+class HostSerial : public Stream
+{
+public:
+  // When set, every byte written takes its transmission time at this rate (8N1).
+  void setTransmitRate(unsigned long baud) { _baud = baud; }
+  void begin(unsigned long) {}
+  void end() {}
+  operator bool() const { return true; }
+  int available() override { return (int)_rx.size(); }
+  int read() override;
+  int peek() override { return _rx.empty() ? -1 : (unsigned char)_rx.front(); }
+  size_t write(uint8_t c) override;
+  void flush() {}
+  using Print::write;
+
+  void inject(const char *bytes) { inject(bytes, strlen(bytes)); }
+  void inject(const char *bytes, size_t length) { _rx.insert(_rx.end(), bytes, bytes + length); }
+  std::string takeOutput() { std::string out; out.swap(_tx); return out; }
+  const std::string &output() const { return _tx; }
+
+private:
+  std::deque<char> _rx;
+  std::string _tx;
+  unsigned long _baud = 0;
+};
+
+extern HostSerial Serial;
+
+namespace host
+{
+// Virtual time control for tests
+void setMicros(unsigned long long now);
+void advanceMicros(unsigned long long delta);
+unsigned long long currentMicros();
+
+// Called whenever firmware code sleeps or yields, so a test can run the stepper
+// interrupt while the main loop is blocked, just like the timer ISR would on hardware.
+typedef void (*IdleHook)(unsigned long long nowMicros);
+void setIdleHook(IdleHook hook);
+
+// The pins, as an outside circuit sees them. An input with a pull-up reads HIGH until a test drives it,
+// and driving a pin runs the interrupt attached to it, like a GPIO interrupt would.
+int pinState(uint8_t pin);
+void setPinState(uint8_t pin, int value);
+} // namespace host
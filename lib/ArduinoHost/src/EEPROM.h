@@ -0,0 +1,20 @@
+#pragma once
+
+#include <stdint.h>
+
+// In-memory EEPROM with the union of the AVR and ESP32 APIs.
+class EEPROMClass
+{
+public:
+  void begin(int size) { (void)size; }
+  bool commit() { return true; }
+  uint8_t read(int address) { return _data[address & 0xFFF]; }
+  void write(int address, uint8_t value) { _data[address & 0xFFF] = value; }
+  void update(int address, uint8_t value) { write(address, value); }
+  void clear() { for (int i = 0; i < 4096; i++) _data[i] = 0xFF; }
+
+private:
+  uint8_t _data[4096] = {0};
+};
+
+extern EEPROMClass EEPROM;
@@ -0,0 +1,194 @@
+#include <ctype.h>
+#include <stdio.h>
+#include "WString.h"
+
+String::String(long value, unsigned char base)
+{
+  if (base == 10)
+  {
+    _str = std::to_string(value);
+  }
+  else
+  {
+    char buf[40];
+    bool negative = value < 0;
+    unsigned long mag = negative ? (unsigned long)(-value) : (unsigned long)value;
+    *this = String(mag, base);
+    if (negative)
+    {
+      _str.insert(0, 1, '-');
+    }
+    (void)buf;
+  }
+}
+
+String::String(unsigned long value, unsigned char base)
+{
+  if (base < 2 || base > 16)
+  {
+    base = 10;
+  }
+  char buf[40];
+  char *p = buf + sizeof(buf) - 1;
+  *p = '\0';
+  do
+  {
+    *--p = "0123456789ABCDEF"[value % base];
+    value /= base;
+  } while (value);
+  _str = p;
+}
+
+String::String(double value, unsigned char decimalPlaces)
+{
+  char buf[64];
+  snprintf(buf, sizeof(buf), "%.*f", decimalPlaces, value);
+  _str = buf;
+}
+
+char &String::operator[](unsigned int index)
+{
+  if (index < _str.length())
+  {
+    return _str[index];
+  }
+  _dummy = 0;
+  return _dummy;
+}
+
+bool String::equalsIgnoreCase(const String &rhs) const
+{
+  if (_str.length() != rhs._str.length())
+  {
+    return false;
+  }
+  for (size_t i = 0; i < _str.length(); i++)
+  {
+    if (tolower((unsigned char)_str[i]) != tolower((unsigned char)rhs._str[i]))
+    {
+      return false;
+    }
+  }
+  return true;
+}
+
+bool String::endsWith(const String &suffix) const
+{
+  if (suffix._str.length() > _str.length())
+  {
+    return false;
+  }
+  return _str.compare(_str.length() - suffix._str.length(), suffix._str.length(), suffix._str) == 0;
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const
+{
+  size_t pos = _str.find(c, fromIndex);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String &s, unsigned int fromIndex) const
+{
+  size_t pos = _str.find(s._str, fromIndex);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::lastIndexOf(char c) const
+{
+  size_t pos = _str.rfind(c);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex) const
+{
+  return substring(beginIndex, length());
+}
+
+// Like Arduino, the indices are swapped if reversed and clipped to the string.
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const
+{
+  if (beginIndex > endIndex)
+  {
+    unsigned int temp = endIndex;
+    endIndex = beginIndex;
+    beginIndex = temp;
+  }
+  if (beginIndex >= _str.length())
+  {
+    return String();
+  }
+  if (endIndex > _str.length())
+  {
+    endIndex = _str.length();
+  }
+  String result;
+  result._str = _str.substr(beginIndex, endIndex - beginIndex);
+  return result;
+}
+
+void String::replace(const String &find, const String &replace)
+{
+  if (find._str.empty())
+  {
+    return;
+  }
+  size_t pos = 0;
+  while ((pos = _str.find(find._str, pos)) != std::string::npos)
+  {
+    _str.replace(pos, find._str.length(), replace._str);
+    pos += replace._str.length();
+  }
+}
+
+void String::toLowerCase()
+{
+  for (char &c : _str)
+  {
+    c = (char)tolower((unsigned char)c);
+  }
+}
+
+void String::toUpperCase()
+{
+  for (char &c : _str)
+  {
+    c = (char)toupper((unsigned char)c);
+  }
+}
+
+void String::trim()
+{
+  size_t first = _str.find_first_not_of(" \t\r\n");
+  if (first == std::string::npos)
+  {
+    _str.clear();
+    return;
+  }
+  size_t last = _str.find_last_not_of(" \t\r\n");
+  _str = _str.substr(first, last - first + 1);
+}
+
+void String::getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index) const
+{
+  if (!bufsize || !buf)
+  {
+    return;
+  }
+  unsigned int n = 0;
+  for (unsigned int i = index; i < _str.length() && n < bufsize - 1; i++)
+  {
+    buf[n++] = (unsigned char)_str[i];
+  }
+  buf[n] = 0;
+}
+
+String operator+(const String &lhs, const String &rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const String &lhs, const char *rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const char *lhs, const String &rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const String &lhs, char rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const String &lhs, int rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const String &lhs, long rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const String &lhs, unsigned int rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const String &lhs, unsigned long rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const String &lhs, float rhs) { String r(lhs); r += rhs; return r; }
+String operator+(const String &lhs, double rhs) { String r(lhs); r += rhs; return r; }
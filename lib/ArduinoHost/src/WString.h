@@ -0,0 +1,99 @@
+#pragma once
+
+// Host replacement for the Arduino String class, backed by std::string.
+// Only the parts of the API that the firmware uses are provided.
+
+#include <string>
+#include <stdlib.h>
+#include <string.h>
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper *>(string_literal))
+
+class String
+{
+public:
+  String(const char *cstr = "") : _str(cstr ? cstr : "") {}
+  String(const __FlashStringHelper *fstr) : _str(reinterpret_cast<const char *>(fstr)) {}
+  String(const String &) = default;
+  String(String &&) = default;
+  explicit String(char c) : _str(1, c) {}
+  explicit String(unsigned char value, unsigned char base = 10) : String((unsigned long)value, base) {}
+  explicit String(int value, unsigned char base = 10) : String((long)value, base) {}
+  explicit String(unsigned int value, unsigned char base = 10) : String((unsigned long)value, base) {}
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(float value, unsigned char decimalPlaces = 2) : String((double)value, decimalPlaces) {}
+  explicit String(double value, unsigned char decimalPlaces = 2);
+
+  String &operator=(const String &) = default;
+  String &operator=(String &&) = default;
+  String &operator=(const char *cstr) { _str = cstr ? cstr : ""; return *this; }
+
+  unsigned int length() const { return (unsigned int)_str.length(); }
+  const char *c_str() const { return _str.c_str(); }
+  char *begin() { return &_str[0]; }
+  bool reserve(unsigned int size) { _str.reserve(size); return true; }
+
+  char operator[](unsigned int index) const { return index < _str.length() ? _str[index] : '\0'; }
+  char &operator[](unsigned int index);
+  char charAt(unsigned int index) const { return (*this)[index]; }
+  void setCharAt(unsigned int index, char c) { if (index < _str.length()) _str[index] = c; }
+
+  String &operator+=(const String &rhs) { _str += rhs._str; return *this; }
+  String &operator+=(const char *cstr) { _str += cstr; return *this; }
+  String &operator+=(char c) { _str += c; return *this; }
+  String &operator+=(int value) { return *this += String(value); }
+  String &operator+=(unsigned int value) { return *this += String(value); }
+  String &operator+=(long value) { return *this += String(value); }
+  String &operator+=(unsigned long value) { return *this += String(value); }
+  String &operator+=(float value) { return *this += String(value); }
+  String &operator+=(double value) { return *this += String(value); }
+  bool concat(const String &rhs) { _str += rhs._str; return true; }
+  bool concat(char c) { _str += c; return true; }
+
+  bool operator==(const String &rhs) const { return _str == rhs._str; }
+  bool operator==(const char *cstr) const { return _str == (cstr ? cstr : ""); }
+  bool operator!=(const String &rhs) const { return !(*this == rhs); }
+  bool operator!=(const char *cstr) const { return !(*this == cstr); }
+  bool operator<(const String &rhs) const { return _str < rhs._str; }
+  bool equals(const String &rhs) const { return *this == rhs; }
+  bool equalsIgnoreCase(const String &rhs) const;
+  bool startsWith(const String &prefix) const { return _str.compare(0, prefix._str.length(), prefix._str) == 0; }
+  bool endsWith(const String &suffix) const;
+
+  int indexOf(char c, unsigned int fromIndex = 0) const;
+  int indexOf(const String &s, unsigned int fromIndex = 0) const;
+  int lastIndexOf(char c) const;
+  String substring(unsigned int beginIndex) const;
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+  void remove(unsigned int index) { if (index < _str.length()) _str.erase(index); }
+  void remove(unsigned int index, unsigned int count) { if (index < _str.length()) _str.erase(index, count); }
+  void replace(const String &find, const String &replace);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const { return atol(_str.c_str()); }
+  float toFloat() const { return (float)atof(_str.c_str()); }
+  void getBytes(unsigned char *buf, unsigned int bufsize, unsigned int index = 0) const;
+  void toCharArray(char *buf, unsigned int bufsize, unsigned int index = 0) const { getBytes((unsigned char *)buf, bufsize, index); }
+
+  const std::string &str() const { return _str; }
+
+private:
+  std::string _str;
+  char _dummy = 0;
+};
+
+String operator+(const String &lhs, const String &rhs);
+String operator+(const String &lhs, const char *rhs);
+String operator+(const char *lhs, const String &rhs);
+String operator+(const String &lhs, char rhs);
+String operator+(const String &lhs, int rhs);
+String operator+(const String &lhs, long rhs);
+String operator+(const String &lhs, unsigned int rhs);
+String operator+(const String &lhs, unsigned long rhs);
+String operator+(const String &lhs, float rhs);
+String operator+(const String &lhs, double rhs);
@@ -0,0 +1,196 @@
+import argparse
+import csv
+import sys
+
+# Downloads the session log of the mount (see :XRI and :XRG in MeadeCommandProcessor.cpp) and
+# decodes it (the record format is described in src/SessionLog.hpp).
+#
+#   python session_log.py download COM3 session.log
+#   python session_log.py csv session.log session.csv
+#   python session_log.py plot session.log
+
+TICK_SECONDS = 0.01
+DITHER = 0x80
+PREDICT_TICKS = 6000
+
+directions = {
+    0x01: "N",
+    0x02: "E",
+    0x04: "S",
+    0x08: "W",
+}
+
+# The mount status bits that are logged (guide pulses have their own records)
+status_bits = {
+    0x0002: "slewing",
+    0x0004: "to target",
+    0x0008: "tracking",
+    0x0010: "parking",
+    0x0100: "manual",
+    0x1000: "to park position",
+    0x2000: "finding home",
+}
+
+
+def status_name(status):
+    names = [name for bit, name in status_bits.items() if status & bit]
+    return "+".join(names) if names else "parked"
+
+
+def command(port, cmd):
+    port.write(cmd.encode("ascii"))
+    reply = port.read_until(b"#").decode("ascii")
+    if not reply.endswith("#"):
+        raise IOError(f"No reply to {cmd}")
+    return reply[:-1]
+
+
+def download(args):
+    import serial  # pyserial, only needed here
+
+    with serial.Serial(args.port, args.baud, timeout=2) as port:
+        # Paused, so nothing is dropped while it downloads
+        command(port, ":XRS0#")
+        try:
+            info = command(port, ":XRI#")
+            end = int(info.split(",")[2])
+            offset = int(info.split(",")[1])
+            data = ""
+            while offset < end:
+                reply_offset, chunk = command(port, f":XRG{offset}#").split(",")
+                if int(reply_offset) != offset or not chunk:
+                    raise IOError(f"Expected bytes from {offset}, got {reply_offset}")
+                data += chunk
+                offset += len(chunk) // 2
+                print(f"\r{offset}/{end} bytes", end="")
+            print()
+        finally:
+            command(port, ":XRS1#")
+
+    with open(args.file, "w") as f:
+        f.write(info + "\n")
+        f.write(data + "\n")
+
+
+def read_values(data, i, count):
+    values = []
+    for _ in range(count):
+        value = 0
+        shift = 0
+        while True:
+            b = data[i]
+            i += 1
+            value |= (b & 0x7F) << shift
+            shift += 7
+            if not b & 0x80:
+                break
+        values.append(value)
+    return values, i
+
+
+def signed(value):
+    return (value >> 1) ^ -(value & 1)
+
+
+def predicted_steps(rate, ticks):
+    """The TRK steps the tracking rate moves in the given ticks (see src/SessionLog.hpp)."""
+    return (rate * min(ticks, PREDICT_TICKS) + 50000) // 100000
+
+
+def decode(file):
+    """Yields (seconds, type, ra, dec, trk, status, detail) for each record, the positions and status after it."""
+    with open(file) as f:
+        info = f.readline().strip().split(",")
+        data = bytes.fromhex(f.readline().strip())
+
+    tick, ra, dec, trk, status, rate, rate_tick = [int(v) for v in info[3:10]]
+    start_tick = tick
+    yield 0.0, "start", ra, dec, trk + predicted_steps(rate, tick - rate_tick), status, ""
+
+    i = 0
+    while i < len(data):
+        record = chr(data[i])
+        (ticks,), i = read_values(data, i + 1, 1)
+        tick += ticks
+        if record in ("S", "R"):
+            trk += predicted_steps(rate, tick - rate_tick)
+            rate_tick = tick
+        if record == "S":
+            values, i = read_values(data, i, 3)
+            ra += signed(values[0])
+            dec += signed(values[1])
+            trk += signed(values[2])
+            detail = ""
+        elif record == "R":
+            (rate,), i = read_values(data, i, 1)
+            detail = f"{rate / 1000:.3f} steps/s"
+        elif record == "G":
+            (direction, ms), i = read_values(data, i, 2)
+            detail = ("dither " if direction & DITHER else "") + f"{directions[direction & ~DITHER]} {ms}ms"
+        elif record == "M":
+            values, i = read_values(data, i, 2)
+            detail = f"to {signed(values[0])},{signed(values[1])}"
+        elif record == "T":
+            (status,), i = read_values(data, i, 1)
+            detail = status_name(status)
+        else:
+            raise ValueError(f"Unknown record type {record!r} at byte {i - 1}")
+        yield (tick - start_tick) * TICK_SECONDS, record, ra, dec, trk + predicted_steps(rate, tick - rate_tick), status, detail
+
+
+def to_csv(args):
+    with open(args.output, "w", newline="") if args.output else sys.stdout as f:
+        writer = csv.writer(f)
+        writer.writerow(["seconds", "record", "ra", "dec", "trk", "status", "detail"])
+        for seconds, record, ra, dec, trk, status, detail in decode(args.file):
+            writer.writerow([f"{seconds:.2f}", record, ra, dec, trk, status, detail])
+
+
+def plot(args):
+    import matplotlib.pyplot as plt  # Only needed here
+
+    records = list(decode(args.file))
+    samples = [r for r in records if r[1] in ("start", "S", "R")]
+    seconds = [r[0] for r in samples]
+
+    figure, axes = plt.subplots(3, 1, sharex=True)
+    for axis, column, name in zip(axes, (2, 3, 4), ("RA", "DEC", "TRK")):
+        axis.plot(seconds, [r[column] for r in samples])
+        axis.set_ylabel(f"{name} steps")
+    for seconds, record, ra, dec, trk, status, detail in records:
+        if record == "G":
+            # The direction is the letter before the duration
+            axis = axes[0] if detail.split()[-2] in ("E", "W") else axes[1]
+            axis.axvline(seconds, color="orange", linewidth=0.5)
+        elif record in ("M", "T"):
+            for axis in axes:
+                axis.axvline(seconds, color="red" if record == "M" else "grey", linewidth=0.5)
+    axes[-1].set_xlabel("seconds")
+    plt.show()
+
+
+def main():
+    parser = argparse.ArgumentParser(description="Download and decode the session log of the mount")
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    parser_download = commands.add_parser("download", help="Download the log over serial")
+    parser_download.add_argument("port")
+    parser_download.add_argument("file")
+    parser_download.add_argument("--baud", type=int, default=57600)
+    parser_download.set_defaults(run=download)
+
+    parser_csv = commands.add_parser("csv", help="Decode a downloaded log to CSV")
+    parser_csv.add_argument("file")
+    parser_csv.add_argument("output", nargs="?")
+    parser_csv.set_defaults(run=to_csv)
+
+    parser_plot = commands.add_parser("plot", help="Plot the stepper positions of a downloaded log")
+    parser_plot.add_argument("file")
+    parser_plot.set_defaults(run=plot)
+
+    args = parser.parse_args()
+    args.run(args)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,585 @@
+#pragma once
+
+#include "inc/Globals.hpp"
+#include "TrackingTimer.hpp"
+
+#if (RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || \
+  (AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART)
+  #include <TMCStepper.h>   // If you get an error here, download the TMCstepper library from "Tools > Manage Libraries"
+#endif
+
+//////////////////////////////////////////////////////////////////
+//
+// Stepper policies: how a step reaches the pins of a motor.
+//
+//////////////////////////////////////////////////////////////////
+
+// A unipolar motor (28BYJ-48) on a ULN2003, its four coils driven directly.
+// HALF_STEP selects the 8 phase sequence, otherwise 4 full step phases are used.
+template <bool HALF_STEP>
+class FourWireStepper {
+public:
+  FourWireStepper(byte pin1, byte pin2, byte pin3, byte pin4) : _pins{ pin1, pin2, pin3, pin4 } {
+    enableOutputs();
+  }
+
+  inline void step(long position, bool) {
+    if (HALF_STEP) {
+      static const byte phases[8] = { 0b0001, 0b0101, 0b0100, 0b0110, 0b0010, 0b1010, 0b1000, 0b1001 };
+      setOutputPins(phases[position & 0x7]);
+    }
+    else {
+      static const byte phases[4] = { 0b0101, 0b0110, 0b1010, 0b1001 };
+      setOutputPins(phases[position & 0x3]);
+    }
+  }
+
+  void setDirectionInverted(bool) {}  // Swap the pins instead
+
+  void enableOutputs() {
+    for (byte i = 0; i < 4; i++) {
+      pinMode(_pins[i], OUTPUT);
+    }
+  }
+
+  // De-energizes all coils
+  void disableOutputs() {
+    setOutputPins(0);
+  }
+
+private:
+  inline void setOutputPins(byte mask) {
+    for (byte i = 0; i < 4; i++) {
+      digitalWrite(_pins[i], (mask & (1 << i)) ? HIGH : LOW);
+    }
+  }
+
+  byte _pins[4];
+};
+
+// A driver with STEP and DIR inputs (A4988, TMC2209).
+class StepDirStepper {
+public:
+  StepDirStepper(byte stepPin, byte dirPin) : _stepPin(stepPin), _dirPin(dirPin), _directionInverted(false) {
+    enableOutputs();
+  }
+
+  inline void step(long, bool forward) {
+    // Direction first, else the driver can see a step in the old direction
+    setDirection(forward);
+    digitalWrite(_stepPin, HIGH);
+    delayMicroseconds(1);
+    digitalWrite(_stepPin, LOW);
+  }
+
+  inline void setDirection(bool forward) { digitalWrite(_dirPin, (forward != _directionInverted) ? HIGH : LOW); }
+  void setDirectionInverted(bool inverted) { _directionInverted = inverted; }
+
+  void enableOutputs() {
+    pinMode(_stepPin, OUTPUT);
+    pinMode(_dirPin, OUTPUT);
+  }
+
+  void disableOutputs() {
+    digitalWrite(_stepPin, LOW);
+    digitalWrite(_dirPin, _directionInverted ? HIGH : LOW);
+  }
+
+private:
+  byte _stepPin;
+  byte _dirPin;
+  bool _directionInverted;
+};
+
+//////////////////////////////////////////////////////////////////
+//
+// Driver policies: how a motor is powered up and down.
+//
+//////////////////////////////////////////////////////////////////
+
+// Motors without a driver enable, which are powered down by releasing their coils (ULN2003).
+class CoilDriver {
+public:
+  template <typename Stepper> void enable(Stepper& motor) { motor.enableOutputs(); }
+  template <typename Stepper> void disable(Stepper& motor) { motor.disableOutputs(); }
+};
+
+// Drivers with an active low ENABLE input on EN_PIN.
+template <int EN_PIN>
+class EnablePinDriver {
+public:
+  template <typename Stepper> void enable(Stepper&) { digitalWrite(EN_PIN, LOW); }
+  template <typename Stepper> void disable(Stepper&) { digitalWrite(EN_PIN, HIGH); }
+};
+
+#if (RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || \
+  (AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART)
+// TMC2209 drivers on a UART, with an active low ENABLE input on EN_PIN. The current and the
+// microsteps are set over the UART, once begin() connected to the driver.
+template <int EN_PIN>
+class Tmc2209UartDriver : public EnablePinDriver<EN_PIN> {
+public:
+  void begin(Stream* serial, float rsense, byte address, bool spreadCycle) {
+    _tmc = new TMC2209Stepper(serial, rsense, address);
+    _tmc->begin();
+    if (spreadCycle) {
+      _tmc->en_spreadCycle(1);
+    }
+    _tmc->blank_time(24);
+    _tmc->TCOOLTHRS(0xFFFFF);
+  }
+
+  void setCurrent(int rmsCurrent) { _tmc->rms_current(rmsCurrent); }
+
+  // 1 runs full steps
+  void setMicrosteps(int microsteps) { _tmc->microsteps(microsteps == 1 ? 0 : microsteps); }
+
+  // For the registers that only some axes set (chopper, StallGuard, hold current)
+  TMC2209Stepper* tmc() { return _tmc; }
+
+private:
+  TMC2209Stepper* _tmc = nullptr;
+};
+#endif
+
+//////////////////////////////////////////////////////////////////
+//
+// Travel policies: where an axis may go, and how it ends a move.
+//
+//////////////////////////////////////////////////////////////////
+
+// Goes anywhere, and stops where it was told to.
+class FreeTravel {
+public:
+  long withinLimits(long position) const { return position; }
+  int backlash() const { return 0; }
+
+protected:
+  bool backlashPending() const { return false; }
+  void setBacklashPending(bool) {}
+};
+
+// Stays between a lower and an upper limit in steps. A limit of 0 is no limit.
+class LimitedTravel : public FreeTravel {
+public:
+  void setLowerLimit(long position) { _lowerLimit = position; }
+  void setUpperLimit(long position) { _upperLimit = position; }
+  long lowerLimit() const { return _lowerLimit; }
+  long upperLimit() const { return _upperLimit; }
+
+  // The position closest to position that is within the limits
+  long withinLimits(long position) const {
+    if ((_upperLimit != 0) && (position > _upperLimit)) {
+      position = _upperLimit;
+    }
+    if ((_lowerLimit != 0) && (position < _lowerLimit)) {
+      position = _lowerLimit;
+    }
+    return position;
+  }
+
+private:
+  long _lowerLimit = 0;
+  long _upperLimit = 0;
+};
+
+// Geared axes that end moves made with moveToTakingUpBacklash() going forward, so
+// that the gears are already engaged in the direction the axis moves next.
+class BacklashTravel : public FreeTravel {
+public:
+  void setBacklash(int steps) { _backlash = steps; }
+  int backlash() const { return _backlash; }
+
+protected:
+  bool backlashPending() const { return _backlashPending; }
+  void setBacklashPending(bool pending) { _backlashPending = pending; }
+
+private:
+  int _backlash = 0;
+  bool _backlashPending = false;
+};
+
+//////////////////////////////////////////////////////////////////
+//
+// Axis
+//
+// One stepper motor, generating its steps and speed ramps the way AccelStepper
+// 1.61 does (same equations and rounding, so moves are step for step the same),
+// with the motor and driver handling chosen at compile time. Everything the
+// stepper interrupt calls is inline and non-virtual.
+//
+// The limits and the backlash correction come from TravelPolicy, the current
+// and microstep settings (TMC2209 over UART only) from DriverPolicy.
+//
+//////////////////////////////////////////////////////////////////
+template <typename StepperPolicy, typename DriverPolicy, typename TravelPolicy = FreeTravel>
+class Axis : public TravelPolicy {
+public:
+  typedef StepperPolicy Stepper;
+  typedef DriverPolicy Driver;
+
+  // Takes the pins of the motor, as StepperPolicy's constructor does
+  template <typename... Pins>
+  explicit Axis(Pins... pins) : _motor(pins...) {
+    setAcceleration(1);
+  }
+
+  // Runs at the current speed, towards nothing. Returns true when it stepped.
+  // The next step is timed from when this one was due, not from when the interrupt got to it,
+  // so the wait for the interrupt does not add up and the speed is exact at any interrupt period.
+  inline bool runSpeed() {
+    if (!_stepInterval) {
+      return false;
+    }
+    unsigned long time = micros();
+    unsigned long elapsed = time - _lastStepTime;
+    if (elapsed < _stepInterval) {
+      return false;
+    }
+    _lastStepTime = (elapsed - _stepInterval < _stepInterval) ? _lastStepTime + _stepInterval : time;
+    step();
+    return true;
+  }
+
+  // Runs towards the target, accelerating and decelerating. Returns true while still moving.
+  // Ramp steps are timed from the last step, as AccelStepper does.
+  inline bool run() {
+    if (_stepInterval) {
+      unsigned long time = micros();
+      if (time - _lastStepTime >= _stepInterval) {
+        _lastStepTime = time;
+        step();
+        computeNewSpeed();
+        if (!_stepInterval && TravelPolicy::backlashPending()) {
+          // Stopped past the target, come back up to it
+          TravelPolicy::setBacklashPending(false);
+          setTarget(_currentPos + TravelPolicy::backlash());
+        }
+      }
+    }
+    return (_speed != 0.0) || (distanceToGo() != 0);
+  }
+
+  void moveTo(long absolute) {
+    TravelPolicy::setBacklashPending(false);
+    setTarget(absolute);
+  }
+
+  void move(long relative) { moveTo(_currentPos + relative); }
+
+  // Moves to absolute and ends the move going forward. Moves backwards go backlash()
+  // steps past it, then run() comes back up to it (also after a stop()).
+  void moveToTakingUpBacklash(long absolute) {
+    bool overshoot = (TravelPolicy::backlash() != 0) && (absolute < _currentPos);
+    TravelPolicy::setBacklashPending(overshoot);
+    setTarget(overshoot ? absolute - TravelPolicy::backlash() : absolute);
+  }
+
+  // Sets a target that stops the motor as quickly as the acceleration allows
+  void stop() {
+    if (_speed != 0.0) {
+      long stepsToStop = (long)((_speed * _speed) / (2.0 * _acceleration)) + 1;
+      setTarget(_currentPos + ((_speed > 0) ? stepsToStop : -stepsToStop));
+    }
+  }
+
+  // Blocks until the target is reached
+  void runToPosition() {
+    while (run()) {
+      yield();
+    }
+  }
+
+  void runToNewPosition(long position) {
+    moveTo(position);
+    runToPosition();
+  }
+
+  void setMaxSpeed(float speed) {
+    if (speed < 0.0) {
+      speed = -speed;
+    }
+    if (_maxSpeed != speed) {
+      _maxSpeed = speed;
+      _cmin = 1000000.0 / speed;
+      // Keep accelerating or cruising from the current speed
+      if (_n > 0) {
+        _n = (long)((_speed * _speed) / (2.0 * _acceleration));
+        computeNewSpeed();
+      }
+    }
+  }
+
+  float maxSpeed() const { return _maxSpeed; }
+
+  void setAcceleration(float acceleration) {
+    if (acceleration == 0.0) {
+      return;
+    }
+    if (acceleration < 0.0) {
+      acceleration = -acceleration;
+    }
+    if (_acceleration != acceleration) {
+      _n = _n * (_acceleration / acceleration);
+      _c0 = 0.676 * sqrt(2.0 / acceleration) * 1000000.0;
+      _acceleration = acceleration;
+      computeNewSpeed();
+    }
+  }
+
+  // Sets the speed in steps/s for runSpeed(), limited to the maximum speed
+  void setSpeed(float speed) {
+    if (speed == _speed) {
+      return;
+    }
+    speed = constrain(speed, -_maxSpeed, _maxSpeed);
+    if (speed == 0.0) {
+      _stepInterval = 0;
+    }
+    else {
+      _stepInterval = fabs(1000000.0 / speed);
+      _forward = speed > 0.0;
+    }
+    _speed = speed;
+  }
+
+  float speed() const { return _speed; }
+  long distanceToGo() const { return _targetPos - _currentPos; }
+  long targetPosition() const { return _targetPos; }
+  long currentPosition() const { return _currentPos; }
+
+  // Redefines where the motor is, and stops it
+  void setCurrentPosition(long position) {
+    TravelPolicy::setBacklashPending(false);
+    _targetPos = _currentPos = position;
+    _n = 0;
+    _stepInterval = 0;
+    _speed = 0.0;
+  }
+
+  bool isRunning() const { return !((_speed == 0.0) && (_targetPos == _currentPos)); }
+
+  void setDirectionInverted(bool inverted) { _motor.setDirectionInverted(inverted); }
+  void enableOutputs() { _driver.enable(_motor); }
+  void disableOutputs() { _driver.disable(_motor); }
+
+  // Only for the drivers that have them (Tmc2209UartDriver)
+  void setCurrent(int rmsCurrent) { _driver.setCurrent(rmsCurrent); }
+  void setMicrosteps(int microsteps) { _driver.setMicrosteps(microsteps); }
+  Driver& driver() { return _driver; }
+
+protected:
+  Stepper& motor() { return _motor; }
+
+  // Accounts for steps the motor made without runSpeed()
+  void addSteps(long steps) { _currentPos += steps; }
+
+private:
+  void setTarget(long absolute) {
+    if (_targetPos != absolute) {
+      _targetPos = absolute;
+      computeNewSpeed();
+    }
+  }
+
+  inline void step() {
+    _currentPos += _forward ? 1 : -1;
+    _motor.step(_currentPos, _forward);
+  }
+
+  // Works out the interval to the next step (equations 13 to 17 of David Austin's
+  // "Generate stepper-motor speed profiles in real time")
+  void computeNewSpeed() {
+    long distanceTo = distanceToGo();
+    long stepsToStop = (long)((_speed * _speed) / (2.0 * _acceleration));
+
+    if ((distanceTo == 0) && (stepsToStop <= 1)) {
+      _stepInterval = 0;
+      _speed = 0.0;
+      _n = 0;
+      return;
+    }
+
+    if (distanceTo > 0) {
+      if (_n > 0) {
+        // Decelerate when we would overshoot, or are going the wrong way
+        if ((stepsToStop >= distanceTo) || !_forward) {
+          _n = -stepsToStop;
+        }
+      }
+      else if ((_n < 0) && (stepsToStop < distanceTo) && _forward) {
+        _n = -_n;
+      }
+    }
+    else if (distanceTo < 0) {
+      if (_n > 0) {
+        if ((stepsToStop >= -distanceTo) || _forward) {
+          _n = -stepsToStop;
+        }
+      }
+      else if ((_n < 0) && (stepsToStop < -distanceTo) && !_forward) {
+        _n = -_n;
+      }
+    }
+
+    if (_n == 0) {
+      _cn = _c0;
+      _forward = distanceTo > 0;
+    }
+    else {
+      _cn = _cn - ((2.0 * _cn) / ((4.0 * _n) + 1));
+      _cn = max(_cn, _cmin);
+    }
+    _n++;
+    _stepInterval = _cn;
+    _speed = _forward ? 1000000.0 / _cn : -1000000.0 / _cn;
+  }
+
+  StepperPolicy _motor;
+  DriverPolicy _driver;
+  long _currentPos = 0;
+  long _targetPos = 0;
+  float _speed = 0.0;         // steps/s, negative when moving backwards
+  float _maxSpeed = 1.0;
+  float _acceleration = 0.0;
+  unsigned long _stepInterval = 0;  // us, 0 when stopped
+  unsigned long _lastStepTime = 0;
+  bool _forward = false;
+  long _n = 0;                // Step number in the ramp, negative when decelerating
+  float _c0 = 0.0;            // First step interval, us
+  float _cn = 0.0;            // Last step interval, us
+  float _cmin = 1.0;          // At maximum speed, us
+};
+
+// The drivers of the step/dir RA and DEC motors
+#if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+  typedef Tmc2209UartDriver<RA_EN_PIN> RADriver;
+#else
+  typedef EnablePinDriver<RA_EN_PIN> RADriver;
+#endif
+#if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+  typedef Tmc2209UartDriver<DEC_EN_PIN> DECDriver;
+#else
+  typedef EnablePinDriver<DEC_EN_PIN> DECDriver;
+#endif
+
+//////////////////////////////////////////////////////////////////
+//
+// HardwareTrackingAxis
+//
+// The TRK axis with RA_HARDWARE_TRACKING. At a tracking or guiding speed the
+// steps come from TrackingTimer, started by the first runSpeed() call, and
+// the position adds up the steps it counted. Moves with run() (the catch up
+// after a slew) step in software as before, with the timer stopped.
+//
+//////////////////////////////////////////////////////////////////
+#if RA_HARDWARE_TRACKING == 1
+class HardwareTrackingAxis : public Axis<StepDirStepper, RADriver> {
+  typedef Axis<StepDirStepper, RADriver> Base;
+
+public:
+  HardwareTrackingAxis(byte stepPin, byte dirPin) : Base(stepPin, dirPin) {}
+
+  // Starts the timer when it is not running yet. Never steps by itself.
+  inline bool runSpeed() {
+    if (!TrackingTimer::isRunning() && (speed() != 0.0)) {
+      _timerForward = speed() > 0.0;
+      motor().setDirection(_timerForward);
+      TrackingTimer::start(fabs(speed()));
+    }
+    return false;
+  }
+
+  void setSpeed(float speed) {
+    bool wasForward = Base::speed() > 0.0;
+    Base::setSpeed(speed);
+    if (TrackingTimer::isRunning()) {
+      if ((Base::speed() == 0.0) || ((Base::speed() > 0.0) != wasForward)) {
+        stopTimer();  // The next runSpeed() starts it the other way
+      }
+      else {
+        TrackingTimer::setRate(fabs(Base::speed()));
+      }
+    }
+  }
+
+  long currentPosition() const {
+    long steps = TrackingTimer::steps();
+    return Base::currentPosition() + (_timerForward ? steps : -steps);
+  }
+
+  void stop() {
+    stopTimer();
+    Base::stop();
+  }
+
+  void runToNewPosition(long position) {
+    stopTimer();
+    Base::runToNewPosition(position);
+  }
+
+  void setCurrentPosition(long position) {
+    stopTimer();
+    Base::setCurrentPosition(position);
+  }
+
+private:
+  void stopTimer() {
+    // Leaves the interrupts as they were, as TrackingTimer's ATOMIC_BLOCK(ATOMIC_RESTORESTATE) does,
+    // since this also runs from code that has them off
+    #if defined(__AVR_ATmega2560__)
+      byte oldSREG = SREG;
+      cli();
+    #endif
+    if (TrackingTimer::isRunning()) {
+      long steps = TrackingTimer::stop();
+      addSteps(_timerForward ? steps : -steps);
+    }
+    #if defined(__AVR_ATmega2560__)
+      SREG = oldSREG;
+    #endif
+  }
+
+  bool _timerForward = true;
+};
+#endif
+
+//////////////////////////////////////////////////////////////////
+//
+// The axes of the configured mount
+//
+//////////////////////////////////////////////////////////////////
+#if RA_STEPPER_TYPE == STEPPER_TYPE_28BYJ48
+  typedef Axis<FourWireStepper<RA_SLEW_MICROSTEPPING != 1>, CoilDriver, BacklashTravel> RAAxis;
+  typedef Axis<FourWireStepper<RA_TRACKING_MICROSTEPPING != 1>, CoilDriver> TRKAxis;
+#else
+  typedef Axis<StepDirStepper, RADriver, BacklashTravel> RAAxis;
+  #if RA_HARDWARE_TRACKING == 1
+    typedef HardwareTrackingAxis TRKAxis;
+  #else
+    typedef Axis<StepDirStepper, RADriver> TRKAxis;   // Same motor as RA, whose driver is set up
+  #endif
+#endif
+
+#if DEC_STEPPER_TYPE == STEPPER_TYPE_28BYJ48
+  typedef Axis<FourWireStepper<DEC_SLEW_MICROSTEPPING != 1>, CoilDriver, LimitedTravel> DECAxis;
+#else
+  typedef Axis<StepDirStepper, DECDriver, LimitedTravel> DECAxis;
+#endif
+
+#if AZIMUTH_ALTITUDE_MOTORS == 1
+  #if AZ_DRIVER_TYPE == DRIVER_TYPE_ULN2003
+    typedef Axis<FourWireStepper<AZ_MICROSTEPPING != 1>, CoilDriver> AZAxis;
+  #elif AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+    typedef Axis<StepDirStepper, Tmc2209UartDriver<AZ_EN_PIN>> AZAxis;
+  #else
+    typedef Axis<StepDirStepper, EnablePinDriver<AZ_EN_PIN>> AZAxis;
+  #endif
+  #if ALT_DRIVER_TYPE == DRIVER_TYPE_ULN2003
+    typedef Axis<FourWireStepper<ALT_MICROSTEPPING != 1>, CoilDriver> ALTAxis;
+  #elif ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+    typedef Axis<StepDirStepper, Tmc2209UartDriver<ALT_EN_PIN>> ALTAxis;
+  #else
+    typedef Axis<StepDirStepper, EnablePinDriver<ALT_EN_PIN>> ALTAxis;
+  #endif
+#endif
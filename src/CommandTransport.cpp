@@ -0,0 +1,249 @@
+#include "../Configuration.hpp"
+#include "Utility.hpp"
+#include "Mount.hpp"
+#include "MeadeCommandProcessor.hpp"
+#include "CommandTransport.hpp"
+
+CommandTransport* CommandTransport::_first = nullptr;
+
+CommandTransport::CommandTransport(Stream* stream, Mount* mount, int debugFlags, const char* name)
+{
+  _stream = stream;
+  _mount = mount;
+  _debugFlags = debugFlags;
+  _name = name;
+  reset();
+
+  _next = _first;
+  _first = this;
+}
+
+CommandTransport::~CommandTransport()
+{
+  for (CommandTransport** link = &_first; *link != nullptr; link = &(*link)->_next)
+  {
+    if (*link == this)
+    {
+      *link = _next;
+      break;
+    }
+  }
+}
+
+void CommandTransport::reset()
+{
+  _queueLength = 0;
+  _frameStart = 0;
+  _queuedCommands = 0;
+  _inCommand = false;
+  _overflowed = false;
+  _stopAfter = 0;
+}
+
+/////////////////////////////////
+//
+// isPriorityCommand
+//
+// Stops and guide pulses must not wait for whatever else is queued up.
+// :Qq# is left out since it only leaves serial control mode.
+//
+/////////////////////////////////
+bool CommandTransport::isPriorityCommand(const char* command)
+{
+  if (command[1] == 'Q')
+  {
+    return command[2] != 'q';
+  }
+  return (command[1] == 'M') && ((command[2] == 'g') || (command[2] == 'G'));
+}
+
+/////////////////////////////////
+//
+// processInput
+//
+// Runs all queued commands in the order they were received. Before each one, all
+// transports are checked again, so a stop or guide command arriving meanwhile on
+// any of them still gets to run first.
+//
+/////////////////////////////////
+void CommandTransport::processInput()
+{
+  receiveInput();
+  while (_queuedCommands > 0)
+  {
+    // The queue always starts with a complete command.
+    byte length = 0;
+    while (_queue[length] != '#')
+    {
+      length++;
+    }
+    _queue[length] = '\0';
+    dispatchCommand(_queue);
+
+    length++;
+    _queueLength -= length;
+    if (_inCommand)
+    {
+      _frameStart -= length;
+    }
+    memmove(_queue, _queue + length, _queueLength);
+    _queuedCommands--;
+
+    if ((_stopAfter > 0) && (--_stopAfter == 0))
+    {
+      // Whatever the commands ahead of the stop started, it stops too
+      LOGV3(_debugFlags, F("%s: Repeating [%s]"), _name, _stop);
+      dispatchCommand(_stop, false);
+    }
+
+    receiveAll();
+  }
+}
+
+/////////////////////////////////
+//
+// receiveAll
+//
+// Scans the input of every transport, running the priority commands found.
+//
+/////////////////////////////////
+void CommandTransport::receiveAll()
+{
+  for (CommandTransport* transport = _first; transport != nullptr; transport = transport->_next)
+  {
+    transport->receiveInput();
+  }
+}
+
+/////////////////////////////////
+//
+// receiveInput
+//
+// A command starts with ':' and ends with '#'. Anything received outside of a
+// command (stray '#'s, NexStar 'Ka' probes, line endings from terminals) is dropped,
+// except for the ACK byte, which is answered immediately.
+//
+// Available bytes are pulled into the queue and scanned as they arrive. Priority
+// commands are run as soon as their '#' is seen, even if other commands are queued
+// ahead of them (so their replies may overtake those of earlier commands).
+// A stop is repeated once the commands queued ahead of it on any transport ran,
+// since one of them may start a slew (e.g. :Sr..#:Sd..#:MS#:Q# sent in one go).
+//
+/////////////////////////////////
+void CommandTransport::receiveInput()
+{
+  while ((_queueLength < COMMAND_TRANSPORT_QUEUE_SIZE) && (_stream->available() > 0))
+  {
+    int ch = _stream->read();
+    if (ch < 0)
+    {
+      break;
+    }
+
+    if (!_inCommand)
+    {
+      if (ch == 0x06)
+      {
+        LOGV3(_debugFlags, F("%s: Received: ACK request, replying %c"), _name, MEADE_ACK_REPLY);
+        _stream->print(MEADE_ACK_REPLY);
+      }
+      else if (ch == ':')
+      {
+        _inCommand = true;
+        _overflowed = false;
+        _frameStart = _queueLength;
+        _queue[_queueLength++] = ':';
+      }
+      continue;
+    }
+
+    if (ch == '#')
+    {
+      _inCommand = false;
+      _queue[_queueLength] = '\0';
+      char* command = _queue + _frameStart;
+      if (_overflowed)
+      {
+        LOGV3(_debugFlags, F("%s: Dropped overlong command starting with [%s]"), _name, command);
+        _queueLength = _frameStart;
+      }
+      else if (isPriorityCommand(command))
+      {
+        LOGV2(_debugFlags, F("%s: Priority command"), _name);
+        if (command[1] == 'Q')
+        {
+          for (CommandTransport* transport = _first; transport != nullptr; transport = transport->_next)
+          {
+            transport->deferStop(command);
+          }
+        }
+        dispatchCommand(command);
+        _queueLength = _frameStart;
+      }
+      else
+      {
+        _queue[_queueLength++] = '#';
+        _queuedCommands++;
+      }
+    }
+    else if (_overflowed)
+    {
+      // Swallow the rest of the overlong command
+    }
+    else if (_queueLength - _frameStart < MEADE_COMMAND_BUFFER_SIZE)
+    {
+      _queue[_queueLength++] = (char)ch;
+    }
+    else
+    {
+      _overflowed = true;
+      _queue[_queueLength] = '\0';
+    }
+  }
+}
+
+/////////////////////////////////
+//
+// deferStop
+//
+// Has the given stop run again after the commands currently queued. If a stop is
+// pending already, the later position wins and the two stops are combined.
+//
+/////////////////////////////////
+void CommandTransport::deferStop(const char* command)
+{
+  if (_queuedCommands == 0)
+  {
+    return;
+  }
+
+  if (_stopAfter == 0)
+  {
+    strncpy(_stop, command, sizeof(_stop) - 1);
+    _stop[sizeof(_stop) - 1] = '\0';
+  }
+  else if (strcmp(_stop, command) != 0)
+  {
+    // A full stop (:Q) covers everything, otherwise both directions are stopped (:Qa)
+    strcpy(_stop, ((_stop[2] == '\0') || (command[2] == '\0')) ? ":Q" : ":Qa");
+  }
+  _stopAfter = _queuedCommands;
+}
+
+void CommandTransport::dispatchCommand(const char* command, bool reply)
+{
+  LOGV3(_debugFlags, F("%s: ReceivedCommand: [%s]"), _name, command);
+
+  String retVal = MeadeCommandProcessor::instance()->processCommand(String(command));
+  if (reply && (retVal != ""))
+  {
+    LOGV3(_debugFlags, F("%s: RepliedWith:  [%s]"), _name, retVal.c_str());
+    _stream->print(retVal);
+  }
+  else
+  {
+    LOGV2(_debugFlags, F("%s: NoReply"), _name);
+  }
+
+  _mount->loop();
+}
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "inc/Globals.hpp"
+
+// Forward declarations
+class Mount;
+
+// Longest Meade command we accept, including the leading ':' but not the terminating '#'.
+#define MEADE_COMMAND_BUFFER_SIZE 40
+
+// Bytes of received commands that can be held per transport. This is how far ahead
+// we can look for stop and guide commands while other commands are waiting to run.
+#define COMMAND_TRANSPORT_QUEUE_SIZE 96
+
+// The reply sent to the LX200 ACK (0x06) handshake on every transport.
+#define MEADE_ACK_REPLY '1'
+
+/////////////////////////////////
+//
+// CommandTransport
+//
+// Frames Meade commands arriving on any Arduino Stream (USB serial, Bluetooth SPP,
+// a TCP client, ...), hands complete commands to the MeadeCommandProcessor and
+// writes the reply back to the same stream. Bytes are collected into a fixed
+// queue across calls, so processInput() never blocks waiting for a '#'.
+// Stop (:Q) and guide pulse (:Mg) commands jump the queue, including the queues
+// of all other transports. A stop also runs again, without a reply, right after the
+// commands that were queued ahead of it, so a slew queued before it cannot outlive it.
+//
+/////////////////////////////////
+class CommandTransport
+{
+public:
+  CommandTransport(Stream* stream, Mount* mount, int debugFlags, const char* name);
+  ~CommandTransport();
+
+  // Reads the bytes currently available and runs the complete commands among them,
+  // stop and guide commands first.
+  void processInput();
+
+  // Discards any partially received command, e.g. when a new client connects.
+  void reset();
+
+private:
+  void receiveInput();
+  static void receiveAll();
+  static bool isPriorityCommand(const char* command);
+  void deferStop(const char* command);
+  void dispatchCommand(const char* command, bool reply = true);
+
+  Stream* _stream;
+  Mount* _mount;
+  int _debugFlags;
+  const char* _name;
+  char _queue[COMMAND_TRANSPORT_QUEUE_SIZE + 1];
+  byte _queueLength;      // Bytes used in _queue
+  byte _frameStart;       // Start of the command currently being received
+  byte _queuedCommands;   // Complete commands waiting in _queue
+  bool _inCommand;
+  bool _overflowed;
+  char _stop[4];          // Stop command to run again once the commands queued ahead of it ran
+  byte _stopAfter;        // How many of the queued commands are ahead of it, 0 if there is none
+
+  CommandTransport* _next;          // All transports, so they can be scanned for priority commands
+  static CommandTransport* _first;
+};
@@ -9,71 +9,94 @@
 // A class to handle hours, minutes, seconds in a unified manner, allowing
 // addition of hours, minutes, seconds, other times and conversion to string.
 
-// Parses the RA or DEC from a string that has an optional sign, a two digit degree, a seperator, a two digit minute, a seperator and a two digit second.
+// Parses the RA or DEC from a string that has an optional sign, a two or three digit degree, a seperator, a two digit minute, 
+// and then either nothing, a seperator and a two digit second, or a '.' and a single digit of tenths of a minute.
 // Does not correct for hemisphere (derived class Declination takes care of that)
-// For example:   -45*32:11 or 23:44:22
-DayTime DayTime::ParseFromMeade(String const& s)
+// For example:   -45*32:11 or 23:44:22 or 23:44.3
+DayTime::ParseResult DayTime::ParseFromMeade(const char *s, DayTime &result)
 {
-  DayTime result;
-  int i = 0;
+  const char *p = s;
   long sgn = 1;
-  LOGV2(DEBUG_MEADE, F("DayTime: Parse Coord from [%s]"), s.c_str());
+  long degs, mins, secs = 0;
+  LOGV2(DEBUG_MEADE, F("DayTime: Parse Coord from [%s]"), s);
+
   // Check whether we have a sign. This should be able to parse RA and DEC strings (RA never has a sign, and DEC should always have one).
-  if ((s[i] == '-') || (s[i] == '+'))
+  if ((*p == '-') || (*p == '+'))
   {
-    sgn = s[i] == '-' ? -1 : +1;
-    i++;
+    sgn = *p == '-' ? -1 : +1;
+    p++;
   }
 
   // Degs can be 2 or 3 digits
-  long degs = s[i++] - '0';
-  LOGV3(DEBUG_MEADE, F("DayTime: 1st digit [%c] -> degs=%l"), s[i - 1], degs);
-  degs = degs * 10 + s[i++] - '0';
-  LOGV3(DEBUG_MEADE, F("DayTime: 2nd digit [%c] -> degs=%l"), s[i - 1], degs);
+  ParseResult error = parseDigits(p, 2, degs);
+  if (error != PARSE_OK)
+  {
+    return error;
+  }
+  if ((*p >= '0') && (*p <= '9'))
+  {
+    degs = degs * 10 + (*p++ - '0');
+  }
 
-  // Third digit?
-  if ((s[i] >= '0') && (s[i] <= '9'))
+  // Meade uses the degree sign (0xDF in its character set) between degrees and minutes
+  if ((*p != ':') && (*p != '*') && (*p != '\'') && (*p != '\xDF'))
   {
-    degs = degs * 10 + s[i++] - '0';
-    LOGV3(DEBUG_MEADE, F("DayTime: 3rd digit [%c] -> degs=%d"), s[i - 1], degs);
+    return PARSE_BAD_SEPARATOR;
   }
-  i++; // Skip seperator
+  p++;
 
-  int mins = s.substring(i, i + 2).toInt();
-  LOGV3(DEBUG_MEADE, F("DayTime: Minutes are [%s] -> mins=%d"), s.substring(i, i + 2).c_str(), mins);
-  int secs = 0;
-  if (int(s.length()) > i + 4)
+  error = parseDigits(p, 2, mins);
+  if (error != PARSE_OK)
   {
-    secs = s.substring(i + 3, i + 5).toInt();
-    LOGV3(DEBUG_MEADE, F("DayTime: Seconds are [%s] -> secs=%d"), s.substring(i + 3, i + 5).c_str(), secs);
+    return error;
   }
-  else
+
+  if (*p == '.')
+  {
+    // Low precision, tenths of a minute
+    p++;
+    error = parseDigits(p, 1, secs);
+    secs *= 6;
+  }
+  else if ((*p == ':') || (*p == '\''))
+  {
+    p++;
+    error = parseDigits(p, 2, secs);
+  }
+  if (error != PARSE_OK)
+  {
+    return error;
+  }
+
+  if ((*p != '\0') && (*p != '#'))
   {
-    LOGV3(DEBUG_MEADE, F("DayTime: No Seconds. slen %d is not > %d"), s.length(), i + 4);
+    return PARSE_TRAILING_CHARACTERS;
   }
+  if ((mins > 59) || (secs > 59))
+  {
+    return PARSE_OUT_OF_RANGE;
+  }
+
   // Get the signed total seconds specified....
   result.totalSeconds = sgn * (((degs * 60L + mins) * 60L) + secs);
 
   LOGV5(DEBUG_MEADE, F("DayTime: TotalSeconds are %l from %lh %dm %ds"), result.totalSeconds, degs, mins, secs);
-
-  return result;
-}
-
-DayTime::DayTime()
-{
-  totalSeconds = 0;
+  return PARSE_OK;
 }
 
-DayTime::DayTime(const DayTime &other)
+// Reads exactly count digits, advancing p past them.
+DayTime::ParseResult DayTime::parseDigits(const char *&p, int count, long &value)
 {
-  totalSeconds = other.totalSeconds;
-}
-
-DayTime::DayTime(int h, int m, int s)
-{
-  long sgn = sign(h);
-  h = abs(h);
-  totalSeconds = sgn * ((60L* h + m) * 60L + s);
+  value = 0;
+  while (count--)
+  {
+    if ((*p < '0') || (*p > '9'))
+    {
+      return PARSE_MISSING_DIGIT;
+    }
+    value = value * 10 + (*p++ - '0');
+  }
+  return PARSE_OK;
 }
 
 DayTime::DayTime(float timeInHours)
@@ -114,11 +137,6 @@ float DayTime::getTotalMinutes() const
   return 1.0f * totalSeconds / 60.0f;
 }
 
-long DayTime::getTotalSeconds() const
-{
-  return totalSeconds;
-}
-
 void DayTime::getTime(int &h, int &m, int &s) const
 {
   long seconds = abs(totalSeconds);
@@ -197,7 +215,12 @@ char achBuf[32];
 // Convert to a standard string (like 14:45:06)
 const char *DayTime::ToString() const
 {
-  char *p = achBuf;
+  return ToString(achBuf);
+}
+
+const char *DayTime::ToString(char *targetBuffer) const
+{
+  char *p = targetBuffer;
   int hours, mins, secs;
   getTime(hours, mins, secs);
 
@@ -243,8 +266,9 @@ const char *DayTime::ToString() const
   *p++ = '(';
   strcpy(p, String(this->getTotalHours(), 5).c_str());
   strcat(p, ")");
-  return achBuf;
+  return targetBuffer;
 }
+
 void DayTime::printTwoDigits(char *achDegs, int num) const
 {
   achDegs[0] = '0' + (num / 10);
@@ -266,7 +290,7 @@ const char *DayTime::formatStringImpl(char *targetBuffer, const char *format, ch
   if (degs >= 100)
   {
     achDegs[i++] = '0' + (degs / 100);
-    degs /= 10;
+    degs %= 100;
   }
 
   printTwoDigits(achDegs + i, degs);
@@ -344,3 +368,36 @@ const char *DayTime::formatString(char *targetBuffer, const char *format, long *
 
   return formatStringImpl(targetBuffer, format, sgn, degs, mins, secs);
 }
+
+// The RA is normalized to 0..24h. Everything below the hours fits in 16 bits, which keeps the AVR divisions short.
+const char *DayTime::formatMeadeString(char *targetBuffer, bool highPrecision) const
+{
+  long secs = totalSeconds % secondsPerDay;
+  if (secs < 0)
+  {
+    secs += secondsPerDay;
+  }
+  unsigned int hours = (unsigned int)(secs / 3600L);
+  unsigned int rest = (unsigned int)(secs - hours * 3600L);
+  char *p = targetBuffer;
+
+  printTwoDigits(p, hours);
+  p += 2;
+  *p++ = ':';
+  printTwoDigits(p, rest / 60);
+  p += 2;
+  if (highPrecision)
+  {
+    *p++ = ':';
+    printTwoDigits(p, rest % 60);
+    p += 2;
+  }
+  else
+  {
+    *p++ = '.';
+    *p++ = '0' + (rest % 60) / 6;
+  }
+  *p++ = '#';
+  *p = '\0';
+  return targetBuffer;
+}
@@ -7,16 +7,16 @@
 class String;
 
 // DayTime handles a 24-hour time.
+// It is a plain value (a count of seconds, no vtable) that is copied around freely. The types
+// derived from it keep their own range, so they hide the functions that would wrap it as a time.
 class DayTime
 {
 protected:
   long totalSeconds;
 
 public:
-  DayTime();
-
-  DayTime(const DayTime &other);
-  DayTime(int h, int m, int s);
+  constexpr DayTime() : totalSeconds(0) {}
+  constexpr DayTime(int h, int m, int s) : totalSeconds((h < 0) ? -((60L * -h + m) * 60L + s) : (60L * h + m) * 60L + s) {}
 
   // From hours
   DayTime(float timeInHours);
@@ -26,14 +26,14 @@ public:
   int getSeconds() const;
   float getTotalHours() const;
   float getTotalMinutes() const;
-  long getTotalSeconds() const;
+  constexpr long getTotalSeconds() const { return totalSeconds; }
 
   void getTime(int &h, int &m, int &s) const;
-  virtual void set(int h, int m, int s);
+  void set(int h, int m, int s);
   void set(const DayTime &other);
 
   // Add hours, wrapping days (which are not tracked). Negative or positive.
-  virtual void addHours(int deltaHours);
+  void addHours(int deltaHours);
 
   // Add minutes, wrapping hours if needed
   void addMinutes(int deltaMins);
@@ -50,17 +50,34 @@ public:
 
   void subtractTime(const DayTime &other);
 
-  // Convert to a standard string (like 14:45:06)
-  virtual const char *ToString() const;
-  virtual const char *formatString(char *targetBuffer, const char *format, long *pSeconds = nullptr) const;
+  // Convert to a standard string (like 14:45:06) in targetBuffer, which holds 32 characters
+  const char *ToString(char *targetBuffer) const;
+  // The same in a buffer shared by all times, for logging
+  const char *ToString() const;
+  const char *formatString(char *targetBuffer, const char *format, long *pSeconds = nullptr) const;
+
+  // Write the LX200 RA reply (HH:MM:SS# in high precision, HH:MM.T# in low precision) using integer math only
+  const char *formatMeadeString(char *targetBuffer, bool highPrecision) const;
 
   //protected:
-  virtual void checkHours();
+  void checkHours();
+
+  // Errors from parsing a Meade coordinate
+  enum ParseResult {
+    PARSE_OK = 0,
+    PARSE_MISSING_DIGIT,       // A field was too short or contained something other than digits
+    PARSE_BAD_SEPARATOR,       // The fields were not separated by one of : * ' or the degree sign
+    PARSE_OUT_OF_RANGE,        // Minutes or seconds were 60 or more, or the value is out of range for the type
+    PARSE_TRAILING_CHARACTERS, // There was more after the last field
+  };
 
-  static DayTime ParseFromMeade(String const& s);
+  // Parses an LX200 time or angle in one pass without allocating. Accepts sDD*MM:SS, sDD*MM and
+  // HH:MM.T (tenths of a minute), with an optional sign and 2 or 3 digit degrees.
+  static ParseResult ParseFromMeade(const char *s, DayTime &result);
 
 protected:
   const char *formatStringImpl(char *targetBuffer, const char *format, char sgn, long degs, long mins, long secs) const;
+  static ParseResult parseDigits(const char *&p, int count, long &value);
   void printTwoDigits(char *achDegs, int num) const;
 
 private:
@@ -13,32 +13,33 @@
 
 // In the northern hemisphere, 0 is north pole, -180 is south pole
 // In the southern hemisphere, 0 is south pole, -180 is north pole
-Declination::Declination() : DayTime()
-{
-}
-
-Declination::Declination(const Declination &other) : DayTime(other)
+Declination::Declination(float inDegrees) : DayTime(inDegrees)
 {
 }
 
-Declination::Declination(int h, int m, int s) : DayTime(h, m, s)
+void Declination::set(int h, int m, int s)
 {
+  Declination dt(h, m, s);
+  totalSeconds = dt.totalSeconds;
+  checkHours();
 }
 
-Declination::Declination(float inDegrees) : DayTime(inDegrees)
+void Declination::addDegrees(int deltaDegrees)
 {
+  totalSeconds += (long)deltaDegrees * 3600L;
+  checkHours();
 }
 
-void Declination::set(int h, int m, int s)
+void Declination::addMinutes(int deltaMins)
 {
-  Declination dt(h, m, s);
-  totalSeconds = dt.totalSeconds;
+  totalSeconds += deltaMins * 60L;
   checkHours();
 }
 
-void Declination::addDegrees(int deltaDegrees)
+void Declination::addSeconds(long deltaSecs)
 {
-  addHours(deltaDegrees);
+  totalSeconds += deltaSecs;
+  checkHours();
 }
 
 float Declination::getTotalDegrees() const
@@ -72,30 +73,43 @@ const char *Declination::ToDisplayString(char sep1, char sep2) const
 
 const char *Declination::ToString() const
 {
-  ToDisplayString('*', ':');
+  return ToString(achBufDeg);
+}
 
-  char *p = achBufDeg + strlen(achBufDeg);
+const char *Declination::ToString(char *targetBuffer) const
+{
+  formatString(targetBuffer, "{d}*{m}:{s}");
+
+  char *p = targetBuffer + strlen(targetBuffer);
 
   *p++ = ' ';
   *p++ = '(';
   strcpy(p, String(NORTHERN_HEMISPHERE ? getTotalHours() + 90 : -90 - getTotalHours(), 4).c_str());
   strcat(p, ")");
 
-  return achBufDeg;
+  return targetBuffer;
 }
 
-Declination Declination::ParseFromMeade(String const& s)
+DayTime::ParseResult Declination::ParseFromMeade(const char *s, Declination &result)
 {
-  Declination result;
-  LOGV2(DEBUG_GENERAL, F("Declination.Parse(%s)"), s.c_str());
+  LOGV2(DEBUG_GENERAL, F("Declination.Parse(%s)"), s);
 
   // Use the DayTime code to parse it...
-  DayTime dt = DayTime::ParseFromMeade(s);
+  DayTime dt;
+  ParseResult error = DayTime::ParseFromMeade(s, dt);
+  if (error != PARSE_OK)
+  {
+    return error;
+  }
+  if (abs(dt.getTotalSeconds()) > arcSecondsPerHemisphere/2)
+  {
+    return PARSE_OUT_OF_RANGE;
+  }
 
   // ...and then correct for hemisphere
   result.totalSeconds = dt.getTotalSeconds() + (NORTHERN_HEMISPHERE ? -(arcSecondsPerHemisphere/2) : (arcSecondsPerHemisphere/2));
-  LOGV3(DEBUG_GENERAL, F("Declination.Parse(%s) -> %s"), s.c_str(), result.ToString());
-  return result;
+  LOGV3(DEBUG_GENERAL, F("Declination.Parse(%s) -> %s"), s, result.ToString());
+  return PARSE_OK;
 }
 
 Declination Declination::FromSeconds(long seconds)
@@ -110,3 +124,29 @@ const char *Declination::formatString(char *targetBuffer, const char *format, lo
   secs = NORTHERN_HEMISPHERE ? (secs + arcSecondsPerHemisphere/2) : (-arcSecondsPerHemisphere/2 - secs);
   return DayTime::formatString(targetBuffer, format, &secs);
 }
+
+const char *Declination::formatMeadeString(char *targetBuffer, bool highPrecision) const
+{
+  long secs = NORTHERN_HEMISPHERE ? (totalSeconds + arcSecondsPerHemisphere/2) : (-arcSecondsPerHemisphere/2 - totalSeconds);
+  char *p = targetBuffer;
+
+  *p++ = secs < 0 ? '-' : '+';
+  secs = abs(secs);
+  unsigned int degs = (unsigned int)(secs / 3600L);
+  unsigned int rest = (unsigned int)(secs - degs * 3600L);
+
+  printTwoDigits(p, degs);
+  p += 2;
+  *p++ = '*';
+  printTwoDigits(p, rest / 60);
+  p += 2;
+  if (highPrecision)
+  {
+    *p++ = '\'';
+    printTwoDigits(p, rest % 60);
+    p += 2;
+  }
+  *p++ = '#';
+  *p = '\0';
+  return targetBuffer;
+}
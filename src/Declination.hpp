@@ -9,30 +9,40 @@
 class Declination : public DayTime
 {
 public:
-  Declination();
-  Declination(const Declination &other);
-  Declination(int h, int m, int s);
+  constexpr Declination() : DayTime() {}
+  constexpr Declination(int h, int m, int s) : DayTime(h, m, s) {}
   Declination(float inDegrees);
 
-  virtual void set(int h, int m, int s);
+  void set(int h, int m, int s);
 
-  // Add degrees, clamp to -180...0
+  // Add degrees, minutes or seconds, clamp to -180...0
   void addDegrees(int deltaDegrees);
+  void addMinutes(int deltaMins);
+  void addSeconds(long deltaSecs);
+
+  // These would wrap a declination like a time
+  void addHours(int) = delete;
+  void addTime(const DayTime &) = delete;
+  void subtractTime(const DayTime &) = delete;
 
   // Get total degrees (-180..0)
   float getTotalDegrees() const;
 
   // Convert to a standard string (like +54:45:06)
-  virtual const char *ToString() const override;
-  virtual const char *formatString(char *targetBuffer, const char *format, long *pSeconds = nullptr) const;
+  const char *ToString(char *targetBuffer) const;
+  const char *ToString() const;
+  const char *formatString(char *targetBuffer, const char *format, long *pSeconds = nullptr) const;
+
+  // Write the LX200 DEC reply (sDD*MM'SS# in high precision, sDD*MM# in low precision) using integer math only
+  const char *formatMeadeString(char *targetBuffer, bool highPrecision) const;
 
   const char *ToDisplayString(char sep1, char sep2) const;
 
 protected:
-  virtual void checkHours() override;
+  void checkHours();
 
 public:
-  static Declination ParseFromMeade(String const& s);
+  static ParseResult ParseFromMeade(const char *s, Declination &result);
   static Declination FromSeconds(long seconds);
 
 private:
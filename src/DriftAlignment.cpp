@@ -0,0 +1,152 @@
+#include "../Configuration.hpp"
+#include "Utility.hpp"
+#include "Mount.hpp"
+#include "DriftAlignment.hpp"
+
+// How long the mount settles before, between and after the passes, in ms
+#define DRIFT_ALIGNMENT_PAUSE         1500
+
+// How far a pass moves RA
+#define DRIFT_ALIGNMENT_ARCMINUTES    5.3f
+
+// The steps that take up the backlash of the gears, at the slew speed
+#define DRIFT_ALIGNMENT_BACKLASH      20
+
+// What the mount does in each step, in order
+static const DriftAlignment::State steps[] = {
+  DriftAlignment::PAUSING,
+  DriftAlignment::EAST_PASS,
+  DriftAlignment::BACKLASH,
+  DriftAlignment::PAUSING,
+  DriftAlignment::WEST_PASS,
+  DriftAlignment::PAUSING,
+  DriftAlignment::BACKLASH,
+};
+#define STEP_COUNT (sizeof(steps) / sizeof(steps[0]))
+
+DriftAlignment::DriftAlignment(Mount* mount)
+{
+  _mount = mount;
+  _step = 0;
+  _passSeconds = 0;
+  _passSteps = 0;
+  _raTarget = 0;
+  _stepSince = 0;
+  _startedAt = 0;
+}
+
+bool DriftAlignment::start(int passSeconds)
+{
+  if (isRunning() || _mount->isParking() || _mount->isFindingHome()) {
+    return false;
+  }
+
+  _passSeconds = max(passSeconds, 1);
+  _passSteps = floor(_mount->getStepsPerDegree(RA_STEPS) * DRIFT_ALIGNMENT_ARCMINUTES / 60.0f);
+  LOGV3(DEBUG_MOUNT, F("DriftAlignment: Starting, passes of %l steps in %ds"), _passSteps, _passSeconds);
+
+  _mount->stopGuiding();
+  _mount->stopSlewing(ALL_DIRECTIONS | TRACKING);
+  _startedAt = millis();
+  startStep(1);
+  return true;
+}
+
+void DriftAlignment::stop()
+{
+  if (!isRunning()) {
+    return;
+  }
+  LOGV2(DEBUG_MOUNT, F("DriftAlignment: Stopped in step %d"), _step);
+  _step = 0;
+  _mount->stopSlewing(EAST | WEST);
+  _mount->resetRASpeed();
+  _mount->startSlewing(TRACKING);
+}
+
+DriftAlignment::State DriftAlignment::state() const
+{
+  return (_step == 0) ? IDLE : steps[_step - 1];
+}
+
+long DriftAlignment::secondsLeft() const
+{
+  if (!isRunning()) {
+    return 0;
+  }
+  long left = 2000L * _passSeconds + 3L * DRIFT_ALIGNMENT_PAUSE - (long)(millis() - _startedAt);
+  return max(left, 0L) / 1000;
+}
+
+void DriftAlignment::startStep(byte step)
+{
+  _step = step;
+  _stepSince = millis();
+
+  // A speed of 0 moves at the slew speed, which also leaves RA at that speed once the last step is done
+  long move = 0;
+  float speed = 0;
+  switch (state()) {
+    case EAST_PASS:
+      move = _passSteps;
+      speed = 1.0f * _passSteps / _passSeconds;
+      break;
+
+    case WEST_PASS:
+      move = -_passSteps;
+      speed = 1.0f * _passSteps / _passSeconds;
+      break;
+
+    case BACKLASH:
+      // Back against the way the pass before went
+      move = (_step < STEP_COUNT) ? -DRIFT_ALIGNMENT_BACKLASH : DRIFT_ALIGNMENT_BACKLASH;
+      break;
+
+    default:
+      return;
+  }
+
+  LOGV4(DEBUG_MOUNT, F("DriftAlignment: Step %d moves RA %l steps (%c)"), _step, move, state());
+  _raTarget = _mount->getCurrentStepperPosition(EAST) + move;
+  _mount->moveRA(move, speed);
+}
+
+void DriftAlignment::loop()
+{
+  if (!isRunning()) {
+    return;
+  }
+
+  unsigned long now = millis();
+  if (state() == PAUSING) {
+    // The pause starts once the motors stopped
+    if (_mount->isSlewingRAorDEC()) {
+      _stepSince = now;
+      return;
+    }
+    if (now - _stepSince < DRIFT_ALIGNMENT_PAUSE) {
+      return;
+    }
+  }
+  else {
+    if (_mount->isSlewingRAorDEC()) {
+      return;
+    }
+    if (_mount->getCurrentStepperPosition(EAST) != _raTarget) {
+      // Something else stopped RA (e.g. :Q), which leaves the mount as it is, but at the slew speed
+      LOGV2(DEBUG_MOUNT, F("DriftAlignment: RA was stopped in step %d, giving up."), _step);
+      _step = 0;
+      _mount->resetRASpeed();
+      return;
+    }
+  }
+
+  if (_step < STEP_COUNT) {
+    startStep(_step + 1);
+  }
+  else {
+    LOGV1(DEBUG_MOUNT, F("DriftAlignment: Done, tracking again."));
+    _step = 0;
+    _mount->startSlewing(TRACKING);
+  }
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "inc/Globals.hpp"
+
+// Forward declarations
+class Mount;
+
+//////////////////////////////////////
+// Runs the drift alignment: with tracking off, RA moves east about 5 arcminutes in the length
+// of a pass, takes up the gear backlash, and moves back west in the same time, with a pause
+// before, between and after the passes. The trails a star leaves in one long exposure show
+// how far the polar alignment is off. Then the mount tracks again.
+//
+// Mount::loop() runs it and nothing in it waits, so serial and WiFi clients are served all the
+// way through. :XDX or the menu stops it, and so does anything else that moves the mount.
+//////////////////////////////////////
+class DriftAlignment
+{
+public:
+  enum State : char {
+    IDLE = 'I',
+    PAUSING = 'P',    // Waiting for the motors to stop, then for the mount to settle
+    EAST_PASS = 'E',
+    WEST_PASS = 'W',
+    BACKLASH = 'B',   // Taking up the backlash of the gears before the next pass, or before tracking
+  };
+
+  DriftAlignment(Mount* mount);
+
+  // Starts it with passes of the given seconds. False if it runs already, or the mount parks.
+  bool start(int passSeconds);
+
+  // Stops RA where it is and tracks again
+  void stop();
+
+  // Moves the procedure on. Called from Mount::loop().
+  void loop();
+
+  State state() const;
+  bool isRunning() const { return _step != 0; }
+
+  // About how many seconds it takes until it is done
+  long secondsLeft() const;
+
+private:
+  void startStep(byte step);
+
+  Mount* _mount;
+  byte _step;                 // 1 based index of the current step, 0 when it does not run
+  int _passSeconds;
+  long _passSteps;
+  long _raTarget;             // Where the move of the current step ends
+  unsigned long _stepSince;   // millis() when the step started, or the motors stopped for a pause
+  unsigned long _startedAt;
+};
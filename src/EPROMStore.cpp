@@ -236,7 +236,7 @@ bool EEPROMStore::isPresent(ItemFlag item)
 bool EEPROMStore::isPresentExtended(ExtendedItemFlag item)
 {
   // Check if any extended data is present
-  if (isPresent(EXTENDED_FLAG))
+  if (!isPresent(EXTENDED_FLAG))
     return false;   // No extended data present
 
   // Have extended data, now see if required item is available
@@ -0,0 +1,186 @@
+#include "FixedTrig.hpp"
+
+//////////////////////////////////////////////////////////////////////////////////////
+//
+// FixedTrig
+//
+// Table lookups with linear interpolation. Both tables have 256 steps plus the end point.
+
+// sin(i * 90 / 256 degrees) * 32768
+static const uint16_t sineTable[257] PROGMEM = {
+  0, 201, 402, 603, 804, 1005, 1206, 1407, 1608, 1809, 2009, 2210, 2411, 2611, 2811, 3012,
+  3212, 3412, 3612, 3812, 4011, 4211, 4410, 4609, 4808, 5007, 5205, 5404, 5602, 5800, 5998, 6195,
+  6393, 6590, 6787, 6983, 7180, 7376, 7571, 7767, 7962, 8157, 8351, 8546, 8740, 8933, 9127, 9319,
+  9512, 9704, 9896, 10088, 10279, 10469, 10660, 10850, 11039, 11228, 11417, 11605, 11793, 11980, 12167, 12354,
+  12540, 12725, 12910, 13095, 13279, 13463, 13646, 13828, 14010, 14192, 14373, 14553, 14733, 14912, 15091, 15269,
+  15447, 15624, 15800, 15976, 16151, 16326, 16500, 16673, 16846, 17018, 17190, 17361, 17531, 17700, 17869, 18037,
+  18205, 18372, 18538, 18703, 18868, 19032, 19195, 19358, 19520, 19681, 19841, 20001, 20160, 20318, 20475, 20632,
+  20788, 20943, 21097, 21251, 21403, 21555, 21706, 21856, 22006, 22154, 22302, 22449, 22595, 22740, 22884, 23028,
+  23170, 23312, 23453, 23593, 23732, 23870, 24008, 24144, 24279, 24414, 24548, 24680, 24812, 24943, 25073, 25202,
+  25330, 25457, 25583, 25708, 25833, 25956, 26078, 26199, 26320, 26439, 26557, 26674, 26791, 26906, 27020, 27133,
+  27246, 27357, 27467, 27576, 27684, 27791, 27897, 28002, 28106, 28209, 28311, 28411, 28511, 28610, 28707, 28803,
+  28899, 28993, 29086, 29178, 29269, 29359, 29448, 29535, 29622, 29707, 29792, 29875, 29957, 30038, 30118, 30196,
+  30274, 30350, 30425, 30499, 30572, 30644, 30715, 30784, 30853, 30920, 30986, 31050, 31114, 31177, 31238, 31298,
+  31357, 31415, 31471, 31527, 31581, 31634, 31686, 31737, 31786, 31834, 31881, 31927, 31972, 32015, 32058, 32099,
+  32138, 32177, 32214, 32251, 32286, 32319, 32352, 32383, 32413, 32442, 32470, 32496, 32522, 32546, 32568, 32590,
+  32610, 32629, 32647, 32664, 32679, 32693, 32706, 32718, 32729, 32738, 32746, 32753, 32758, 32762, 32766, 32767,
+  32768
+};
+
+// How far atan(i / 256) is above the straight line from 0 to 45 degrees, in 2^-19 of 45 degrees
+static const uint16_t arctangentTable[257] PROGMEM = {
+  0, 560, 1119, 1678, 2238, 2796, 3355, 3913, 4470, 5027, 5583, 6138, 6692, 7246, 7798, 8349,
+  8899, 9448, 9996, 10542, 11086, 11629, 12170, 12710, 13248, 13784, 14318, 14850, 15380, 15907, 16433, 16956,
+  17476, 17995, 18510, 19023, 19534, 20041, 20546, 21048, 21547, 22043, 22536, 23026, 23512, 23995, 24475, 24951,
+  25424, 25893, 26359, 26821, 27279, 27733, 28184, 28630, 29073, 29511, 29946, 30376, 30802, 31223, 31641, 32054,
+  32462, 32866, 33265, 33660, 34050, 34436, 34816, 35192, 35563, 35929, 36290, 36646, 36997, 37343, 37683, 38019,
+  38349, 38674, 38994, 39308, 39617, 39920, 40218, 40510, 40797, 41078, 41354, 41624, 41888, 42147, 42399, 42646,
+  42887, 43122, 43352, 43575, 43792, 44004, 44209, 44408, 44602, 44789, 44970, 45145, 45314, 45476, 45632, 45782,
+  45926, 46064, 46195, 46320, 46438, 46551, 46657, 46756, 46849, 46936, 47016, 47090, 47157, 47218, 47272, 47320,
+  47361, 47396, 47424, 47446, 47461, 47470, 47472, 47468, 47457, 47439, 47415, 47384, 47346, 47302, 47252, 47194,
+  47131, 47060, 46983, 46899, 46809, 46712, 46609, 46498, 46382, 46258, 46128, 45992, 45849, 45699, 45542, 45379,
+  45210, 45034, 44851, 44662, 44466, 44263, 44054, 43839, 43617, 43388, 43153, 42911, 42663, 42408, 42147, 41880,
+  41605, 41325, 41038, 40744, 40445, 40138, 39826, 39507, 39181, 38849, 38511, 38167, 37816, 37459, 37095, 36725,
+  36349, 35967, 35579, 35184, 34783, 34376, 33962, 33543, 33117, 32686, 32248, 31804, 31353, 30897, 30435, 29967,
+  29492, 29012, 28526, 28034, 27535, 27031, 26521, 26005, 25483, 24956, 24422, 23883, 23337, 22786, 22230, 21667,
+  21099, 20525, 19945, 19360, 18769, 18172, 17570, 16962, 16348, 15729, 15105, 14475, 13839, 13198, 12551, 11899,
+  11242, 10579, 9911, 9237, 8558, 7874, 7184, 6489, 5789, 5084, 4373, 3657, 2936, 2210, 1478, 742,
+  0
+};
+
+// The top 2 bits of the angle pick the quadrant, the next 8 the table step and the 16 after that
+// how far along the step it is.
+int16_t FixedTrig::sin(Angle angle)
+{
+  uint8_t quadrant = angle >> 30;
+  uint32_t inQuadrant = angle & (QUARTER_TURN - 1);
+  if (quadrant & 1)
+  {
+    // The second and fourth quadrants run the table backwards
+    inQuadrant = QUARTER_TURN - inQuadrant;
+  }
+
+  uint16_t index = inQuadrant >> 22;
+  uint16_t fraction = inQuadrant >> 6;
+  uint16_t value = pgm_read_word(&sineTable[index]);
+  if (index < 256)
+  {
+    uint16_t next = pgm_read_word(&sineTable[index + 1]);
+    value += ((uint32_t)(next - value) * fraction) >> 16;
+  }
+  if (value > 32767)
+  {
+    value = 32767;
+  }
+  return (quadrant & 2) ? -(int16_t)value : (int16_t)value;
+}
+
+// Looks up the smaller of |x| and |y| over the larger, which is 0..1 (up to 45 degrees), and
+// mirrors that into the right octant.
+FixedTrig::Angle FixedTrig::atan2(int32_t y, int32_t x)
+{
+  uint32_t absX = (x < 0) ? -(uint32_t)x : (uint32_t)x;
+  uint32_t absY = (y < 0) ? -(uint32_t)y : (uint32_t)y;
+  bool steep = absY > absX;
+  uint32_t small = steep ? absX : absY;
+  uint32_t large = steep ? absY : absX;
+  if (large == 0)
+  {
+    return 0;
+  }
+
+  // The ratio is worked out in 16 bits, 8 for the table step and 8 within it, from a
+  // larger value of 16 bits
+  uint8_t shift = 0;
+  while ((large >> shift) >= (1UL << 16))
+  {
+    shift++;
+  }
+  if (shift > 0)
+  {
+    // Rounded, or the ratio is off by up to one in 2^15
+    large = (large >> shift) + ((large >> (shift - 1)) & 1);
+    small = (small >> shift) + ((small >> (shift - 1)) & 1);
+  }
+  while (large < (1UL << 15))
+  {
+    large <<= 1;
+    small <<= 1;
+  }
+  // Rounding can take both up to 2^16, which must not be shifted
+  uint32_t ratio = (small == large) ? (1UL << 16) : ((small << 16) + (large >> 1)) / large;
+  uint16_t index = ratio >> 8;
+  int32_t deviation = (int32_t)pgm_read_word(&arctangentTable[index]) << 8;
+  if (index < 256)
+  {
+    int16_t step = pgm_read_word(&arctangentTable[index + 1]) - pgm_read_word(&arctangentTable[index]);
+    deviation += (int32_t)step * (ratio & 0xFF);
+  }
+
+  // 45 degrees is an eighth of 2^32, 2^29
+  Angle angle = (ratio << 13) + (deviation << 2);
+  if (steep)
+  {
+    angle = QUARTER_TURN - angle;
+  }
+  if (x < 0)
+  {
+    angle = HALF_TURN - angle;
+  }
+  return (y < 0) ? -angle : angle;
+}
+
+uint16_t FixedTrig::sqrt(uint32_t value)
+{
+  uint32_t root = 0;
+  uint32_t bit = 1UL << 30;
+  while (bit > value)
+  {
+    bit >>= 2;
+  }
+  while (bit != 0)
+  {
+    if (value >= root + bit)
+    {
+      value -= root + bit;
+      root = (root >> 1) + bit;
+    }
+    else
+    {
+      root >>= 1;
+    }
+    bit >>= 2;
+  }
+  return root;
+}
+
+// A full turn is 1296000 arcseconds. The float multiplication keeps 24 bits, about 0.1 arcseconds.
+FixedTrig::Angle FixedTrig::fromArcSeconds(long arcSeconds)
+{
+  arcSeconds %= 1296000L;
+  if (arcSeconds < 0)
+  {
+    arcSeconds += 1296000L;
+  }
+  return (Angle)(arcSeconds * (4294967296.0f / 1296000.0f));
+}
+
+FixedTrig::Angle FixedTrig::fromDegrees(float degrees)
+{
+  degrees = fmod(degrees, 360.0f);
+  if (degrees < 0)
+  {
+    degrees += 360.0f;
+  }
+  return (Angle)(degrees * (4294967296.0f / 360.0f));
+}
+
+long FixedTrig::toArcSeconds(Angle angle)
+{
+  return lround((int32_t)angle * (1296000.0f / 4294967296.0f));
+}
+
+float FixedTrig::toDegrees(Angle angle)
+{
+  return (int32_t)angle * (360.0f / 4294967296.0f);
+}
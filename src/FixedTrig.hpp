@@ -0,0 +1,41 @@
+#pragma once
+
+#include "inc/Globals.hpp"
+
+// Trigonometry in fixed point, for pointing math on boards without an FPU.
+//
+// Angles are binary: a full turn is 2^32, so they wrap by themselves and one unit is
+// 0.0003 arcseconds. Sines and cosines are Q15 (32767 is 1.0), interpolated from a quarter
+// wave table in PROGMEM, and are within 1 of the exact value (about 6 arcseconds). atan2()
+// interpolates an arctangent table the same way and is within 2 arcseconds of the angle of
+// inputs of up to 16 bits, and 4 arcseconds of larger ones.
+//
+// Estimated AVR cycles, counted from the operations (a float sin() or atan2() from avr-libc
+// takes well over a thousand):
+//   sin(), cos()   ~100   two table reads and one 16x16 bit multiplication
+//   atan2()        ~800   mostly one 32 bit division
+//   sqrt()         ~450   16 rounds of shift and subtract
+class FixedTrig
+{
+public:
+  typedef uint32_t Angle;
+
+  static const Angle QUARTER_TURN = 0x40000000UL;
+  static const Angle HALF_TURN = 0x80000000UL;
+
+  // Q15 sine and cosine, -32767..32767
+  static int16_t sin(Angle angle);
+  static int16_t cos(Angle angle) { return sin(angle + QUARTER_TURN); }
+
+  // Angle of the vector (x, y) from the x axis, like atan2(y, x). Read as an int32_t it is -180..180 degrees.
+  static Angle atan2(int32_t y, int32_t x);
+
+  // Square root, rounded down
+  static uint16_t sqrt(uint32_t value);
+
+  static Angle fromArcSeconds(long arcSeconds);
+  static Angle fromDegrees(float degrees);
+  // -180..180 degrees (-648000..648000 arcseconds)
+  static long toArcSeconds(Angle angle);
+  static float toDegrees(Angle angle);
+};
@@ -0,0 +1,167 @@
+#include "../Configuration.hpp"
+#include "Utility.hpp"
+#include "Mount.hpp"
+#include "GuidePort.hpp"
+
+// Edges waiting for loop(). A power of 2, so the indices wrap with a mask.
+#define EDGE_QUEUE_SIZE 8
+
+struct GuidePortEdge {
+  unsigned long at;   // micros()
+  byte lines;         // The lines that are active after it
+};
+
+// Written by the interrupt at the head, read by loop() at the tail. When the queue is full the
+// interrupt drops the edge, and loop() catches up from the pins.
+static volatile GuidePortEdge _edges[EDGE_QUEUE_SIZE];
+static volatile byte _edgeHead = 0;
+static volatile byte _edgeTail = 0;
+static volatile byte _queuedLines = 0;
+
+#if USE_GUIDE_PORT == 1
+
+#ifndef IRAM_ATTR
+  #define IRAM_ATTR   // Only the ESP32 needs the interrupt code in IRAM
+#endif
+
+static byte IRAM_ATTR readLines()
+{
+  return ((digitalRead(GUIDE_PORT_NORTH_PIN) == LOW) ? NORTH : 0)
+    | ((digitalRead(GUIDE_PORT_EAST_PIN) == LOW) ? EAST : 0)
+    | ((digitalRead(GUIDE_PORT_SOUTH_PIN) == LOW) ? SOUTH : 0)
+    | ((digitalRead(GUIDE_PORT_WEST_PIN) == LOW) ? WEST : 0);
+}
+
+static void IRAM_ATTR onPinChange()
+{
+  byte lines = readLines();
+  if (lines == _queuedLines) {
+    return;   // Another pin of the same port changed
+  }
+  byte next = (_edgeHead + 1) & (EDGE_QUEUE_SIZE - 1);
+  if (next == _edgeTail) {
+    return;
+  }
+  _edges[_edgeHead].at = micros();
+  _edges[_edgeHead].lines = lines;
+  _edgeHead = next;
+  _queuedLines = lines;
+}
+
+#if defined(__AVR_ATmega2560__)
+
+// SoftwareSerial uses the same vectors, see the configuration check
+ISR(PCINT0_vect) { onPinChange(); }
+ISR(PCINT1_vect, ISR_ALIASOF(PCINT0_vect));
+ISR(PCINT2_vect, ISR_ALIASOF(PCINT0_vect));
+
+static void enableInterrupt(byte pin)
+{
+  *digitalPinToPCMSK(pin) |= bit(digitalPinToPCMSKbit(pin));
+  PCICR |= bit(digitalPinToPCICRbit(pin));
+}
+
+#else
+
+// ESP32, and the pin model of the host build
+static void enableInterrupt(byte pin)
+{
+  attachInterrupt(digitalPinToInterrupt(pin), onPinChange, CHANGE);
+}
+
+#endif
+
+#else
+
+static byte readLines()
+{
+  return 0;
+}
+
+#endif
+
+GuidePort::GuidePort(Mount* mount)
+{
+  _mount = mount;
+  _started = false;
+  _lines = 0;
+  _raDirection = 0;
+  _decDirection = 0;
+  _raStartedAt = 0;
+  _decStartedAt = 0;
+}
+
+void GuidePort::begin()
+{
+#if USE_GUIDE_PORT == 1
+  LOGV1(DEBUG_INFO, F("GuidePort: Starting ST-4 guide port"));
+  const byte pins[] = { GUIDE_PORT_NORTH_PIN, GUIDE_PORT_EAST_PIN, GUIDE_PORT_SOUTH_PIN, GUIDE_PORT_WEST_PIN };
+  for (byte i = 0; i < 4; i++) {
+    pinMode(pins[i], INPUT_PULLUP);
+  }
+  _edgeHead = _edgeTail;
+  _queuedLines = readLines();
+  _lines = _queuedLines;
+  for (byte i = 0; i < 4; i++) {
+    enableInterrupt(pins[i]);
+  }
+  _started = true;
+#endif
+}
+
+void GuidePort::loop()
+{
+  if (!_started) {
+    return;
+  }
+
+  while (_edgeTail != _edgeHead) {
+    GuidePortEdge edge;
+    noInterrupts();
+    edge.at = _edges[_edgeTail].at;
+    edge.lines = _edges[_edgeTail].lines;
+    interrupts();
+    _edgeTail = (_edgeTail + 1) & (EDGE_QUEUE_SIZE - 1);
+    apply(edge.lines, edge.at);
+  }
+
+  // Edges the full queue dropped
+  byte lines = readLines();
+  if (lines != _lines) {
+    LOGV3(DEBUG_MOUNT, F("GuidePort: Lines are %d, not %d. Missed an edge."), lines, _lines);
+    apply(lines, micros());
+  }
+}
+
+void GuidePort::apply(byte lines, unsigned long at)
+{
+  byte changed = lines ^ _lines;
+  _lines = lines;
+
+  // Released lines first, so a guider that goes straight from one direction to the other ends the first pulse
+  if ((changed & (EAST | WEST)) && (_raDirection != 0) && !(lines & _raDirection)) {
+    LOGV3(DEBUG_MOUNT, F("GuidePort: RA line %d released after %lms"), _raDirection, (at - _raStartedAt) / 1000);
+    _mount->endGuidePortPulse(_raDirection, at - _raStartedAt);
+    _raDirection = 0;
+  }
+  if ((changed & (NORTH | SOUTH)) && (_decDirection != 0) && !(lines & _decDirection)) {
+    LOGV3(DEBUG_MOUNT, F("GuidePort: DEC line %d released after %lms"), _decDirection, (at - _decStartedAt) / 1000);
+    _mount->endGuidePortPulse(_decDirection, at - _decStartedAt);
+    _decDirection = 0;
+  }
+
+  if (!_mount->isSlewingTRK() || _mount->isSlewingRAorDEC()) {
+    return;
+  }
+  byte started = changed & lines;
+  if (started & (EAST | WEST)) {
+    _raDirection = (started & WEST) ? WEST : EAST;
+    _raStartedAt = at;
+    _mount->startGuidePortPulse(_raDirection);
+  }
+  if (started & (NORTH | SOUTH)) {
+    _decDirection = (started & NORTH) ? NORTH : SOUTH;
+    _decStartedAt = at;
+    _mount->startGuidePortPulse(_decDirection);
+  }
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "inc/Globals.hpp"
+
+// Forward declarations
+class Mount;
+
+//////////////////////////////////////
+// Guides the mount from the ST-4 port of an autoguider, without going through the serial port.
+//
+// The four lines (GUIDE_PORT_WEST_PIN etc.) are active low. A pin interrupt (pin change interrupts
+// on the ATmega, GPIO interrupts on the ESP32) queues every change of them with the micros() it
+// happened at. Mount::loop() takes them from the queue and starts a guide pulse when a line goes
+// active. When it goes inactive, the pulse gets the length between the two edges, so it moves the
+// mount as far as the guider asked, however late the loop got to the edges.
+// Lines are only taken while the mount tracks and does not slew.
+//////////////////////////////////////
+class GuidePort
+{
+public:
+  GuidePort(Mount* mount);
+
+  // Sets up the pins and their interrupt. Called from setup() when USE_GUIDE_PORT is 1.
+  void begin();
+
+  // Applies the queued edges. Called from Mount::loop().
+  void loop();
+
+  // The lines that are active (NORTH, EAST etc.), as the last applied edge left them
+  byte activeLines() const { return _lines; }
+
+private:
+  void apply(byte lines, unsigned long at);
+
+  Mount* _mount;
+  bool _started;
+  byte _lines;
+  byte _raDirection;            // The line that started the running RA pulse, 0 if none
+  byte _decDirection;
+  unsigned long _raStartedAt;   // micros() of its edge
+  unsigned long _decStartedAt;
+};
@@ -0,0 +1,69 @@
+#include "../Configuration.hpp"
+#include "Utility.hpp"
+#include "GuideStatistics.hpp"
+
+GuideStatistics::GuideStatistics()
+{
+  clear();
+}
+
+void GuideStatistics::clear()
+{
+  _startedAt = 0;
+  _pulses = 0;
+  _raPulses = 0;
+  _decPulses = 0;
+  _raTotal = 0;
+  _decTotal = 0;
+  _raSquares = 0;
+  _decSquares = 0;
+}
+
+void GuideStatistics::addRA(float arcseconds)
+{
+  if (_pulses == 0) {
+    _startedAt = millis();
+  }
+  _pulses++;
+  _raPulses++;
+  _raTotal += arcseconds;
+  _raSquares += arcseconds * arcseconds;
+}
+
+void GuideStatistics::addDEC(float arcseconds)
+{
+  if (_pulses == 0) {
+    _startedAt = millis();
+  }
+  _pulses++;
+  _decPulses++;
+  _decTotal += arcseconds;
+  _decSquares += arcseconds * arcseconds;
+}
+
+float GuideStatistics::seconds() const
+{
+  return (_pulses == 0) ? 0.0f : (millis() - _startedAt) / 1000.0f;
+}
+
+float GuideStatistics::raRMS() const
+{
+  return (_raPulses == 0) ? 0.0f : sqrt(_raSquares / _raPulses);
+}
+
+float GuideStatistics::decRMS() const
+{
+  return (_decPulses == 0) ? 0.0f : sqrt(_decSquares / _decPulses);
+}
+
+float GuideStatistics::raDrift() const
+{
+  float elapsed = seconds();
+  return (elapsed < 1.0f) ? 0.0f : _raTotal / elapsed;
+}
+
+float GuideStatistics::decDrift() const
+{
+  float elapsed = seconds();
+  return (elapsed < 1.0f) ? 0.0f : _decTotal / elapsed;
+}
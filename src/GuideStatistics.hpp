@@ -0,0 +1,45 @@
+#pragma once
+
+//////////////////////////////////////
+// Adds up the guide pulses a guider sends while the mount tracks.
+//
+// Each pulse is counted as the arcseconds it asks its axis to move. RA is counted as what it
+// adds to tracking, so a guider that keeps pushing west says that the mount tracks too slowly.
+// The totals give the RMS of the corrections and how fast each axis drifts, over the time
+// since the statistics were cleared.
+//////////////////////////////////////
+class GuideStatistics
+{
+public:
+  GuideStatistics();
+
+  // Forgets all pulses, and starts the session at the next one
+  void clear();
+
+  // Counts a pulse that moves RA or DEC by the given arcseconds
+  void addRA(float arcseconds);
+  void addDEC(float arcseconds);
+
+  unsigned int pulses() const { return _pulses; }
+
+  // Seconds from the first pulse after clear()
+  float seconds() const;
+
+  // The RMS of the pulses of an axis, in arcseconds
+  float raRMS() const;
+  float decRMS() const;
+
+  // How many arcseconds per second the guider had to correct on average, net
+  float raDrift() const;
+  float decDrift() const;
+
+private:
+  unsigned long _startedAt;         // millis() of the first pulse
+  unsigned int _pulses;
+  unsigned int _raPulses;
+  unsigned int _decPulses;
+  float _raTotal;                   // Net arcseconds
+  float _decTotal;
+  float _raSquares;                 // Sum of the squares of the arcseconds
+  float _decSquares;
+};
@@ -1,5 +1,6 @@
 #include "../Configuration.hpp"
 #include "Utility.hpp"
+#include "FixedTrig.hpp"
 #include "Gyro.hpp"
 
 #if USE_GYRO_LEVEL == 1
@@ -88,9 +89,11 @@ angle_t Gyro::getCurrentAngles()
         int16_t AcZ = Wire.read() << 8 | Wire.read(); // Z-axis value
 
         // Calculating the Pitch angle (rotation around Y-axis)
-        result.pitchAngle += ((atan(-1 * AcX / sqrt(pow(AcY, 2) + pow(AcZ, 2))) * 180.0 / PI) * 2.0) / 2.0;
+        uint16_t acYZ = FixedTrig::sqrt((uint32_t)((long)AcY * AcY) + (long)AcZ * AcZ);
+        result.pitchAngle += FixedTrig::toDegrees(FixedTrig::atan2(-(long)AcX, acYZ));
         // Calculating the Roll angle (rotation around X-axis)
-        result.rollAngle += ((atan(-1 * AcY / sqrt(pow(AcX, 2) + pow(AcZ, 2))) * 180.0 / PI) * 2.0) / 2.0;
+        uint16_t acXZ = FixedTrig::sqrt((uint32_t)((long)AcX * AcX) + (long)AcZ * AcZ);
+        result.rollAngle += FixedTrig::toDegrees(FixedTrig::atan2(-(long)AcY, acXZ));
 
         delay(10);  // Decorrelate measurements
     }
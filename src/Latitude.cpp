@@ -5,14 +5,6 @@
 //////////////////////////////////////////////////////////////////////////////////////
 //
 // 90 is north pole, -90 is south pole
-Latitude::Latitude(const Latitude &other) : DayTime(other)
-{
-}
-
-Latitude::Latitude(int h, int m, int s) : DayTime(h, m, s)
-{
-}
-
 Latitude::Latitude(float inDegrees) : DayTime(inDegrees)
 {
 }
@@ -31,15 +23,21 @@ void Latitude::checkHours()
   }
 }
 
-Latitude Latitude::ParseFromMeade(String const& s)
+DayTime::ParseResult Latitude::ParseFromMeade(const char *s, Latitude &result)
 {
-  Latitude result(0.0);
-
-  LOGV2(DEBUG_GENERAL, F("Latitude.Parse(%s)"), s.c_str());
+  LOGV2(DEBUG_GENERAL, F("Latitude.Parse(%s)"), s);
   // Use the DayTime code to parse it.
-  DayTime dt = DayTime::ParseFromMeade(s);
+  DayTime dt;
+  ParseResult error = DayTime::ParseFromMeade(s, dt);
+  if (error != PARSE_OK)
+  {
+    return error;
+  }
+  if (abs(dt.getTotalSeconds()) > 90L * 3600L)
+  {
+    return PARSE_OUT_OF_RANGE;
+  }
   result.totalSeconds = dt.getTotalSeconds();
-  result.checkHours();
-  LOGV3(DEBUG_GENERAL, F("Latitude.Parse(%s) -> %s"), s.c_str(), result.ToString());
-  return result;
+  LOGV3(DEBUG_GENERAL, F("Latitude.Parse(%s) -> %s"), s, result.ToString());
+  return PARSE_OK;
 }
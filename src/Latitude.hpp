@@ -6,13 +6,20 @@
 class Latitude : public DayTime
 {
 public:
-  Latitude() : DayTime() {}
-  Latitude(const Latitude &other);
-  Latitude(int h, int m, int s);
+  constexpr Latitude() : DayTime() {}
+  constexpr Latitude(int h, int m, int s) : DayTime(h, m, s) {}
   Latitude(float inDegrees);
 
-  static Latitude ParseFromMeade(String const& s);
+  static ParseResult ParseFromMeade(const char *s, Latitude &result);
+
+  // These would wrap it like a time
+  void set(int, int, int) = delete;
+  void addHours(int) = delete;
+  void addMinutes(int) = delete;
+  void addSeconds(long) = delete;
+  void addTime(const DayTime &) = delete;
+  void subtractTime(const DayTime &) = delete;
 
 protected:
-  virtual void checkHours() override;
+  void checkHours();
 };
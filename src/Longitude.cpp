@@ -6,14 +6,6 @@
 //
 // -180..180 range, 0 is at the prime meridian (through Greenwich), negative going west, positive going east
 
-Longitude::Longitude(const Longitude &other) : DayTime(other)
-{
-}
-
-Longitude::Longitude(int h, int m, int s) : DayTime(h, m, s)
-{
-}
-
 Longitude::Longitude(float inDegrees) : DayTime(inDegrees)
 {
 }
@@ -32,20 +24,28 @@ void Longitude::checkHours()
   }
 }
 
-Longitude Longitude::ParseFromMeade(String const& s)
+DayTime::ParseResult Longitude::ParseFromMeade(const char *s, Longitude &result)
 {
-  Longitude result(0.0);
-  LOGV2(DEBUG_GENERAL, F("Longitude.Parse(%s)"), s.c_str());
+  LOGV2(DEBUG_GENERAL, F("Longitude.Parse(%s)"), s);
 
   // Use the DayTime code to parse it.
-  DayTime dt = DayTime::ParseFromMeade(s);
+  DayTime dt;
+  ParseResult error = DayTime::ParseFromMeade(s, dt);
+  if (error != PARSE_OK)
+  {
+    return error;
+  }
+  if (abs(dt.getTotalSeconds()) > 360L * 3600L)
+  {
+    return PARSE_OUT_OF_RANGE;
+  }
 
   //from indilib driver:  Meade defines longitude as 0 to 360 WESTWARD (https://github.com/indilib/indi/blob/1b2f462b9c9b0f75629b635d77dc626b9d4b74a3/drivers/telescope/lx200driver.cpp#L1019)
   result.totalSeconds = 0 - dt.getTotalSeconds();
   result.checkHours();
 
-  LOGV4(DEBUG_GENERAL, F("Longitude.Parse(%s) -> %s = %ls"), s.c_str(), result.ToString(), result.getTotalSeconds());
-  return result;
+  LOGV4(DEBUG_GENERAL, F("Longitude.Parse(%s) -> %s = %ls"), s, result.ToString(), result.getTotalSeconds());
+  return PARSE_OK;
 }
 
 const char *Longitude::formatString(char *targetBuffer, const char *format, long *) const
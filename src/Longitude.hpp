@@ -6,16 +6,23 @@
 class Longitude : public DayTime
 {
 public:
-  Longitude() : DayTime() {}
-  Longitude(const Longitude &other);
-  Longitude(int h, int m, int s);
+  constexpr Longitude() : DayTime() {}
+  constexpr Longitude(int h, int m, int s) : DayTime(h, m, s) {}
   Longitude(float inDegrees);
 
-  virtual const char *formatString(char *targetBuffer, const char *format, long *pSeconds = nullptr) const;
+  const char *formatString(char *targetBuffer, const char *format, long *pSeconds = nullptr) const;
 
-  static Longitude ParseFromMeade(String const& s);
+  static ParseResult ParseFromMeade(const char *s, Longitude &result);
+
+  // These would wrap it like a time
+  void set(int, int, int) = delete;
+  void addHours(int) = delete;
+  void addMinutes(int) = delete;
+  void addSeconds(long) = delete;
+  void addTime(const DayTime &) = delete;
+  void subtractTime(const DayTime &) = delete;
 
 protected:
-  virtual void checkHours() override;
+  void checkHours();
 };
 
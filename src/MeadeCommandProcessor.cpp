@@ -6,6 +6,7 @@
 #include "MeadeCommandProcessor.hpp"
 #include "WifiControl.hpp"
 #include "Gyro.hpp"
+#include "Parameters.hpp"
 
 #if USE_GPS == 1
 bool gpsAqcuisitionComplete(int & indicator); // defined in c72_menuHA_GPS.hpp
@@ -77,23 +78,33 @@ bool gpsAqcuisitionComplete(int & indicator); // defined in c72_menuHA_GPS.hpp
 //
 // :Gd#
 //      Get Target Declination
-//      Returns: sDD*MM'SS#
+//      Returns: sDD*MM'SS#  (sDD*MM# in low precision, see :U#)
 //               Where s is + or -, DD is degrees, MM is minutes, SS is seconds.
 //
 // :GD#
 //      Get Current Declination
-//      Returns: sDD*MM'SS#
+//      Returns: sDD*MM'SS#  (sDD*MM# in low precision, see :U#)
 //               Where s is + or -, DD is degrees, MM is minutes, SS is seconds.
 //
 // :Gr#
 //      Get Target Right Ascension
-//      Returns: HH:MM:SS#
-//               Where HH is hour, MM is minutes, SS is seconds.
+//      Returns: HH:MM:SS#  (HH:MM.T# in low precision, see :U#)
+//               Where HH is hour, MM is minutes, SS is seconds, T is tenths of a minute.
 //
 // :GR#
 //      Get Current Right Ascension
-//      Returns: HH:MM:SS#
-//               Where HH is hour, MM is minutes, SS is seconds.
+//      Returns: HH:MM:SS#  (HH:MM.T# in low precision, see :U#)
+//               Where HH is hour, MM is minutes, SS is seconds, T is tenths of a minute.
+//
+// :GA#
+//      Get Current Altitude
+//      Returns: sDD*MM'SS#  (sDD*MM# in low precision, see :U#)
+//               Where s is + or -, DD is degrees above the horizon, MM is minutes, SS is seconds.
+//
+// :GZ#
+//      Get Current Azimuth
+//      Returns: DDD*MM'SS#  (DDD*MM# in low precision, see :U#)
+//               Where DDD is degrees from north through east, MM is minutes, SS is seconds.
 //
 // :Gt#
 //      Get Site Latitude
@@ -188,15 +199,17 @@ bool gpsAqcuisitionComplete(int & indicator); // defined in c72_menuHA_GPS.hpp
 // SET FAMILY
 //
 // :SdsDD*MM:SS#
+// :SdsDD*MM#
 //      Set Target Declination
 //      This sets the target DEC. Use a Movement command to slew there.
 //      Where s is + or -, DD is degrees, MM is minutes, SS is seconds.
 //      Returns: 1 if successfully set, otherwise 0
 //
 // :SrHH:MM:SS#
+// :SrHH:MM.T#
 //      Set Right Ascension
 //      This sets the target RA. Use a Movement command to slew there.
-//      Where HH is hours, MM is minutes, SS is seconds.
+//      Where HH is hours, MM is minutes, SS is seconds, T is tenths of a minute.
 //      Returns: 1 if successfully set, otherwise 0
 //
 // :StsDD*MM#
@@ -221,13 +234,14 @@ bool gpsAqcuisitionComplete(int & indicator); // defined in c72_menuHA_GPS.hpp
 //      Set Site Local Time
 //      This sets the local time of the timezone in which the mount is located.
 //      Where HH is hours, MM is minutes and SS is seconds.
-//      Returns: 1 
+//      Returns: 1 if successfully set, otherwise 0
 //
 // :SCMM/DD/YY#
 //      Set Site Date
 //      This sets the date
 //      Where HHMM is the month, DD is the day and YY is the year since 2000.
 //      Returns: 1Updating Planetary Data#                              # 
+//               or 0 if the month or day is out of range
 //
 // -- SET Extensions --
 // :SHHH:MM#
@@ -341,6 +355,15 @@ bool gpsAqcuisitionComplete(int & indicator); // defined in c72_menuHA_GPS.hpp
 //      Returns: nothing
 //
 //------------------------------------------------------------------
+// PRECISION TOGGLE FAMILY
+//
+// :U#
+//      Toggle precision
+//      This switches the coordinates returned by :Gr#, :GR#, :Gd# and :GD# between high 
+//      precision (the default, with seconds) and low precision (RA in tenths of a minute, DEC in minutes).
+//      Returns: nothing
+//
+//------------------------------------------------------------------
 // EXTRA OAT FAMILY - These are meant for the PC control app
 //
 // :XFR#
@@ -351,10 +374,21 @@ bool gpsAqcuisitionComplete(int & indicator); // defined in c72_menuHA_GPS.hpp
 // :XDnnn#
 //      Run drift alignment
 //      This runs a drift alignment procedure where the mounts slews east, pauses, slews west and pauses.
-//      Where nnn is the number of seconds the entire alignment should take. The call is blocking and will 
-//      only return once the drift alignment is complete.
+//      Where nnn is the number of seconds each pass should take, plus 3. The call returns right away, the
+//      mount runs the procedure by itself and tracks again when it is done (see :XDG).
 //      Returns: nothing
 //
+// :XDG#
+//      Get drift alignment status
+//      Returns: <state>,<seconds>#
+//      Where <state> is I (idle), P (pausing), E (east pass), W (west pass) or B (taking up backlash)
+//            <seconds> is about how long until it is done
+//
+// :XDX#
+//      Stop drift alignment
+//      Stops RA where it is and tracks again. Slewing, parking or :Q# stop it too.
+//      Returns: 1#
+//
 // :XL0#
 //      Turn off the Digital level
 //      Returns: 1# or 0# if there is no Digital Level
@@ -478,6 +512,127 @@ bool gpsAqcuisitionComplete(int & indicator); // defined in c72_menuHA_GPS.hpp
 //      Must be in manual slewing mode.
 //      Returns: nothing
 //
+// :XTG#
+//      Get guide statistics
+//      Adds up the guide pulses sent while tracking, since they were cleared.
+//      Returns: <pulses>,<seconds>,<raRMS>,<decRMS>,<raDrift>,<decDrift>,<auto>#
+//      Where <raRMS> and <decRMS> are the RMS of the pulses in arcseconds
+//            <raDrift> and <decDrift> are the net arcseconds per minute the pulses asked for (positive west and north)
+//            <auto> is 1 if the RA pulses correct the tracking speed calibration, else 0
+//
+// :XTC#
+//      Clear guide statistics
+//      Returns: 1#
+//
+// :XTAn#
+//      Set automatic tracking calibration
+//      Where n is 1 to correct the tracking speed calibration from how far the RA pulses move the mount (and store it), 0 to not.
+//      Returns: 1#
+//
+// :XRI#
+//      Get session log info
+//      Returns: <recording>,<start>,<end>,<time>,<ra>,<dec>,<trk>,<status>,<rate>,<ratetime>#
+//      Where <recording> is 1 while it records, 0 while paused
+//            <start> and <end> are the numbers of the bytes the log holds (counted from when it was cleared)
+//            <time> (in 10ms), <ra>, <dec>, <trk> (stepper positions) and <status> are the state the first byte starts from
+//            <rate> is the tracking rate (TRK steps per 1000s), and <trk> the TRK position at <ratetime> (in 10ms)
+//
+// :XRGnnn#
+//      Get session log bytes
+//      Returns: <offset>,<bytes>#
+//      Where <bytes> are up to 32 bytes in hex from byte number <offset>. This is nnn, or <start> if nnn was dropped.
+//
+// :XRC#
+//      Clear session log
+//      Returns: 1#
+//
+// :XRSn#
+//      Set session log recording
+//      Where n is 1 to record, 0 to pause (e.g. while downloading it)
+//      Returns: 1#
+//
+// :XOpnnn#
+//      Dither
+//      Moves the mount with guide pulses to the next offset of pattern p, at most nnn arcseconds from where the
+//      dithers started. Where p is R (random), S (square spiral) or C (back to the start, nnn is ignored).
+//      A slew or sync starts the dithers over.
+//      Returns: 1# if it is dithering, 0# if the mount is not tracking, is slewing or guiding, or p is unknown
+//
+// :XOG#
+//      Get dither status
+//      Returns: <settled>,<ra>,<dec>#
+//      Where <settled> is 1 once the guide pulses are done and the mount had time to settle, 0 before
+//            <ra> and <dec> are the offset from where the dithers started, in arcseconds on the sky
+//            (positive the way :Mge and :Mgn move)
+//
+// :XQAcvvv,ttt,sss,mmm#
+//      Add a target to the sequence
+//      Adds the current target (set with :Sr and :Sd) to the end of the sequence the mount runs by itself.
+//      Where c is the start condition and vvv its value:
+//              N - now (vvv is 0)
+//              T - at local time vvv, as HHMMSS
+//              A - once the target has risen to vvv degrees (-90 to 90)
+//              M - once the target is vvv minutes past the meridian (negative for before, up to 720 either way)
+//            ttt is how many seconds to track the target
+//            sss is the seconds between dithers (0 for none) and mmm how far they go in arcseconds (see :XO)
+//            ttt, sss and mmm are 0 to 65535
+//      Returns: 1# if it was added, 0# if the sequence is full, running or the command is malformed or out of range
+//
+// :XQEa#
+//      Set the end action of the sequence
+//      Where a is P to park after the last target or T to keep tracking it.
+//      Returns: 1#, or 0# for any other a
+//
+// :XQS#
+//      Start the sequence
+//      Returns: 1# if it started, 0# if it has no targets
+//
+// :XQX#
+//      Stop the sequence
+//      The mount keeps tracking.
+//      Returns: 1#
+//
+// :XQC#
+//      Clear the sequence
+//      Stops it and removes all targets.
+//      Returns: 1#
+//
+// :XQG#
+//      Get the sequence status
+//      Returns: <state>,<target>,<count>,<seconds>#
+//      Where <state> is I (idle), W (waiting for the start of the target), S (slewing), T (tracking) or D (done)
+//            <target> is the number of the current target from 1, <count> the number of targets
+//            <seconds> is how long the target has been waiting, or how much longer it tracks
+//
+// :XPL#
+//      List parameters
+//      Describes the parameters of the registry that this configuration has (see Parameters.hpp).
+//      Returns: <id>,<name>,<type>,<flags>,<min>,<max>;<id>,...#
+//      Where <type> is B (byte), S (16-bit integer), L (32-bit integer) or F (float)
+//            <flags> is P if setting it stores it in EEPROM, R if it is read-only, or nothing
+//
+// :XPGnn#
+//      Get parameter
+//      Where nn is the id of the parameter.
+//      Returns: <value>#, or E# if there is no such parameter (a value is always a number, so E# is never one)
+//
+// :XPSnn,vvv#
+//      Set parameter
+//      Where nn is the id of the parameter and vvv the value (an integer or a decimal number, by its type).
+//      Returns: 1# if it was applied, 0# if there is no such parameter, it is read-only or the value is out of range
+//
+// :XPR#
+//      Read parameter image
+//      Reads all parameters that can be set in one reply.
+//      Returns: hex digits, for each parameter 2 for its id and then its value least significant byte first
+//               (2 digits per byte, 8 for 32-bit integers and floats), then #
+//
+// :XPWhhh#
+//      Write parameter image
+//      Applies the parameters in (a part of) an image from :XPR, in the order given. An image is longer than a 
+//      command can be, so send it as several commands of whole parameters.
+//      Returns: 1# if all were applied, 0# after the first that could not be
+//
 /////////////////////////////////////////////////////////////////////////////////////////
 
 MeadeCommandProcessor* MeadeCommandProcessor::_instance = nullptr;
@@ -505,6 +660,9 @@ MeadeCommandProcessor::MeadeCommandProcessor(Mount* mount, LcdMenu* lcdMenu) {
 
   // In case of DISPLAY_TYPE_NONE mode, the lcdMenu is just an empty shell class to save having to null check everywhere
   _lcdMenu = lcdMenu;
+
+  // LX200 mounts start up in high precision
+  _highPrecision = true;
 }
 
 /////////////////////////////
@@ -519,6 +677,17 @@ String MeadeCommandProcessor::handleMeadeInit(String inCmd) {
   return "";
 }
 
+/////////////////////////////
+// Writes the value as the given number of digits, with leading zeros. Returns where it ended.
+/////////////////////////////
+static char *printDigits(char *p, unsigned int value, byte digits) {
+  for (byte i = digits; i > 0; i--) {
+    p[i - 1] = '0' + value % 10;
+    value /= 10;
+  }
+  return p + digits;
+}
+
 /////////////////////////////
 // GET INFO
 /////////////////////////////
@@ -537,16 +706,39 @@ String MeadeCommandProcessor::handleMeadeGetInfo(String inCmd) {
     }
     break;
 
-    case 'r': return _mount->RAString(MEADE_STRING | TARGET_STRING); // returns trailing #
+    case 'r': return _mount->RAString(MEADE_STRING | TARGET_STRING | precisionString()); // returns trailing #
 
-    case 'd': return _mount->DECString(MEADE_STRING | TARGET_STRING); // returns trailing #
+    case 'd': return _mount->DECString(MEADE_STRING | TARGET_STRING | precisionString()); // returns trailing #
 
-    case 'R': return _mount->RAString(MEADE_STRING | CURRENT_STRING); // returns trailing #
+    case 'R': return _mount->RAString(MEADE_STRING | CURRENT_STRING | precisionString()); // returns trailing #
 
-    case 'D': return _mount->DECString(MEADE_STRING | CURRENT_STRING); // returns trailing #
+    case 'D': return _mount->DECString(MEADE_STRING | CURRENT_STRING | precisionString()); // returns trailing #
 
     case 'X': return _mount->getStatusString() + "#";
 
+    case 'A':
+    case 'Z':
+    {
+      // sDD*MM'SS# for the altitude, DDD*MM'SS# for the azimuth
+      long altitude, azimuth;
+      _mount->currentAltAz(altitude, azimuth);
+      char *p = achBuffer;
+      if (cmdOne == 'A') {
+        *p++ = (altitude < 0) ? '-' : '+';
+      }
+      unsigned long arcSeconds = labs((cmdOne == 'A') ? altitude : azimuth);
+      p = printDigits(p, (arcSeconds / 3600) % 1000, (cmdOne == 'A') ? 2 : 3);
+      *p++ = '*';
+      p = printDigits(p, (arcSeconds / 60) % 60, 2);
+      if (_highPrecision) {
+        *p++ = '\'';
+        p = printDigits(p, arcSeconds % 60, 2);
+      }
+      *p++ = '#';
+      *p = '\0';
+      return String(achBuffer);
+    }
+
     case 'I':
     {
       String retVal = "";
@@ -656,13 +848,14 @@ String MeadeCommandProcessor::handleMeadeSyncControl(String inCmd) {
 // SET INFO
 /////////////////////////////
 String MeadeCommandProcessor::handleMeadeSetInfo(String inCmd) {
-  if ((inCmd[0] == 'd') && (inCmd.length() == 10)) {
-    // Set DEC
+  if (inCmd[0] == 'd') {
+    // Set DEC (the seconds are left off in low precision)
     //   0123456789
     // :Sd+84*03:02
-    if (((inCmd[4] == '*') || (inCmd[4] == ':')) && (inCmd[7] == ':'))
+    // :Sd+84*03
+    Declination dec;
+    if (Declination::ParseFromMeade(inCmd.c_str() + 1, dec) == DayTime::PARSE_OK)
     {
-      Declination dec = Declination::ParseFromMeade(inCmd.substring(1));
       _mount->targetDEC() = dec;
       LOGV2(DEBUG_MEADE, F("MEADE: SetInfo: Received Target DEC: %s"), _mount->targetDEC().ToString());
       return "1";
@@ -672,14 +865,16 @@ String MeadeCommandProcessor::handleMeadeSetInfo(String inCmd) {
       return "0";
     }
   }
-  else if (inCmd[0] == 'r' && (inCmd.length() == 9)) {
+  else if (inCmd[0] == 'r') {
     // :Sr11:04:57#
-    // Set RA
+    // Set RA (in low precision the seconds are given as tenths of a minute)
     //   012345678
     // :Sr04:03:02
-    if ((inCmd[3] == ':') && (inCmd[6] == ':'))
+    // :Sr04:03.5
+    DayTime ra;
+    if ((DayTime::ParseFromMeade(inCmd.c_str() + 1, ra) == DayTime::PARSE_OK) && (ra.getTotalSeconds() >= 0) && (ra.getTotalSeconds() < 24L * 3600L))
     {
-      _mount->targetRA().set(inCmd.substring(1, 3).toInt(), inCmd.substring(4, 6).toInt(), inCmd.substring(7, 9).toInt());
+      _mount->targetRA().set(ra);
       LOGV2(DEBUG_MEADE, F("MEADE: SetInfo: Received Target RA: %s"), _mount->targetRA().ToString());
       return "1";
     }
@@ -721,24 +916,35 @@ String MeadeCommandProcessor::handleMeadeSetInfo(String inCmd) {
     // Sync RA, DEC - current position is the given coordinate
     //   0123456789012345678
     // :SY+84*03:02.18:34:12
-    if (((inCmd[4] == '*') || (inCmd[4] == ':')) && (inCmd[7] == ':') && (inCmd[10] == '.') && (inCmd[13] == ':') && (inCmd[16] == ':')) {
-      Declination dec = Declination::ParseFromMeade(inCmd.substring(1, 9));
-      DayTime ra = DayTime::ParseFromMeade(inCmd.substring(11));
+    if (inCmd[10] == '.') {
+      char achDEC[10];
+      memcpy(achDEC, inCmd.c_str() + 1, 9);
+      achDEC[9] = '\0';
 
-      _mount->syncPosition(ra, dec);
-      return "1";
+      Declination dec;
+      DayTime ra;
+      if ((Declination::ParseFromMeade(achDEC, dec) == DayTime::PARSE_OK) && (DayTime::ParseFromMeade(inCmd.c_str() + 11, ra) == DayTime::PARSE_OK)) {
+        _mount->syncPosition(ra, dec);
+        return "1";
+      }
     }
     return "0";
   }
   else if ((inCmd[0] == 't')) // latitude: :St+30*29#
   {
-    Latitude lat = Latitude::ParseFromMeade(inCmd.substring(1));
+    Latitude lat;
+    if (Latitude::ParseFromMeade(inCmd.c_str() + 1, lat) != DayTime::PARSE_OK) {
+      return "0";
+    }
     _mount->setLatitude(lat);
     return "1";
   }
   else if (inCmd[0] == 'g') // longitude :Sg097*34#
   {
-    Longitude lon = Longitude::ParseFromMeade(inCmd.substring(1));
+    Longitude lon;
+    if (Longitude::ParseFromMeade(inCmd.c_str() + 1, lon) != DayTime::PARSE_OK) {
+      return "0";
+    }
     
      _mount->setLongitude(lon);
      return "1";
@@ -751,13 +957,22 @@ String MeadeCommandProcessor::handleMeadeSetInfo(String inCmd) {
   }
   else if (inCmd[0] == 'L') // Local time :SL19:33:03#
   {
-    _mount->setLocalStartTime( DayTime::ParseFromMeade( inCmd.substring( 1 ) ) );
+    DayTime localTime;
+    if ((DayTime::ParseFromMeade(inCmd.c_str() + 1, localTime) != DayTime::PARSE_OK) || (localTime.getTotalSeconds() < 0)
+        || (localTime.getTotalSeconds() >= 24L * 3600L)) {
+      return "0";
+    }
+    _mount->setLocalStartTime(localTime);
     return "1";
   }
   else if (inCmd[0] == 'C') { // Set Date (MM/DD/YY) :SC04/30/20#
     int month = inCmd.substring( 1, 3 ).toInt();
     int day = inCmd.substring( 4, 6 ).toInt();
     int year = 2000 + inCmd.substring( 7, 9 ).toInt();
+    if ((month < 1) || (month > 12) || (day < 1) || (day > 31)) {
+      // The sidereal time calculation indexes the days in each month by this
+      return "0";
+    }
     _mount->setLocalStartDate( year, month,day );
 
     /*
@@ -877,29 +1092,17 @@ String MeadeCommandProcessor::handleMeadeExtraCommands(String inCmd) {
   //   0123
   // :XDmmm
   if (inCmd[0] == 'D') {  // Drift Alignemnt
-    int duration = inCmd.substring(1, 4).toInt() - 3;
-    _lcdMenu->setCursor(0, 0);
-    _lcdMenu->printMenu(">Drift Alignment");
-    _lcdMenu->setCursor(0, 1);
-    _lcdMenu->printMenu("Pause 1.5s....");
-    _mount->stopSlewing(ALL_DIRECTIONS | TRACKING);
-    _mount->waitUntilStopped(ALL_DIRECTIONS);
-    _mount->delay(1500);
-    _lcdMenu->setCursor(0, 1);
-    _lcdMenu->printMenu("Eastward pass...");
-    _mount->runDriftAlignmentPhase(EAST, duration);
-    _lcdMenu->setCursor(0, 1);
-    _lcdMenu->printMenu("Pause 1.5s....");
-    _mount->delay(1500);
-    _lcdMenu->printMenu("Westward pass...");
-    _mount->runDriftAlignmentPhase(WEST, duration);
-    _lcdMenu->setCursor(0, 1);
-    _lcdMenu->printMenu("Pause 1.5s....");
-    _mount->delay(1500);
-    _lcdMenu->printMenu("Reset _mount->..");
-    _mount->runDriftAlignmentPhase(0, duration);
-    _lcdMenu->setCursor(0, 1);
-    _mount->startSlewing(TRACKING);
+    DriftAlignment& driftAlignment = _mount->driftAlignment();
+    if (inCmd[1] == 'G') {
+      char scratchBuffer[16];
+      sprintf(scratchBuffer, "%c,%ld#", driftAlignment.state(), driftAlignment.secondsLeft());
+      return String(scratchBuffer);
+    }
+    else if (inCmd[1] == 'X') {
+      driftAlignment.stop();
+      return "1#";
+    }
+    driftAlignment.start(inCmd.substring(1, 4).toInt() - 3);
   }
     else if (inCmd[0] == 'G') { // Get RA/DEC steps/deg, speedfactor
     if (inCmd[1] == 'R') {
@@ -999,6 +1202,191 @@ String MeadeCommandProcessor::handleMeadeExtraCommands(String inCmd) {
     #endif
     return String("0#");
   }
+  else if (inCmd[0] == 'T') { // Guide statistics
+    GuideStatistics& statistics = _mount->guideStatistics();
+    if (inCmd[1] == 'G') {
+      return String(statistics.pulses()) + "," + String(statistics.seconds(), 0) + ","
+        + String(statistics.raRMS(), 2) + "," + String(statistics.decRMS(), 2) + ","
+        + String(statistics.raDrift() * 60.0f, 2) + "," + String(statistics.decDrift() * 60.0f, 2) + ","
+        + (_mount->isTrackingAutoCalibration() ? "1#" : "0#");
+    }
+    else if (inCmd[1] == 'C') {
+      statistics.clear();
+      return "1#";
+    }
+    else if (inCmd[1] == 'A') {
+      _mount->setTrackingAutoCalibration(inCmd[2] == '1');
+      return "1#";
+    }
+    return "0#";
+  }
+  else if (inCmd[0] == 'R') { // Session log
+    SessionLog& log = _mount->sessionLog();
+    if (inCmd[1] == 'I') {
+      unsigned long tick;
+      long ra, dec, trk;
+      int status;
+      unsigned long rate, rateTick;
+      log.getStart(tick, ra, dec, trk, status, rate, rateTick);
+      char scratchBuffer[128];
+      sprintf(scratchBuffer, "%d,%lu,%lu,%lu,%ld,%ld,%ld,%d,%lu,%lu#", log.isRecording() ? 1 : 0, log.start(), log.end(), tick, ra, dec, trk,
+              status, rate, rateTick);
+      return String(scratchBuffer);
+    }
+    else if (inCmd[1] == 'G') {
+      unsigned long offset = strtoul(inCmd.c_str() + 2, nullptr, 10);
+      byte bytes[32];
+      byte length = log.read(offset, bytes, sizeof(bytes));
+      char scratchBuffer[12 + 2 * sizeof(bytes) + 2];
+      char* p = scratchBuffer + sprintf(scratchBuffer, "%lu,", offset);
+      for (byte i = 0; i < length; i++) {
+        p += sprintf(p, "%02X", bytes[i]);
+      }
+      strcpy(p, "#");
+      return String(scratchBuffer);
+    }
+    else if (inCmd[1] == 'C') {
+      log.clear();
+      return "1#";
+    }
+    else if (inCmd[1] == 'S') {
+      log.setRecording(inCmd[2] == '1');
+      return "1#";
+    }
+    return "0#";
+  }
+  else if (inCmd[0] == 'O') { // Dither
+    if (inCmd[1] == 'G') {
+      float ra, dec;
+      _mount->getDitherOffset(ra, dec);
+      char scratchBuffer[24];
+      sprintf(scratchBuffer, "%d,%ld,%ld#", _mount->isDitherSettled() ? 1 : 0, lround(ra), lround(dec));
+      return String(scratchBuffer);
+    }
+    return _mount->dither(inCmd[1], inCmd.substring(2).toInt()) ? "1#" : "0#";
+  }
+  else if (inCmd[0] == 'Q') { // Sequence
+    Sequencer& sequencer = _mount->sequencer();
+    if (inCmd[1] == 'A') {
+      //   0123456
+      // :XQAcvvv,ttt,sss,mmm
+      SequenceTarget target;
+      target.ra = _mount->targetRA();
+      target.dec = _mount->targetDEC();
+      target.startCondition = inCmd[2];
+      const char* field = inCmd.c_str() + 3;
+      char* end;
+      long values[4];
+      for (byte i = 0; i < 4; i++) {
+        values[i] = strtol(field, &end, 10);
+        if ((end == field) || (*end != ((i < 3) ? ',' : '\0'))) {
+          return "0#";
+        }
+        field = end + 1;
+      }
+      // The times and the dithers are held in 16 bits
+      for (byte i = 1; i < 4; i++) {
+        if ((values[i] < 0) || (values[i] > 65535L)) {
+          return "0#";
+        }
+      }
+      switch (target.startCondition) {
+        case SEQUENCE_START_NOW:
+          break;
+
+        case SEQUENCE_START_AT_TIME:
+          if ((values[0] < 0) || (values[0] / 10000 > 23) || ((values[0] / 100) % 100 > 59) || (values[0] % 100 > 59)) {
+            return "0#";
+          }
+          values[0] = (values[0] / 10000) * 3600L + ((values[0] / 100) % 100) * 60L + values[0] % 100;
+          break;
+
+        case SEQUENCE_START_ALTITUDE:
+          if ((values[0] < -90) || (values[0] > 90)) {
+            return "0#";
+          }
+          break;
+
+        case SEQUENCE_START_MERIDIAN:
+          if ((values[0] < -720) || (values[0] > 720)) {
+            return "0#";
+          }
+          break;
+
+        default:
+          return "0#";
+      }
+      target.startValue = values[0];
+      target.trackSeconds = values[1];
+      target.ditherSeconds = values[2];
+      target.ditherArcseconds = values[3];
+      return sequencer.add(target) ? "1#" : "0#";
+    }
+    else if (inCmd[1] == 'E') {
+      if ((inCmd.length() != 3) || ((inCmd[2] != SEQUENCE_END_TRACK) && (inCmd[2] != SEQUENCE_END_PARK))) {
+        return "0#";
+      }
+      sequencer.setEndAction(inCmd[2]);
+      return "1#";
+    }
+    else if (inCmd[1] == 'S') {
+      return sequencer.start() ? "1#" : "0#";
+    }
+    else if (inCmd[1] == 'X') {
+      sequencer.stop();
+      return "1#";
+    }
+    else if (inCmd[1] == 'C') {
+      sequencer.clear();
+      return "1#";
+    }
+    else if (inCmd[1] == 'G') {
+      char scratchBuffer[24];
+      sprintf(scratchBuffer, "%c,%d,%d,%ld#", sequencer.state(), sequencer.currentTarget() + 1, sequencer.targetCount(), sequencer.stateSeconds());
+      return String(scratchBuffer);
+    }
+  }
+  else if (inCmd[0] == 'P') { // Parameter registry
+    if (inCmd[1] == 'L') {
+      String list;
+      Parameter parameter;
+      for (byte i = 0; i < Parameters::count(); i++) {
+        Parameters::describe(i, parameter);
+        list += String(parameter.id) + "," + String(reinterpret_cast<const __FlashStringHelper *>(parameter.name)) + ",";
+        list += (parameter.type == PARAMETER_FLOAT) ? 'F' : (parameter.type == PARAMETER_INT32) ? 'L' : (parameter.type == PARAMETER_INT16) ? 'S' : 'B';
+        list += ",";
+        if (parameter.flags & PARAMETER_PERSISTENT) list += "P";
+        if (parameter.flags & PARAMETER_READONLY) list += "R";
+        list += "," + String(parameter.minimum, 1) + "," + String(parameter.maximum, 1) + ";";
+      }
+      return list + "#";
+    }
+    else if (inCmd[1] == 'G') {
+      Parameter parameter;
+      if (Parameters::find(inCmd.substring(2).toInt(), parameter)) {
+        ParameterValue value;
+        parameter.get(_mount, value);
+        return Parameters::format(parameter, value) + "#";
+      }
+      return "E#";
+    }
+    else if (inCmd[1] == 'S') {
+      int comma = inCmd.indexOf(',');
+      Parameter parameter;
+      ParameterValue value;
+      if ((comma > 2) && Parameters::find(inCmd.substring(2, comma).toInt(), parameter) 
+          && Parameters::parse(parameter, inCmd.c_str() + comma + 1, value) && Parameters::set(_mount, parameter.id, value)) {
+        return "1#";
+      }
+      return "0#";
+    }
+    else if (inCmd[1] == 'R') {
+      return Parameters::readImage(_mount) + "#";
+    }
+    else if (inCmd[1] == 'W') {
+      return Parameters::writeImage(_mount, inCmd.c_str() + 2) ? "1#" : "0#";
+    }
+  }
   else if ((inCmd[0]== 'F') && (inCmd[1]== 'R'))
   {
     _mount->clearConfiguration();
@@ -1015,6 +1403,7 @@ String MeadeCommandProcessor::handleMeadeQuit(String inCmd) {
   // :Q# stops a motors - remains in Control mode
   // :Qq# command does not stop motors, but quits Control mode
   if (inCmd.length() == 0) {
+    _mount->driftAlignment().stop();
     _mount->stopSlewing(ALL_DIRECTIONS | TRACKING);
     _mount->waitUntilStopped(ALL_DIRECTIONS);
     return "1";
@@ -1061,6 +1450,20 @@ String MeadeCommandProcessor::handleMeadeSetSlewRate(String inCmd) {
   return "";
 }
 
+/////////////////////////////
+// Precision toggle
+/////////////////////////////
+String MeadeCommandProcessor::handleMeadeTogglePrecision(String inCmd) {
+  _highPrecision = !_highPrecision;
+  LOGV2(DEBUG_MEADE, F("MEADE: Switched to %s precision"), _highPrecision ? "high" : "low");
+  return "";
+}
+
+// The string type flag that selects the current LX200 precision in RAString() and DECString()
+byte MeadeCommandProcessor::precisionString() const {
+  return _highPrecision ? 0 : LOW_PRECISION_STRING;
+}
+
 String MeadeCommandProcessor::processCommand(String inCmd) {
   if (inCmd[0] == ':') {
 
@@ -1087,6 +1490,7 @@ String MeadeCommandProcessor::processCommand(String inCmd) {
       case 'R': return handleMeadeSetSlewRate(inCmd);
       case 'D': return handleMeadeDistance(inCmd);
       case 'X': return handleMeadeExtraCommands(inCmd);
+      case 'U': return handleMeadeTogglePrecision(inCmd);
       default:
         LOGV2(DEBUG_MEADE, F("MEADE: Received unknown command '%s'"), inCmd.c_str());
       break;
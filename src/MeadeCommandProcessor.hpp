@@ -24,7 +24,10 @@ private:
   String handleMeadeDistance(String inCmd);
   String handleMeadeSetSlewRate(String inCmd);
   String handleMeadeExtraCommands(String inCmd);
+  String handleMeadeTogglePrecision(String inCmd);
+  byte precisionString() const;
   Mount* _mount;
   LcdMenu* _lcdMenu;
+  bool _highPrecision;
   static MeadeCommandProcessor* _instance;
 };
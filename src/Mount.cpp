@@ -1,15 +1,11 @@
 #include "../Configuration.hpp"
 #include "Utility.hpp"
 #include "EPROMStore.hpp"
+#include "FixedTrig.hpp"
 #include "LcdMenu.hpp"
 #include "Mount.hpp"
 #include "Sidereal.hpp"
-
-#include <AccelStepper.h>
-#if (RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || \
-  (AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART)
-  #include <TMCStepper.h>   // If you get an error here, download the TMCstepper library from "Tools > Manage Libraries"
-#endif
+#include "StepRates.hpp"
 
 //mountstatus
 #define STATUS_PARKED              0B0000000000000000
@@ -27,6 +23,12 @@
 #define STATUS_GUIDE_PULSE_MASK    0B0000000011100000
 #define STATUS_FINDING_HOME        0B0010000000000000
 
+// Axes that interruptLoop() runs towards their targets (_activeAxes), and that got there (_finishedAxes)
+#define AXIS_RA                    B00000001
+#define AXIS_DEC                   B00000010
+#define AXIS_AZ                    B00000100
+#define AXIS_ALT                   B00001000
+
 // slewingStatus()
 #define SLEWING_DEC                B00000010
 #define SLEWING_RA                 B00000001
@@ -43,9 +45,6 @@
 #define SLEW_MASK_WEST    B1000
 #define SLEW_MASK_ANY     B1111
 
-// Seconds per astronomical day (23h 56m 4.0905s)
-#define SECONDS_PER_DAY 86164.0905
-
 const char* formatStringsDEC[] = {
   "",
   " {d}@ {m}' {s}\"",  // LCD Menu w/ cursor
@@ -64,19 +63,20 @@ const char* formatStringsRA[] = {
   "%02d%02d%02d",           // Compact
 };
 
-const float siderealDegreesInHour = 14.95904348958;
 /////////////////////////////////
 //
 // CTOR
 //
 /////////////////////////////////
 Mount::Mount(LcdMenu* lcdMenu) :
+  _sequencer(this),
+  _guidePort(this),
+  _driftAlignment(this),
   _stepsPerRADegree(RA_STEPS_PER_DEGREE),   // u-steps per degree when slewing
   _stepsPerDECDegree(DEC_STEPS_PER_DEGREE)  // u-steps per degree when slewing
   #if AZIMUTH_ALTITUDE_MOTORS == 1
     , _stepsPerAZDegree(AZIMUTH_STEPS_PER_REV / 360),
-    _stepsPerALTDegree(ALTITUDE_STEPS_PER_REV / 360),
-    _azAltWasRunning(false)
+    _stepsPerALTDegree(ALTITUDE_STEPS_PER_REV / 360)
   #endif
 {
   _lcdMenu = lcdMenu;
@@ -88,18 +88,27 @@ Mount::Mount(LcdMenu* lcdMenu) :
 
   _compensateForTrackerOff = false;
   _trackerStoppedAt = 0;
+  _ditherRA = 0;
+  _ditherRASteps = 0;
+  _ditherDECStart = 0;
+  _ditherCount = 0;
+  _ditherSettledAt = 0;
+  _autoCalibrateTracking = (GUIDE_AUTO_CALIBRATION == 1);
+  _guideWindowPulses = 0;
+  _guideWindowSteps = 0;
+  _guideWindowStartedAt = 0;
+  _guidePortRaEndTime = 0;
+  _guidePortDecEndTime = 0;
 
   _totalDECMove = 0;
   _totalRAMove = 0;
   _moveRate = 4;
-  _backlashCorrectionSteps = 0;
-  _correctForBacklash = false;
   _slewingToHome = false;
   _slewingToPark = false;
+  _targetSlews = 0;
+  _slewCutShort = false;
   _raParkingPos  = 0;
   _decParkingPos = 0;
-  _decLowerLimit = 0;
-  _decUpperLimit = 0;
     
   #if USE_GYRO_LEVEL == 1
   _pitchCalibrationAngle = 0;
@@ -154,8 +163,8 @@ void Mount::readPersistentData()
   LOGV2(DEBUG_INFO,F("Mount: EEPROM: Speed factor is %f"), speed);
   setSpeedCalibration(speed, false);
 
-  _backlashCorrectionSteps = EEPROMStore::getBacklashCorrectionSteps();
-  LOGV2(DEBUG_INFO,F("Mount: EEPROM: Backlash correction is %d"), _backlashCorrectionSteps);
+  _stepperRA->setBacklash(EEPROMStore::getBacklashCorrectionSteps());
+  LOGV2(DEBUG_INFO,F("Mount: EEPROM: Backlash correction is %d"), _stepperRA->backlash());
 
   _latitude = EEPROMStore::getLatitude();
   LOGV2(DEBUG_INFO,F("Mount: EEPROM: Latitude is %s"), _latitude.ToString());
@@ -175,9 +184,9 @@ void Mount::readPersistentData()
   _decParkingPos = EEPROMStore::getDECParkingPos();
   LOGV3(DEBUG_INFO,F("Mount: EEPROM: Parking position read as R:%l, D:%l"), _raParkingPos, _decParkingPos);
 
-  _decLowerLimit = EEPROMStore::getDECLowerLimit();
-  _decUpperLimit = EEPROMStore::getDECUpperLimit();
-  LOGV3(DEBUG_INFO,F("Mount: EEPROM: DEC limits read as %l -> %l"), _decLowerLimit, _decUpperLimit);
+  _stepperDEC->setLowerLimit(EEPROMStore::getDECLowerLimit());
+  _stepperDEC->setUpperLimit(EEPROMStore::getDECUpperLimit());
+  LOGV3(DEBUG_INFO,F("Mount: EEPROM: DEC limits read as %l -> %l"), _stepperDEC->lowerLimit(), _stepperDEC->upperLimit());
 }
 
 /////////////////////////////////
@@ -189,20 +198,20 @@ void Mount::readPersistentData()
 void Mount::configureRAStepper(byte pin1, byte pin2, byte pin3, byte pin4, int maxSpeed, int maxAcceleration)
 {
 #if NORTHERN_HEMISPHERE
-  _stepperRA = new AccelStepper((RA_SLEW_MICROSTEPPING == 1) ? AccelStepper::FULL4WIRE : AccelStepper::HALF4WIRE, pin4, pin3, pin2, pin1);
+  _stepperRA = new RAAxis(pin4, pin3, pin2, pin1);
 #else
-  _stepperRA = new AccelStepper((RA_SLEW_MICROSTEPPING == 1) ? AccelStepper::FULL4WIRE : AccelStepper::HALF4WIRE, pin1, pin2, pin3, pin4);
+  _stepperRA = new RAAxis(pin1, pin2, pin3, pin4);
 #endif
   _stepperRA->setMaxSpeed(maxSpeed);
   _stepperRA->setAcceleration(maxAcceleration);
   _maxRASpeed = maxSpeed;
   _maxRAAcceleration = maxAcceleration;
 
-  // Use another AccelStepper to run the RA motor as well. This instance tracks earths rotation.
+  // Use another axis to run the RA motor as well. This instance tracks earths rotation.
 #if NORTHERN_HEMISPHERE
-  _stepperTRK = new AccelStepper((RA_TRACKING_MICROSTEPPING == 1) ? AccelStepper::FULL4WIRE : AccelStepper::HALF4WIRE, pin4, pin3, pin2, pin1);
+  _stepperTRK = new TRKAxis(pin4, pin3, pin2, pin1);
 #else
-  _stepperTRK = new AccelStepper((RA_TRACKING_MICROSTEPPING == 1) ? AccelStepper::FULL4WIRE : AccelStepper::HALF4WIRE, pin1, pin2, pin3, pin4);
+  _stepperTRK = new TRKAxis(pin1, pin2, pin3, pin4);
 #endif
   _stepperTRK->setMaxSpeed(10);
   _stepperTRK->setAcceleration(2500);
@@ -212,26 +221,26 @@ void Mount::configureRAStepper(byte pin1, byte pin2, byte pin3, byte pin4, int m
 #if RA_STEPPER_TYPE == STEPPER_TYPE_NEMA17
 void Mount::configureRAStepper(byte pin1, byte pin2, int maxSpeed, int maxAcceleration)
 {
-  _stepperRA = new AccelStepper(AccelStepper::DRIVER, pin1, pin2);
+  _stepperRA = new RAAxis(pin1, pin2);
   _stepperRA->setMaxSpeed(maxSpeed);
   _stepperRA->setAcceleration(maxAcceleration);
   _maxRASpeed = maxSpeed;
   _maxRAAcceleration = maxAcceleration;
 
-  // Use another AccelStepper to run the RA motor as well. This instance tracks earths rotation.
-  _stepperTRK = new AccelStepper(AccelStepper::DRIVER, pin1, pin2);
+  // Use another axis to run the RA motor as well. This instance tracks earths rotation.
+  _stepperTRK = new TRKAxis(pin1, pin2);
 
   _stepperTRK->setMaxSpeed(500);
   _stepperTRK->setAcceleration(5000);
 
   #if NORTHERN_HEMISPHERE != 1
-  _stepperRA->setPinsInverted(true, false, false);
-  _stepperTRK->setPinsInverted(true, false, false);
+  _stepperRA->setDirectionInverted(true);
+  _stepperTRK->setDirectionInverted(true);
   #endif
   
   #if RA_INVERT_DIR == 1
-  _stepperRA->setPinsInverted(true, false, false);
-  _stepperTRK->setPinsInverted(true, false, false);
+  _stepperRA->setDirectionInverted(true);
+  _stepperTRK->setDirectionInverted(true);
   #endif
 }
 #endif
@@ -245,9 +254,9 @@ void Mount::configureRAStepper(byte pin1, byte pin2, int maxSpeed, int maxAccele
 void Mount::configureDECStepper(byte pin1, byte pin2, byte pin3, byte pin4, int maxSpeed, int maxAcceleration)
 {
 #if NORTHERN_HEMISPHERE
-  _stepperDEC = new AccelStepper((DEC_SLEW_MICROSTEPPING == 1) ? AccelStepper::FULL4WIRE : AccelStepper::HALF4WIRE, pin1, pin2, pin3, pin4);
+  _stepperDEC = new DECAxis(pin1, pin2, pin3, pin4);
 #else
-  _stepperDEC = new AccelStepper((DEC_SLEW_MICROSTEPPING == 1) ? AccelStepper::FULL4WIRE : AccelStepper::HALF4WIRE, pin4, pin3, pin2, pin1);
+  _stepperDEC = new DECAxis(pin4, pin3, pin2, pin1);
 #endif
   _stepperDEC->setMaxSpeed(maxSpeed);
   _stepperDEC->setAcceleration(maxAcceleration);
@@ -259,14 +268,14 @@ void Mount::configureDECStepper(byte pin1, byte pin2, byte pin3, byte pin4, int
 #if DEC_STEPPER_TYPE == STEPPER_TYPE_NEMA17
 void Mount::configureDECStepper(byte pin1, byte pin2, int maxSpeed, int maxAcceleration)
 {
-  _stepperDEC = new AccelStepper(AccelStepper::DRIVER, pin1, pin2);
+  _stepperDEC = new DECAxis(pin1, pin2);
   _stepperDEC->setMaxSpeed(maxSpeed);
   _stepperDEC->setAcceleration(maxAcceleration);
   _maxDECSpeed = maxSpeed;
   _maxDECAcceleration = maxAcceleration;
   
   #if DEC_INVERT_DIR == 1
-  _stepperDEC->setPinsInverted(true, false, false);
+  _stepperDEC->setDirectionInverted(true);
   #endif
 }
 #endif
@@ -280,7 +289,7 @@ void Mount::configureDECStepper(byte pin1, byte pin2, int maxSpeed, int maxAccel
   #if AZ_DRIVER_TYPE == DRIVER_TYPE_ULN2003
     void Mount::configureAZStepper(byte pin1, byte pin2, byte pin3, byte pin4, int maxSpeed, int maxAcceleration)
     {
-      _stepperAZ = new AccelStepper((AZ_MICROSTEPPING == 1) ? AccelStepper::FULL4WIRE : AccelStepper::HALF4WIRE, pin1, pin2, pin3, pin4);
+      _stepperAZ = new AZAxis(pin1, pin2, pin3, pin4);
       _stepperAZ->setSpeed(0);
       _stepperAZ->setMaxSpeed(maxSpeed);
       _stepperAZ->setAcceleration(maxAcceleration);
@@ -289,7 +298,7 @@ void Mount::configureDECStepper(byte pin1, byte pin2, int maxSpeed, int maxAccel
   #if AZ_DRIVER_TYPE == DRIVER_TYPE_A4988_GENERIC || AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_STANDALONE || AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
     void Mount::configureAZStepper(byte pin1, byte pin2, int maxSpeed, int maxAcceleration)
     {
-      _stepperAZ = new AccelStepper(AccelStepper::DRIVER, pin1, pin2);
+      _stepperAZ = new AZAxis(pin1, pin2);
       _stepperAZ->setMaxSpeed(maxSpeed);
       _stepperAZ->setAcceleration(maxAcceleration);
       _maxAZSpeed = maxSpeed;
@@ -299,7 +308,7 @@ void Mount::configureDECStepper(byte pin1, byte pin2, int maxSpeed, int maxAccel
   #if ALT_DRIVER_TYPE == DRIVER_TYPE_ULN2003
     void Mount::configureALTStepper(byte pin1, byte pin2, byte pin3, byte pin4, int maxSpeed, int maxAcceleration)
     {
-      _stepperALT = new AccelStepper((ALT_MICROSTEPPING == 1) ? AccelStepper::FULL4WIRE : AccelStepper::HALF4WIRE, pin1, pin2, pin3, pin4);
+      _stepperALT = new ALTAxis(pin1, pin2, pin3, pin4);
       _stepperALT->setSpeed(0);
       _stepperALT->setMaxSpeed(maxSpeed);
       _stepperALT->setAcceleration(maxAcceleration);
@@ -308,7 +317,7 @@ void Mount::configureDECStepper(byte pin1, byte pin2, int maxSpeed, int maxAccel
   #if ALT_DRIVER_TYPE == DRIVER_TYPE_A4988_GENERIC || ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_STANDALONE || ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
     void Mount::configureALTStepper(byte pin1, byte pin2, int maxSpeed, int maxAcceleration)
     {
-      _stepperALT = new AccelStepper(AccelStepper::DRIVER, pin1, pin2);
+      _stepperALT = new ALTAxis(pin1, pin2);
       _stepperALT->setMaxSpeed(maxSpeed);
       _stepperALT->setAcceleration(maxAcceleration);
       _maxALTSpeed = maxSpeed;
@@ -317,103 +326,6 @@ void Mount::configureDECStepper(byte pin1, byte pin2, int maxSpeed, int maxAccel
   #endif  
 #endif
 
-/////////////////////////////////
-//
-// configureRAdriver
-// TMC2209 UART only
-/////////////////////////////////
-#if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-  void Mount::configureRAdriver(Stream *serial, float rsense, byte driveraddress, int rmscurrent, int stallvalue)
-  {
-    _driverRA = new TMC2209Stepper(serial, rsense, driveraddress);
-    _driverRA->begin();
-    #if RA_AUDIO_FEEDBACK == 1
-    _driverRA->en_spreadCycle(1);
-    #endif
-    _driverRA->toff(4);
-    _driverRA->blank_time(24);
-    _driverRA->rms_current(rmscurrent);
-    _driverRA->microsteps(RA_TRACKING_MICROSTEPPING);   // System starts in tracking mode
-    _driverRA->fclktrim(4);
-    _driverRA->TCOOLTHRS(0xFFFFF);  //xFFFFF);
-    _driverRA->ihold(1); // its save to assume that the only time RA stands still is during parking and the current can be limited to a minimum
-    //_driverRA->semin(2);
-    //_driverRA->semax(5);
-    //_driverRA->sedn(0b01);
-    //_driverRA->SGTHRS(10);
-    _driverRA->irun(31);
-  }
-#endif
-
-/////////////////////////////////
-//
-// configureDECdriver
-// TMC2209 UART only
-/////////////////////////////////
-#if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-  void Mount::configureDECdriver(Stream *serial, float rsense, byte driveraddress, int rmscurrent, int stallvalue)
-  {
-    _driverDEC = new TMC2209Stepper(serial, rsense, driveraddress);
-    _driverDEC->begin();
-    _driverDEC->blank_time(24);
-    #if DEC_AUDIO_FEEDBACK == 1
-    _driverDEC->en_spreadCycle(1);
-    #endif
-    _driverDEC->rms_current(rmscurrent);
-    _driverDEC->microsteps(DEC_SLEW_MICROSTEPPING == 1 ? 0 : DEC_SLEW_MICROSTEPPING);   // If 1 then disable microstepping
-    _driverDEC->TCOOLTHRS(0xFFFFF);
-    _driverDEC->semin(5);
-    _driverDEC->semax(2);
-    _driverDEC->sedn(0b01);
-    _driverDEC->SGTHRS(stallvalue);
-    _driverDEC->ihold(DEC_HOLDCURRENT);
-  }
-#endif
-
-/////////////////////////////////
-//
-// configureAZdriver
-// TMC2209 UART only
-/////////////////////////////////
-#if (AZIMUTH_ALTITUDE_MOTORS == 1) && (AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART)
-  void Mount::configureAZdriver(Stream *serial, float rsense, byte driveraddress, int rmscurrent, int stallvalue)
-  {
-    _driverAZ = new TMC2209Stepper(serial, rsense, driveraddress);
-    _driverAZ->begin();
-    #if AZ_AUDIO_FEEDBACK == 1
-      _driverAZ->en_spreadCycle(1);
-    #endif
-    _driverAZ->toff(4);
-    _driverAZ->blank_time(24);
-    _driverAZ->rms_current(rmscurrent);
-    _driverAZ->microsteps(AZ_MICROSTEPPING == 1 ? 0 : AZ_MICROSTEPPING);   // If 1 then disable microstepping
-    _driverAZ->fclktrim(4);
-    _driverAZ->TCOOLTHRS(0xFFFFF);  //xFFFFF);
-  }
-#endif
-
-/////////////////////////////////
-//
-// configureALTdriver
-// TMC2209 UART only
-/////////////////////////////////
-#if (AZIMUTH_ALTITUDE_MOTORS == 1) && (ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART)
-  void Mount::configureALTdriver(Stream *serial, float rsense, byte driveraddress, int rmscurrent, int stallvalue)
-  {
-    _driverALT = new TMC2209Stepper(serial, rsense, driveraddress);
-    _driverALT->begin();
-    #if ALT_AUDIO_FEEDBACK == 1
-      _driverALT->en_spreadCycle(1);
-    #endif
-    _driverALT->toff(4);
-    _driverALT->blank_time(24);
-    _driverALT->rms_current(rmscurrent);
-    _driverALT->microsteps(ALT_MICROSTEPPING == 1 ? 0 : ALT_MICROSTEPPING);   // If 1 then disable microstepping
-    _driverALT->fclktrim(4);
-    _driverALT->TCOOLTHRS(0xFFFFF);  //xFFFFF);
-  }
-#endif
-
 /////////////////////////////////
 //
 // getSpeedCalibration
@@ -444,6 +356,9 @@ void Mount::setSpeedCalibration(float val, bool saveToStorage) {
   if (saveToStorage) 
     EEPROMStore::storeSpeedFactor(_trackingSpeedCalibration);
 
+  // TRK steps of the guide calibration window were at the old speed
+  _guideWindowPulses = 0;
+
   // If we are currently tracking, update the speed. No need to update microstepping mode
   if (isSlewingTRK()) {
     LOGV2(DEBUG_STEPPERS, F("SpeedCal: TRK.setSpeed(%f)"), _trackingSpeed);
@@ -538,7 +453,7 @@ void Mount::setStepsPerDegree(int which, float steps) {
 /////////////////////////////////
 int Mount::getBacklashCorrection()
 {
-  return _backlashCorrectionSteps;
+  return _stepperRA->backlash();
 }
 
 /////////////////////////////////
@@ -618,8 +533,8 @@ String Mount::getMountHardwareInfo()
 // Function to set steps per degree for each axis. This function stores the value in persistent storage.
 void Mount::setBacklashCorrection(int steps) 
 {
-  _backlashCorrectionSteps = steps;
-  EEPROMStore::storeBacklashCorrectionSteps(_backlashCorrectionSteps);
+  _stepperRA->setBacklash(steps);
+  EEPROMStore::storeBacklashCorrectionSteps(steps);
 }
 
 /////////////////////////////////
@@ -805,6 +720,69 @@ const Declination Mount::currentDEC() const {
   return degreePos;
 }
 
+/////////////////////////////////
+//
+// currentAltAz
+//
+/////////////////////////////////
+void Mount::currentAltAz(long& altitude, long& azimuth) const {
+  altAzOf(currentRA(), currentDEC(), altitude, azimuth);
+}
+
+/////////////////////////////////
+//
+// hourAngleOf
+//
+/////////////////////////////////
+long Mount::hourAngleOf(const DayTime& ra) const {
+  DayTime lst(_LST);
+  lst.addSeconds(_stepperTRK->currentPosition() / _trackingSpeed);
+  long ha = lst.getTotalSeconds() - ra.getTotalSeconds();
+  if (ha >= 12L * 3600L) {
+    ha -= 24L * 3600L;
+  }
+  else if (ha < -12L * 3600L) {
+    ha += 24L * 3600L;
+  }
+  return ha;
+}
+
+/////////////////////////////////
+//
+// altAzOf
+//
+/////////////////////////////////
+// Turns the hour angle and declination into a direction in the sky with fixed point trig, on the
+// unit sphere in Q15: x points north, y east and z up.
+void Mount::altAzOf(const DayTime& ra, const Declination& dec, long& altitude, long& azimuth) const {
+  DayTime lst(_LST);
+  lst.addSeconds(_stepperTRK->currentPosition() / _trackingSpeed);
+  DayTime ha(lst);
+  ha.subtractTime(ra);
+
+  long decSeconds = dec.getTotalSeconds();
+  decSeconds = NORTHERN_HEMISPHERE ? (decSeconds + 90L * 3600L) : (-90L * 3600L - decSeconds);
+
+  FixedTrig::Angle haAngle = FixedTrig::fromArcSeconds(ha.getTotalSeconds() * 15L);
+  FixedTrig::Angle decAngle = FixedTrig::fromArcSeconds(decSeconds);
+  FixedTrig::Angle latAngle = FixedTrig::fromArcSeconds(_latitude.getTotalSeconds());
+  long sinDec = FixedTrig::sin(decAngle);
+  long cosDec = FixedTrig::cos(decAngle);
+  long sinLat = FixedTrig::sin(latAngle);
+  long cosLat = FixedTrig::cos(latAngle);
+  long cosDecCosHa = (cosDec * FixedTrig::cos(haAngle)) >> 15;
+
+  long x = (sinDec * cosLat - cosDecCosHa * sinLat) >> 15;
+  long y = -(cosDec * FixedTrig::sin(haAngle)) >> 15;
+  long z = (sinDec * sinLat + cosDecCosHa * cosLat) >> 15;
+
+  altitude = FixedTrig::toArcSeconds(FixedTrig::atan2(z, FixedTrig::sqrt(x * x + y * y)));
+  azimuth = FixedTrig::toArcSeconds(FixedTrig::atan2(y, x));
+  if (azimuth < 0) {
+    azimuth += 360L * 3600L;
+  }
+}
+
 /////////////////////////////////
 //
 // syncPosition
@@ -823,6 +801,7 @@ void Mount::syncPosition(DayTime ra, Declination dec)
   LOGV3(DEBUG_STEPPERS, F("STEP-syncPosition: Set current position to RA: %f and DEC: %f"), targetRAPosition, targetDECPosition);
   _stepperRA->setCurrentPosition(targetRAPosition);     // u-steps (in slew mode)
   _stepperDEC->setCurrentPosition(targetDECPosition);   // u-steps (in slew mode)
+  resetDither();
 }
 
 /////////////////////////////////
@@ -833,16 +812,17 @@ void Mount::syncPosition(DayTime ra, Declination dec)
 // Calculates movement parameters and program steppers to move
 // there. Must call loop() frequently to actually move.
 void Mount::startSlewingToTarget() {
+  _driftAlignment.stop();
   if (isGuiding()) {
     stopGuiding();
   }
+  resetDither();
+  _guideWindowPulses = 0;
 
-  // set Slew microsteps for TMC2209 UART // hier
-  #if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-    // TODO: Fix broken microstep management to re-instate fine pointing
-    // LOGV2(DEBUG_STEPPERS, F("STEP-startSlewingToTarget: Switching RA driver to microsteps(%d)"), RA_SLEW_MICROSTEPPING);
-    // _driverRA->microsteps(RA_SLEW_MICROSTEPPING);
-  #endif
+  // set Slew microsteps for TMC2209 UART
+  // TODO: Fix broken microstep management to re-instate fine pointing
+  // LOGV2(DEBUG_STEPPERS, F("STEP-startSlewingToTarget: Switching RA driver to microsteps(%d)"), RA_SLEW_MICROSTEPPING);
+  // _stepperRA->setMicrosteps(RA_SLEW_MICROSTEPPING);
 
   // Make sure we're slewing at full speed on a GoTo
   LOGV2(DEBUG_STEPPERS, F("STEP-startSlewingToTarget: Set DEC to MaxSpeed(%d)"), _maxDECSpeed);
@@ -856,9 +836,14 @@ void Mount::startSlewingToTarget() {
   _currentRAStepperPosition = _stepperRA->currentPosition();
   long targetRAPosition, targetDECPosition;
   calculateRAandDECSteppers(_targetRA, _targetDEC, targetRAPosition, targetDECPosition);
+  _targetSlews++;
+  _slewCutShort = false;
   moveSteppersTo(targetRAPosition, targetDECPosition);  // u-steps (in slew mode)
+  _sessionLog.addSlew(targetRAPosition, targetDECPosition);
 
   _mountStatus |= STATUS_SLEWING | STATUS_SLEWING_TO_TARGET;
+  startMoving(AXIS_RA | AXIS_DEC);
+  updateInterruptPeriod();
   _totalDECMove = 1.0f * _stepperDEC->distanceToGo();
   _totalRAMove = 1.0f * _stepperRA->distanceToGo();
   LOGV3(DEBUG_MOUNT, "Mount: RA Dist: %l,   DEC Dist: %l", _stepperRA->distanceToGo(), _stepperDEC->distanceToGo());
@@ -873,11 +858,9 @@ void Mount::startSlewingToTarget() {
       LOGV2(DEBUG_STEPPERS, F("STEP-startSlewingToTarget: TRK stopped at %lms"), _trackerStoppedAt);
     } else {
       // Since we won't be moving we need to set microstepping back to tracking
-      #if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-        // TODO: Fix broken microstep management to re-instate fine pointing
-        // LOGV2(DEBUG_STEPPERS, F("STEP-startSlewingToTarget: No slew. Switching RA driver to microsteps(%d)"), RA_TRACKING_MICROSTEPPING);
-        // _driverRA->microsteps(RA_TRACKING_MICROSTEPPING);
-      #endif
+      // TODO: Fix broken microstep management to re-instate fine pointing
+      // LOGV2(DEBUG_STEPPERS, F("STEP-startSlewingToTarget: No slew. Switching RA driver to microsteps(%d)"), RA_TRACKING_MICROSTEPPING);
+      // _stepperRA->setMicrosteps(RA_TRACKING_MICROSTEPPING);
     }
   #endif																					  
 }
@@ -898,6 +881,11 @@ void Mount::stopGuiding(bool ra, bool dec)
   {
     LOGV2(DEBUG_STEPPERS,F("STEP-stopGuiding(RA): TRK.setSpeed(%f)"), _trackingSpeed);
     _stepperTRK->setSpeed(_trackingSpeed);
+    #if RA_HARDWARE_TRACKING == 1
+      if ((_mountStatus & STATUS_TRACKING) == 0) {
+        _stepperTRK->stop();  // The interrupt no longer runs TRK, but the timer would go on
+      }
+    #endif
     _mountStatus &= ~STATUS_GUIDE_PULSE_RA;
   }
 
@@ -912,12 +900,11 @@ void Mount::stopGuiding(bool ra, bool dec)
     {
       _stepperDEC->run();
       _stepperTRK->runSpeed();
+      yield();
     }
 
     // TODO: If microstepping for guiding is changed, re-enable this
-    // #if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-    //   _driverDEC->microsteps(DEC_SLEW_MICROSTEPPING == 1 ? 0 : DEC_SLEW_MICROSTEPPING);
-    // #endif
+    // _stepperDEC->setMicrosteps(DEC_SLEW_MICROSTEPPING);
 
     _mountStatus &= ~STATUS_GUIDE_PULSE_DEC;
   }
@@ -935,6 +922,104 @@ void Mount::stopGuiding(bool ra, bool dec)
 //
 /////////////////////////////////
 void Mount::guidePulse(byte direction, int duration) {
+  _sessionLog.addGuidePulse(direction, duration);
+  countGuidePulse(direction, duration);
+  startGuidePulse(direction, duration);
+}
+
+/////////////////////////////////
+//
+// startGuidePortPulse
+//
+/////////////////////////////////
+void Mount::startGuidePortPulse(byte direction) {
+  startGuidePulse(direction, GUIDE_PORT_MAX_PULSE);
+  if (direction & (EAST | WEST)) {
+    _guidePortRaEndTime = _guideRaEndTime;
+  }
+  else {
+    _guidePortDecEndTime = _guideDecEndTime;
+  }
+}
+
+/////////////////////////////////
+//
+// endGuidePortPulse
+//
+/////////////////////////////////
+void Mount::endGuidePortPulse(byte direction, unsigned long lengthMicros) {
+  int duration = min(lengthMicros / 1000UL, (unsigned long)GUIDE_PORT_MAX_PULSE);
+  _sessionLog.addGuidePulse(direction, duration);
+  countGuidePulse(direction, duration);
+
+  // The pulse was started to end GUIDE_PORT_MAX_PULSE ms later. It ends (in loop()) as long after it started as the
+  // line was active, however late loop() got to the edges. A pulse that ended already (cut off, or stopped by a slew)
+  // or that a :Mg pulse replaced is left alone.
+  if (direction & (EAST | WEST)) {
+    if ((_mountStatus & STATUS_GUIDE_PULSE_RA) && (_guideRaEndTime == _guidePortRaEndTime)) {
+      _guideRaEndTime -= GUIDE_PORT_MAX_PULSE - duration;
+    }
+  }
+  else {
+    if ((_mountStatus & STATUS_GUIDE_PULSE_DEC) && (_guideDecEndTime == _guidePortDecEndTime)) {
+      _guideDecEndTime -= GUIDE_PORT_MAX_PULSE - duration;
+    }
+  }
+}
+
+/////////////////////////////////
+//
+// countGuidePulse
+//
+/////////////////////////////////
+void Mount::countGuidePulse(byte direction, int duration) {
+  // Pulses are counted as the arcseconds they ask for, at the rates startGuidePulse() runs the axes at
+  // (siderealDegreesInHour is arcseconds/second). East slows TRK down, so it is less than west.
+  if (_mountStatus & STATUS_TRACKING) {
+    float arcseconds = siderealDegreesInHour * duration / 1000.0f;
+    switch (direction) {
+      case NORTH: _guideStats.addDEC(DEC_PULSE_MULTIPLIER * arcseconds); break;
+      case SOUTH: _guideStats.addDEC(-DEC_PULSE_MULTIPLIER * arcseconds); break;
+      case WEST: _guideStats.addRA(RA_PULSE_MULTIPLIER * arcseconds); break;
+      case EAST: _guideStats.addRA((RA_PULSE_MULTIPLIER - 2.0f) * arcseconds); break;
+    }
+    if (direction & (EAST | WEST)) {
+      calibrateTrackingFromGuiding();
+      if (_guideWindowPulses++ == 0) {
+        _guideWindowSteps = _stepperTRK->currentPosition();
+        _guideWindowStartedAt = millis();
+      }
+    }
+  }
+}
+
+/////////////////////////////////
+//
+// calibrateTrackingFromGuiding
+//
+/////////////////////////////////
+void Mount::calibrateTrackingFromGuiding() {
+  unsigned long elapsed = millis() - _guideWindowStartedAt;
+  if (!_autoCalibrateTracking || (_guideWindowPulses < GUIDE_CALIBRATION_PULSES) || (elapsed < GUIDE_CALIBRATION_INTERVAL * 1000UL)) {
+    return;
+  }
+
+  // With the guider keeping the star in place, TRK followed the sky over the window. Its steps say how much faster
+  // it should track, whether or not each pulse moved it as far as it asked (a TRK stop shorter than a step does not).
+  // Only half of the difference is taken, since the window also holds guiding that was not drift.
+  float tracked = _trackingSpeed * elapsed / 1000.0f;
+  float change = 0.5f * (_stepperTRK->currentPosition() - _guideWindowSteps - tracked) / tracked;
+  change = constrain(change, -GUIDE_CALIBRATION_MAX_STEP, GUIDE_CALIBRATION_MAX_STEP);
+  LOGV4(DEBUG_MOUNT, F("Mount: %d guide pulses in %lms, changing speed calibration by %f"), _guideWindowPulses, elapsed, change);
+  setSpeedCalibration(_trackingSpeedCalibration * (1.0f + change), true);
+}
+
+/////////////////////////////////
+//
+// startGuidePulse
+//
+/////////////////////////////////
+void Mount::startGuidePulse(byte direction, int duration) {
   LOGV3(DEBUG_STEPPERS, F("STEP-guidePulse: > Guide Pulse %d for %dms"), direction, duration);
 
   // DEC stepper moves at sidereal rate in both directions
@@ -952,10 +1037,8 @@ void Mount::guidePulse(byte direction, int duration) {
 
   switch (direction) {
     case NORTH:
-    #if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-      // TODO: Fix broken microstep management to re-instate fine pointing. Also fix code in stopGuiding()
-      // _driverDEC->microsteps(DEC_GUIDE_MICROSTEPPING == 1 ? 0 : DEC_GUIDE_MICROSTEPPING);   // If 1 then disable microstepping
-    #endif
+    // TODO: Fix broken microstep management to re-instate fine pointing. Also fix code in stopGuiding()
+    // _stepperDEC->setMicrosteps(DEC_GUIDE_MICROSTEPPING);
     LOGV2(DEBUG_STEPPERS, F("STEP-guidePulse:  DEC.setSpeed(%f)"), DEC_PULSE_MULTIPLIER * decGuidingSpeed);
     _stepperDEC->setSpeed(DEC_PULSE_MULTIPLIER * decGuidingSpeed);
     _mountStatus |= STATUS_GUIDE_PULSE | STATUS_GUIDE_PULSE_DEC;
@@ -963,10 +1046,8 @@ void Mount::guidePulse(byte direction, int duration) {
     break;
 
     case SOUTH:
-    #if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-      // TODO: Fix broken microstep management to re-instate fine pointing. Also fix code in stopGuiding()
-      // _driverDEC->microsteps(DEC_GUIDE_MICROSTEPPING == 1 ? 0 : DEC_GUIDE_MICROSTEPPING);   // If 1 then disable microstepping
-    #endif
+    // TODO: Fix broken microstep management to re-instate fine pointing. Also fix code in stopGuiding()
+    // _stepperDEC->setMicrosteps(DEC_GUIDE_MICROSTEPPING);
     LOGV2(DEBUG_STEPPERS, F("STEP-guidePulse:  DEC.setSpeed(%f)"), -DEC_PULSE_MULTIPLIER * decGuidingSpeed);
     _stepperDEC->setSpeed(-DEC_PULSE_MULTIPLIER * decGuidingSpeed);
     _mountStatus |= STATUS_GUIDE_PULSE | STATUS_GUIDE_PULSE_DEC;
@@ -989,66 +1070,167 @@ void Mount::guidePulse(byte direction, int duration) {
     _guideRaEndTime = millis() + duration;
     break;
   }
+  updateInterruptPeriod();
   
   LOGV1(DEBUG_STEPPERS, F("STEP-guidePulse: < Guide Pulse"));
 }
 
 /////////////////////////////////
 //
-// runDriftAlignmentPhase
+// dither
 //
-// Runs one of the phases of the Drift alignment
-// This runs the RA motor 400 steps (about 5.3 arcminutes) in the given duration
-// This function should be callsed 3 times:
-// The first time with EAST, second with WEST and then with 0.
 /////////////////////////////////
-void Mount::runDriftAlignmentPhase(int direction, int durationSecs) {
+// The spiral pattern fills this many rings around the middle, then starts over
+#define DITHER_SPIRAL_RINGS   2
+#define DITHER_SPIRAL_POINTS  ((2 * DITHER_SPIRAL_RINGS + 1) * (2 * DITHER_SPIRAL_RINGS + 1) - 1)
+#define DITHER_MAX_PULSE      30000   // ms
 
-  float const numArcMinutes(5.3);
+// The n-th point (from 1) of a square spiral around 0,0: 1,0  1,1  0,1  -1,1  -1,0  -1,-1  0,-1  1,-1  2,-1 ...
+static void spiralPoint(int n, int& x, int& y)
+{
+  int dx = 1, dy = 0, leg = 1, onLeg = 0, turns = 0;
+  x = 0;
+  y = 0;
+  for (int i = 0; i < n; i++) {
+    x += dx;
+    y += dy;
+    if (++onLeg == leg) {
+      int turn = dx;
+      dx = -dy;
+      dy = turn;
+      onLeg = 0;
+      if ((++turns % 2) == 0) {
+        leg++;
+      }
+    }
+  }
+}
 
-  // TODO: Are we in slew mode here?
-  long numSteps = floor((_stepsPerRADegree * (numArcMinutes / 60.0)));  // u-steps/deg * minutes / (minutes/deg) = u-steps
+// How many arcseconds of the RA axis make one on the sky at the declination. Limited near the pole.
+static float raArcsecondsPerSkyArcsecond(const Declination& dec)
+{
+  long cosDec = abs(FixedTrig::sin(FixedTrig::fromArcSeconds(-dec.getTotalSeconds())));   // DEC is from the pole
+  return 32768.0f / max(cosDec, 3277L);
+}
 
-  // Calculate the speed at which it takes the given duration to cover the steps.
-  float speed = numSteps / durationSecs;
-  switch (direction) {
-    case EAST:
-    // Move steps east at the calculated speed, synchronously
-    _stepperRA->setMaxSpeed(speed);
-    _stepperRA->move(numSteps);
-    while (_stepperRA->run()) {
-      yield();
-    }
+bool Mount::dither(char pattern, int arcseconds) {
+  if (!isSlewingTRK() || isSlewingRAorDEC() || isGuiding()) {
+    return false;
+  }
 
-    // Overcome the gearing gap
-    _stepperRA->setMaxSpeed(300);
-    _stepperRA->move(-20);
-    while (_stepperRA->run()) {
-      yield();
-    }
-    break;
+  float skyRA = 0;
+  float skyDEC = 0;
+  switch (pattern) {
+    case DITHER_RANDOM:
+      skyRA = random(-arcseconds, arcseconds + 1);
+      skyDEC = random(-arcseconds, arcseconds + 1);
+      break;
 
-    case WEST:
-    // Move steps west at the calculated speed, synchronously
-    _stepperRA->setMaxSpeed(speed);
-    _stepperRA->move(-numSteps);
-    while (_stepperRA->run()) {
-      yield();
+    case DITHER_SPIRAL: {
+      int x, y;
+      _ditherCount = (_ditherCount % DITHER_SPIRAL_POINTS) + 1;
+      spiralPoint(_ditherCount, x, y);
+      skyRA = 1.0f * x * arcseconds / DITHER_SPIRAL_RINGS;
+      skyDEC = 1.0f * y * arcseconds / DITHER_SPIRAL_RINGS;
+      break;
     }
-    break;
 
-    case 0:
-    // Fix the gearing to go back the other way
-    _stepperRA->setMaxSpeed(300);
-    _stepperRA->move(20);
-    while (_stepperRA->run()) {
-      yield();
-    }
+    case DITHER_CENTER:
+      _ditherCount = 0;
+      break;
 
-    // Re-configure the stepper to the correct parameters.
-    _stepperRA->setMaxSpeed(_maxRASpeed);
-    break;
+    default:
+      return false;
+  }
+
+  // Guide pulses move the axes at a multiple of sidereal rate, which is siderealDegreesInHour arcseconds/second.
+  // East slows TRK down from tracking speed and west speeds it up (see startGuidePulse()), so they are not the same.
+  float moveRA = skyRA * raArcsecondsPerSkyArcsecond(currentDEC()) - _ditherRA;
+  float raRate = ((moveRA > 0) ? (2.0f - RA_PULSE_MULTIPLIER) : RA_PULSE_MULTIPLIER) * siderealDegreesInHour;
+  int raMs = min(fabs(moveRA) * 1000.0f / raRate, 1.0f * DITHER_MAX_PULSE);
+  // DEC guide pulses ramp down at the end, so DEC goes by where its steps are
+  float moveDEC = skyDEC - (_stepperDEC->currentPosition() - _ditherDECStart) * 3600.0f / _stepsPerDECDegree;
+  float decRate = DEC_PULSE_MULTIPLIER * siderealDegreesInHour;
+  int decMs = min(fabs(moveDEC) * 1000.0f / decRate, 1.0f * DITHER_MAX_PULSE);
+  LOGV5(DEBUG_MOUNT, F("Mount: Dither %c to %f, %f (%dms RA)"), pattern, skyRA, skyDEC, raMs);
+
+  if (raMs > 0) {
+    // TRK moves for the dither, which is not the guider's, so the guide calibration starts over
+    _guideWindowPulses = 0;
+    startGuidePulse((moveRA > 0) ? EAST : WEST, raMs);
+    _sessionLog.addGuidePulse(SESSION_LOG_DITHER | ((moveRA > 0) ? EAST : WEST), raMs);
+    _ditherRA += ((moveRA > 0) ? 1 : -1) * raRate * raMs / 1000.0f;
+
+    // TRK moves the RA axis by the pulse on top of tracking, so the RA position takes it up (east is fewer steps)
+    long raSteps = lround(-_ditherRA * _stepsPerRADegree / 3600.0f);
+    _stepperRA->setCurrentPosition(_stepperRA->currentPosition() + raSteps - _ditherRASteps);
+    _ditherRASteps = raSteps;
+  }
+  if (decMs > 0) {
+    startGuidePulse((moveDEC > 0) ? NORTH : SOUTH, decMs);
+    _sessionLog.addGuidePulse(SESSION_LOG_DITHER | ((moveDEC > 0) ? NORTH : SOUTH), decMs);
   }
+  _ditherSettledAt = millis() + max(raMs, decMs) + DITHER_SETTLE_TIME;
+  return true;
+}
+
+/////////////////////////////////
+//
+// isDitherSettled
+//
+/////////////////////////////////
+bool Mount::isDitherSettled() const {
+  return !isGuiding() && ((long)(millis() - _ditherSettledAt) >= 0);
+}
+
+/////////////////////////////////
+//
+// getDitherOffset
+//
+/////////////////////////////////
+void Mount::getDitherOffset(float& raArcseconds, float& decArcseconds) const {
+  raArcseconds = _ditherRA / raArcsecondsPerSkyArcsecond(currentDEC());
+  decArcseconds = (_stepperDEC->currentPosition() - _ditherDECStart) * 3600.0f / _stepsPerDECDegree;
+}
+
+/////////////////////////////////
+//
+// resetDither
+//
+/////////////////////////////////
+void Mount::resetDither() {
+  _ditherRA = 0;
+  _ditherRASteps = 0;
+  _ditherDECStart = _stepperDEC->currentPosition();
+  _ditherCount = 0;
+}
+
+/////////////////////////////////
+//
+// moveRA
+//
+// Runs RA by the given number of steps at the given speed, or at the slew speed when it is 0.
+// loop() finishes it like a slew to a target, while tracking carries on (or not) as it was.
+/////////////////////////////////
+void Mount::moveRA(long steps, float speed) {
+  LOGV3(DEBUG_STEPPERS, F("STEP-moveRA: Moving %l steps at %f steps/s"), steps, speed);
+  if (_mountStatus & STATUS_SLEWING_TO_TARGET) {
+    _slewCutShort = true;
+  }
+  _stepperRA->setMaxSpeed((speed > 0) ? speed : _maxRASpeed);
+  _stepperRA->move(steps);
+  _mountStatus |= STATUS_SLEWING;
+  startMoving(AXIS_RA);
+  updateInterruptPeriod();
+}
+
+/////////////////////////////////
+//
+// resetRASpeed
+//
+/////////////////////////////////
+void Mount::resetRASpeed() {
+  _stepperRA->setMaxSpeed(_maxRASpeed);
 }
 
 /////////////////////////////////
@@ -1058,19 +1240,22 @@ void Mount::runDriftAlignmentPhase(int direction, int durationSecs) {
 /////////////////////////////////
 void Mount::setManualSlewMode(bool state) {
   if (state) {
+    _driftAlignment.stop();
     stopSlewing(ALL_DIRECTIONS);
     stopSlewing(TRACKING);
     waitUntilStopped(ALL_DIRECTIONS);
+    // Forget the slew we just stopped, otherwise loop() takes the manual slew as finished straight away
+    _stepperWasRunning = false;
+    takeFinishedAxes(AXIS_RA | AXIS_DEC);
     _mountStatus |= STATUS_SLEWING | STATUS_SLEWING_MANUAL;
-    #if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-      // TODO: Fix broken microstep management to re-instate fine pointing
-      // LOGV2(DEBUG_STEPPERS, F("STEP-setManualSlewMode: Switching RA driver to microsteps(%d)"), RA_SLEW_MICROSTEPPING);
-      // _driverRA->microsteps(RA_SLEW_MICROSTEPPING);
-    #endif
+    updateInterruptPeriod();
+    // TODO: Fix broken microstep management to re-instate fine pointing
+    // LOGV2(DEBUG_STEPPERS, F("STEP-setManualSlewMode: Switching RA driver to microsteps(%d)"), RA_SLEW_MICROSTEPPING);
+    // _stepperRA->setMicrosteps(RA_SLEW_MICROSTEPPING);
   }
   else {
-    _mountStatus &= ~STATUS_SLEWING_MANUAL;
     stopSlewing(ALL_DIRECTIONS);
+    _mountStatus &= ~STATUS_SLEWING_MANUAL;
     waitUntilStopped(ALL_DIRECTIONS);
     LOGV3(DEBUG_STEPPERS, F("STEP-setManualSlewMode: Set RA  speed/accel:  %f  / %f"), _maxRASpeed, _maxRAAcceleration);
     LOGV3(DEBUG_STEPPERS, F("STEP-setManualSlewMode: Set DEC speed/accel:  %f  / %f"), _maxDECSpeed, _maxDECAcceleration);
@@ -1091,14 +1276,18 @@ void Mount::setSpeed(int which, float speedDegsPerSec) {
   if (which == RA_STEPS) {
     float stepsPerSec = speedDegsPerSec * _stepsPerRADegree;   // deg/sec * u-steps/deg = u-steps/sec
     LOGV3(DEBUG_STEPPERS, F("STEP-setSpeed: Set RA speed %f degs/s, which is %f steps/s"), speedDegsPerSec, stepsPerSec);
-    // TODO: Are we already in slew mode?
-    _stepperRA->setSpeed(stepsPerSec);
+    // Outside of manual slewing mode nothing runs the motor at this speed or stops it again
+    if (_mountStatus & STATUS_SLEWING_MANUAL) {
+      _stepperRA->setSpeed(stepsPerSec);
+    }
   }
   else if (which == DEC_STEPS) {
     float stepsPerSec = speedDegsPerSec * _stepsPerDECDegree;   // deg/sec * u-steps/deg = u-steps/sec
     LOGV3(DEBUG_STEPPERS, F("STEP-setSpeed: Set DEC speed %f degs/s, which is %f steps/s"), speedDegsPerSec, stepsPerSec);
-    // TODO: Are we already in slew mode?
-    _stepperDEC->setSpeed(stepsPerSec);
+    // Outside of manual slewing mode nothing runs the motor at this speed or stops it again
+    if (_mountStatus & STATUS_SLEWING_MANUAL) {
+      _stepperDEC->setSpeed(stepsPerSec);
+    }
   }
   #if AZIMUTH_ALTITUDE_MOTORS == 1
   else if (which == AZIMUTH_STEPS) {
@@ -1119,6 +1308,7 @@ void Mount::setSpeed(int which, float speedDegsPerSec) {
         _stepperAZ->enableOutputs();
         _stepperAZ->setSpeed(speedDegsPerSec);
         _stepperAZ->move(speedDegsPerSec * 100000);
+        startMoving(AXIS_AZ);
       } // Are we stopping a move?
       else if (speedDegsPerSec == 0) {
         _stepperAZ->disableOutputs();
@@ -1127,6 +1317,7 @@ void Mount::setSpeed(int which, float speedDegsPerSec) {
       float stepsPerSec = speedDegsPerSec * _stepsPerAZDegree;  // deg/sec * u-steps/deg = u-steps/sec
       LOGV3(DEBUG_STEPPERS, F("STEP-setSpeed: Set AZ speed %f degs/s, which is %f steps/s"), speedDegsPerSec, stepsPerSec);
       _stepperAZ->setSpeed(stepsPerSec);  
+      startMoving(AXIS_AZ);
     #endif
   }
   else if (which == ALTITUDE_STEPS) {
@@ -1147,6 +1338,7 @@ void Mount::setSpeed(int which, float speedDegsPerSec) {
         _stepperALT->enableOutputs();
         _stepperALT->setSpeed(speedDegsPerSec);
         _stepperALT->move(speedDegsPerSec * 100000);
+        startMoving(AXIS_ALT);
       } // Are we stopping a move?
       else if (speedDegsPerSec == 0) {
         _stepperALT->disableOutputs();
@@ -1155,6 +1347,7 @@ void Mount::setSpeed(int which, float speedDegsPerSec) {
       float stepsPerSec = speedDegsPerSec * _stepsPerALTDegree;   // deg/sec * u-steps/deg = u-steps/sec
       LOGV3(DEBUG_STEPPERS, F("STEP-setSpeed: Set ALT speed %f degs/s, which is %f steps/s"), speedDegsPerSec, stepsPerSec);
       _stepperALT->setSpeed(stepsPerSec);  
+      startMoving(AXIS_ALT);
     #endif
   }
   #endif
@@ -1168,6 +1361,7 @@ void Mount::setSpeed(int which, float speedDegsPerSec) {
 // turns off all motors once it gets there.
 /////////////////////////////////
 void Mount::park() {
+  _driftAlignment.stop();
   stopGuiding();
   stopSlewing(ALL_DIRECTIONS | TRACKING);
   waitUntilStopped(ALL_DIRECTIONS);
@@ -1224,6 +1418,7 @@ void Mount::moveBy(int direction, float arcMinutes)
         int stepsToMove = arcMinutes * AZIMUTH_STEPS_PER_ARC_MINUTE;
       #endif
       _stepperAZ->move(stepsToMove);
+      startMoving(AXIS_AZ);
     }
     else if (direction == ALTITUDE_STEPS) {
       enableAzAltMotors();
@@ -1234,7 +1429,9 @@ void Mount::moveBy(int direction, float arcMinutes)
       #endif
 
       _stepperALT->move(stepsToMove);
+      startMoving(AXIS_ALT);
     }
+    updateInterruptPeriod();
 }
 
 /////////////////////////////////
@@ -1248,16 +1445,8 @@ void Mount::disableAzAltMotors() {
   while (_stepperALT->isRunning() || _stepperAZ->isRunning()){
     loop();
   }
-  #if AZ_DRIVER_TYPE == DRIVER_TYPE_ULN2003
-    _stepperAZ->disableOutputs();
-  #else
-    digitalWrite(AZ_EN_PIN, HIGH);  // Logic HIGH to disable driver
-  #endif
-  #if ALT_DRIVER_TYPE == DRIVER_TYPE_ULN2003
-    _stepperALT->disableOutputs();
-  #else
-    digitalWrite(ALT_EN_PIN, HIGH);  // Logic HIGH to disable driver
-  #endif
+  _stepperAZ->disableOutputs();
+  _stepperALT->disableOutputs();
 }
 
 /////////////////////////////////
@@ -1266,16 +1455,8 @@ void Mount::disableAzAltMotors() {
 //
 /////////////////////////////////
 void Mount::enableAzAltMotors() {
-  #if AZ_DRIVER_TYPE == DRIVER_TYPE_ULN2003
-    _stepperAZ->enableOutputs();
-  #else
-    digitalWrite(AZ_EN_PIN, LOW);  // Logic LOW to enable driver
-  #endif
-  #if ALT_DRIVER_TYPE == DRIVER_TYPE_ULN2003
-    _stepperALT->enableOutputs();
-  #else
-    digitalWrite(ALT_EN_PIN, LOW);  // Logic LOW to enable driver
-  #endif
+  _stepperAZ->enableOutputs();
+  _stepperALT->enableOutputs();
 }
 
 #endif
@@ -1453,6 +1634,15 @@ bool Mount::isSlewingRAorDEC() const {
   return (slewStatus() & (SLEWING_DEC | SLEWING_RA)) != 0;
 }
 
+/////////////////////////////////
+//
+// slewReachedTarget
+//
+/////////////////////////////////
+bool Mount::slewReachedTarget() const {
+  return !_slewCutShort && !isSlewingRAorDEC();
+}
+
 /////////////////////////////////
 //
 // isSlewingIdle
@@ -1515,10 +1705,8 @@ void Mount::startSlewing(int direction) {
 
     if (direction & TRACKING) {
       // Start tracking
-      #if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-        // TODO: Fix broken microstep management to re-instate fine pointing
-        // _driverRA->microsteps(RA_TRACKING_MICROSTEPPING);
-      #endif
+      // TODO: Fix broken microstep management to re-instate fine pointing
+      // _stepperRA->setMicrosteps(RA_TRACKING_MICROSTEPPING);
       _stepperTRK->setSpeed(_trackingSpeed);
       
       // Turn on tracking
@@ -1527,7 +1715,12 @@ void Mount::startSlewing(int direction) {
     }
     else {
       // Start slewing
+      _driftAlignment.stop();
+      if (_mountStatus & STATUS_SLEWING_TO_TARGET) {
+        _slewCutShort = true;
+      }
       int sign = NORTHERN_HEMISPHERE ? 1 : -1;
+      byte axes = 0;
 
       // Set move rate to last commanded slew rate
       setSlewRate(_moveRate);
@@ -1542,20 +1735,16 @@ void Mount::startSlewing(int direction) {
       #endif
 
       // Change microstep mode for slewing
-      #if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-        // TODO: Fix broken microstep management to re-instate fine pointing
-        // _driverRA->microsteps(RA_SLEW_MICROSTEPPING);
-      #endif
-      #if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-        // TODO: Fix broken microstep management to re-instate fine pointing
-        // _driverDEC->microsteps(DEC_SLEW_MICROSTEPPING);
-      #endif
+      // TODO: Fix broken microstep management to re-instate fine pointing
+      // _stepperRA->setMicrosteps(RA_SLEW_MICROSTEPPING);
+      // TODO: Fix broken microstep management to re-instate fine pointing
+      // _stepperDEC->setMicrosteps(DEC_SLEW_MICROSTEPPING);
 
       if (direction & NORTH) {
         long targetLocation = sign * 300000;
-        if (_decUpperLimit != 0) {
-          targetLocation = _decUpperLimit;
-          LOGV3(DEBUG_STEPPERS, F("STEP-startSlewing(N): DEC has upper limit of %l. targetMoveTo is now %l"), _decUpperLimit, targetLocation);
+        if (_stepperDEC->upperLimit() != 0) {
+          targetLocation = _stepperDEC->upperLimit();
+          LOGV3(DEBUG_STEPPERS, F("STEP-startSlewing(N): DEC has upper limit of %l. targetMoveTo is now %l"), _stepperDEC->upperLimit(), targetLocation);
         }
         else {
           LOGV2(DEBUG_STEPPERS, F("STEP-startSlewing(N): initial targetMoveTo is %l"), targetLocation);
@@ -1563,13 +1752,14 @@ void Mount::startSlewing(int direction) {
       
         _stepperDEC->moveTo(targetLocation);
         _mountStatus |= STATUS_SLEWING;
+        axes |= AXIS_DEC;
       }
 
       if (direction & SOUTH) {
         long targetLocation = -sign * 300000;
-        if (_decLowerLimit != 0) {
-          targetLocation = _decLowerLimit;
-          LOGV3(DEBUG_STEPPERS, F("STEP-startSlewing(S): DEC has lower limit of %l. targetMoveTo is now %l"), _decLowerLimit, targetLocation);
+        if (_stepperDEC->lowerLimit() != 0) {
+          targetLocation = _stepperDEC->lowerLimit();
+          LOGV3(DEBUG_STEPPERS, F("STEP-startSlewing(S): DEC has lower limit of %l. targetMoveTo is now %l"), _stepperDEC->lowerLimit(), targetLocation);
         }
         else {
           LOGV2(DEBUG_STEPPERS, F("STEP-startSlewing(S): initial targetMoveTo is %l"), targetLocation);
@@ -1577,19 +1767,28 @@ void Mount::startSlewing(int direction) {
 
         _stepperDEC->moveTo(targetLocation);
         _mountStatus |= STATUS_SLEWING;
+        axes |= AXIS_DEC;
       }
 
       if (direction & EAST) {
           LOGV2(DEBUG_STEPPERS, F("STEP-startSlewing(E): initial targetMoveTo is %l"), -sign * 300000);
         _stepperRA->moveTo(-sign * 300000);
         _mountStatus |= STATUS_SLEWING;
+        axes |= AXIS_RA;
       }
       if (direction & WEST) {
           LOGV2(DEBUG_STEPPERS, F("STEP-startSlewing(W): initial targetMoveTo is %l"), sign * 300000);
         _stepperRA->moveTo(sign * 300000);
         _mountStatus |= STATUS_SLEWING;
+        axes |= AXIS_RA;
+      }
+
+      // Manual slews run at the speed they were given instead, not to the target
+      if (!(_mountStatus & STATUS_SLEWING_MANUAL)) {
+        startMoving(axes);
       }
     }
+    updateInterruptPeriod();
   }
 }
 
@@ -1600,21 +1799,38 @@ void Mount::startSlewing(int direction) {
 // Stop manual slewing in one of two directions or Tracking. NS is the same. EW is the same
 /////////////////////////////////
 void Mount::stopSlewing(int direction) {
+  if ((direction & ALL_DIRECTIONS) && (_mountStatus & STATUS_SLEWING_TO_TARGET)) {
+    _slewCutShort = true;
+  }
+
   if (direction & TRACKING) {
     // Turn off tracking
     _mountStatus &= ~STATUS_TRACKING;
+    _guideWindowPulses = 0;
 
     LOGV1(DEBUG_STEPPERS, F("STEP-stopSlewing: TRK stepper stop()"));
     _stepperTRK->stop();
   }
 
+  // Manual slews run at a constant speed without ramps (the interrupt only calls runSpeed()), 
+  // so they stop on the spot. A decelerating stop() would never be run to completion.
   if ((direction & (NORTH | SOUTH)) != 0) {
     LOGV1(DEBUG_STEPPERS, F("STEP-stopSlewing: DEC stepper stop()"));
-    _stepperDEC->stop();
+    if (_mountStatus & STATUS_SLEWING_MANUAL) {
+      _stepperDEC->setCurrentPosition(_stepperDEC->currentPosition());
+    }
+    else {
+      _stepperDEC->stop();
+    }
   }
   if ((direction & (WEST | EAST)) != 0) {
     LOGV1(DEBUG_STEPPERS, F("STEP-stopSlewing: RA stepper stop()"));
-    _stepperRA->stop();    
+    if (_mountStatus & STATUS_SLEWING_MANUAL) {
+      _stepperRA->setCurrentPosition(_stepperRA->currentPosition());
+    }
+    else {
+      _stepperRA->stop();    
+    }
   }
 }
 
@@ -1694,16 +1910,115 @@ void Mount::interruptLoop()
       _stepperRA->runSpeed();
     }
     else {
-      _stepperDEC->run();
-      _stepperRA->run();
+      if ((_activeAxes & AXIS_DEC) && !_stepperDEC->run()) {
+        axisFinished(AXIS_DEC);
+      }
+      if ((_activeAxes & AXIS_RA) && !_stepperRA->run()) {
+        axisFinished(AXIS_RA);
+      }
     }
   }
 
   #if AZIMUTH_ALTITUDE_MOTORS == 1
-  _stepperAZ->run();
-  _stepperALT->run();
+  if ((_activeAxes & AXIS_AZ) && !_stepperAZ->run()) {
+    axisFinished(AXIS_AZ);
+  }
+  if ((_activeAxes & AXIS_ALT) && !_stepperALT->run()) {
+    axisFinished(AXIS_ALT);
+  }
   #endif
-  
+}
+
+/////////////////////////////////
+//
+// startMoving
+//
+// Has interruptLoop() run the given axes towards the targets they were just given, until
+// they get there. Idle axes cost the interrupt nothing.
+/////////////////////////////////
+void Mount::startMoving(byte axes)
+{
+  noInterrupts();
+  _activeAxes |= axes;
+  interrupts();
+}
+
+// Called by interruptLoop() when an axis reached its target
+inline void Mount::axisFinished(byte axis)
+{
+  _activeAxes &= ~axis;
+  _finishedAxes |= axis;
+}
+
+/////////////////////////////////
+//
+// takeFinishedAxes
+//
+// Returns which of the given axes reached their targets since the last call, and forgets them.
+/////////////////////////////////
+byte Mount::takeFinishedAxes(byte axes)
+{
+  noInterrupts();
+  byte finished = _finishedAxes & axes;
+  _finishedAxes &= ~axes;
+  interrupts();
+  return finished;
+}
+
+/////////////////////////////////
+//
+// stepperInterruptPeriod
+//
+// Slews run at the shortest period: each step of a ramp is timed from the interrupt that made
+// the one before, so a longer period would slow them down. Tracking and guiding run at constant
+// speeds, whose steps keep their times at any period (see Axis::runSpeed()). They get the slowest
+// interrupt, in powers of two of STEPPER_INTERRUPT_MIN_PERIOD, that still comes at least twice
+// per step of the fastest motor. A step is then never later than one period, nor than half of
+// its own interval.
+/////////////////////////////////
+unsigned long Mount::stepperInterruptPeriod() const
+{
+  if (_mountStatus & STATUS_SLEWING) {
+    return STEPPER_INTERRUPT_MIN_PERIOD;
+  }
+  #if AZIMUTH_ALTITUDE_MOTORS == 1
+  if (_activeAxes & (AXIS_AZ | AXIS_ALT)) {
+    return STEPPER_INTERRUPT_MIN_PERIOD;
+  }
+  #endif
+  if ((_mountStatus & (STATUS_TRACKING | STATUS_GUIDE_PULSE)) == 0) {
+    return 0;
+  }
+
+  float fastest = fabs(_stepperTRK->speed());  // steps/s
+  if (_mountStatus & STATUS_GUIDE_PULSE_DEC) {
+    fastest = max(fastest, fabs(_stepperDEC->speed()));
+  }
+  unsigned long period = STEPPER_INTERRUPT_MIN_PERIOD;
+  while ((period * 2 <= STEPPER_INTERRUPT_MAX_PERIOD) && (fastest * period * 4 <= 1000000.0f)) {
+    period *= 2;
+  }
+  return period;
+}
+
+void Mount::setInterruptPeriodCallback(void (*callback)(unsigned long periodMicros))
+{
+  _interruptPeriodCallback = callback;
+  _interruptPeriod = stepperInterruptPeriod();
+  _interruptPeriodCallback(_interruptPeriod);
+}
+
+void Mount::updateInterruptPeriod()
+{
+  if (_interruptPeriodCallback == nullptr) {
+    return;
+  }
+  unsigned long period = stepperInterruptPeriod();
+  if (period != _interruptPeriod) {
+    LOGV3(DEBUG_STEPPERS, F("STEP-updateInterruptPeriod: %l us, was %l us"), period, _interruptPeriod);
+    _interruptPeriod = period;
+    _interruptPeriodCallback(period);
+  }
 }
 
 /////////////////////////////////
@@ -1721,6 +2036,15 @@ void Mount::loop() {
   #if RUN_STEPPERS_IN_MAIN_LOOP == 1
   interruptLoop();
   #endif
+  updateInterruptPeriod();
+  _sequencer.loop();
+  _driftAlignment.loop();
+  _guidePort.loop();
+
+  // Guide pulses have their own records
+  unsigned long trackingRate = (_mountStatus & STATUS_TRACKING) ? (unsigned long)(_trackingSpeed * 1000.0f + 0.5f) : 0;
+  _sessionLog.update(_stepperRA->currentPosition(), _stepperDEC->currentPosition(), _stepperTRK->currentPosition(),
+                     trackingRate, _mountStatus & ~STATUS_GUIDE_PULSE_MASK);
 
   #if (DEBUG_LEVEL & DEBUG_MOUNT) && (DEBUG_LEVEL & DEBUG_VERBOSE)
   unsigned long now = millis();
@@ -1731,15 +2055,10 @@ void Mount::loop() {
   #endif
 
   #if AZIMUTH_ALTITUDE_MOTORS == 1
-  if (!_stepperALT->isRunning() && !_stepperAZ->isRunning() && _azAltWasRunning)
+  if (takeFinishedAxes(AXIS_AZ | AXIS_ALT) && !(_activeAxes & (AXIS_AZ | AXIS_ALT)))
   {
-    // One of the motors was running last time through the loop, but not anymore, so shutdown the outputs.
+    // The last of the motors has just got where it was going, so shutdown the outputs.
     disableAzAltMotors();
-    _azAltWasRunning = false;
-  }
-  if (_stepperALT->isRunning() || _stepperAZ->isRunning())
-  {
-     _azAltWasRunning = true;
   }
   #endif
 
@@ -1763,21 +2082,21 @@ void Mount::loop() {
     bool stopDecGuiding = now > _guideDecEndTime;
     if (stopRaGuiding || stopDecGuiding) {
       stopGuiding(stopRaGuiding,stopDecGuiding);
-      #if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-        // TODO: Fix broken microstep management to re-instate fine pointing
-        // LOGV2(DEBUG_STEPPERS, F("STEP-loop: DEC driver setMicrosteps(%d)"), DEC_SLEW_MICROSTEPPING == 1 ? 0 : DEC_SLEW_MICROSTEPPING);
-        // _driverDEC->microsteps(DEC_SLEW_MICROSTEPPING == 1 ? 0 : DEC_SLEW_MICROSTEPPING);   // If 1 then disable microstepping
-      #endif					
+      // TODO: Fix broken microstep management to re-instate fine pointing
+      // LOGV2(DEBUG_STEPPERS, F("STEP-loop: DEC driver setMicrosteps(%d)"), DEC_SLEW_MICROSTEPPING);
+      // _stepperDEC->setMicrosteps(DEC_SLEW_MICROSTEPPING);
     }
     return;
   }
 
-  if (_stepperDEC->isRunning()) {
-    decStillRunning = true;
+  // Manual slews run at a speed, without a target. Everything else runs until interruptLoop() reports it there.
+  if (_mountStatus & STATUS_SLEWING_MANUAL) {
+    raStillRunning = _stepperRA->isRunning();
+    decStillRunning = _stepperDEC->isRunning();
   }
-
-  if (_stepperRA->isRunning()) {
-    raStillRunning = true;
+  else {
+    raStillRunning = _activeAxes & AXIS_RA;
+    decStillRunning = _activeAxes & AXIS_DEC;
   }
 
   if (raStillRunning || decStillRunning) {
@@ -1794,7 +2113,7 @@ void Mount::loop() {
     else {
       _mountStatus &= ~(STATUS_SLEWING | STATUS_SLEWING_TO_TARGET);
 
-      if (_stepperWasRunning) {
+      if (takeFinishedAxes(AXIS_RA | AXIS_DEC)) {
         LOGV3(DEBUG_MOUNT|DEBUG_STEPPERS,F("Mount::Loop: Reached target. RA:%l, DEC:%l"), _stepperRA->currentPosition(), _stepperDEC->currentPosition());
         // Mount is at Target!
         // If we we're parking, we just reached home. Clear the flag, reset the motors and stop tracking.
@@ -1812,13 +2131,13 @@ void Mount::loop() {
 
         _currentDECStepperPosition = _stepperDEC->currentPosition();
         _currentRAStepperPosition = _stepperRA->currentPosition();
+        resetDither();
         #if RA_STEPPER_TYPE == STEPPER_TYPE_NEMA17
-          #if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-            // TODO: Fix broken microstep management to re-instate fine pointing
-            // LOGV2(DEBUG_STEPPERS, F("STEP-loop: RA driver setMicrosteps(%d)"), RA_TRACKING_MICROSTEPPING);
-            // _driverRA->microsteps(RA_TRACKING_MICROSTEPPING);
-          #endif
-          if (!isParking()) {
+          // TODO: Fix broken microstep management to re-instate fine pointing
+          // LOGV2(DEBUG_STEPPERS, F("STEP-loop: RA driver setMicrosteps(%d)"), RA_TRACKING_MICROSTEPPING);
+          // _stepperRA->setMicrosteps(RA_TRACKING_MICROSTEPPING);
+          // The drift alignment tracks again once it is done
+          if (!isParking() && !_driftAlignment.isRunning()) {
             if (_compensateForTrackerOff) {
               unsigned long now = millis();
               unsigned long elapsed = now - _trackerStoppedAt;
@@ -1830,17 +2149,7 @@ void Mount::loop() {
             startSlewing(TRACKING);					   
           }
         #endif
-        if (_correctForBacklash) {
-          LOGV3(DEBUG_MOUNT|DEBUG_STEPPERS,F("Mount::Loop:   Reached target at %d. Compensating by %d"), (int)_currentRAStepperPosition, _backlashCorrectionSteps);
-          _currentRAStepperPosition += _backlashCorrectionSteps;
-          _stepperRA->runToNewPosition(_currentRAStepperPosition);
-          _correctForBacklash = false;
-          LOGV2(DEBUG_MOUNT|DEBUG_STEPPERS,F("Mount::Loop:   Backlash correction done. Pos: %d"), _currentRAStepperPosition);
-        }
-        else
-        {
-          LOGV2(DEBUG_MOUNT|DEBUG_STEPPERS,F("Mount::Loop:   Reached target at %d, no backlash compensation needed"), _currentRAStepperPosition);
-        }
+        LOGV2(DEBUG_MOUNT|DEBUG_STEPPERS,F("Mount::Loop:   Reached target at %l"), _currentRAStepperPosition);
 
         if (_slewingToHome) {
           LOGV1(DEBUG_MOUNT|DEBUG_STEPPERS,F("Mount::Loop:   Was Slewing home, so setting stepper RA and TRK to zero."));
@@ -1859,6 +2168,7 @@ void Mount::loop() {
             LOGV5(DEBUG_MOUNT|DEBUG_STEPPERS,F("Mount::Loop:   Park Position is R:%l  D:%l, TotalMove is R:%f, D:%f"), _raParkingPos, _decParkingPos,_totalRAMove, _totalDECMove);
             if ((_stepperDEC->distanceToGo() != 0) || (_stepperRA->distanceToGo() != 0)) {
               _mountStatus |= STATUS_PARKING_POS | STATUS_SLEWING;
+              startMoving(AXIS_RA | AXIS_DEC);
             }
           }
           else {
@@ -1914,6 +2224,31 @@ void Mount::setParkingPosition() {
   EEPROMStore::storeDECParkingPos(_decParkingPos);
 }
 
+/////////////////////////////////
+//
+// setParkingPosition
+//
+/////////////////////////////////
+void Mount::setParkingPosition(long raSteps, long decSteps) {
+  _raParkingPos = raSteps;
+  _decParkingPos = decSteps;
+
+  LOGV3(DEBUG_MOUNT,F("Mount::setParkingPos: parking RA: %l  DEC:%l"), _raParkingPos, _decParkingPos);
+
+  EEPROMStore::storeRAParkingPos(_raParkingPos);
+  EEPROMStore::storeDECParkingPos(_decParkingPos);
+}
+
+/////////////////////////////////
+//
+// getParkingPosition
+//
+/////////////////////////////////
+void Mount::getParkingPosition(long & raSteps, long & decSteps) {
+  raSteps = _raParkingPos;
+  decSteps = _decParkingPos;
+}
+
 /////////////////////////////////
 //
 // setDecLimitPosition
@@ -1921,14 +2256,14 @@ void Mount::setParkingPosition() {
 /////////////////////////////////
 void Mount::setDecLimitPosition(bool upper) {
   if (upper) {
-    _decUpperLimit = _stepperDEC->currentPosition();
-    EEPROMStore::storeDECUpperLimit(_decUpperLimit);
-    LOGV3(DEBUG_MOUNT,F("Mount::setDecLimitPosition(Upper): limit DEC: %l -> %l"), _decLowerLimit, _decUpperLimit);
+    _stepperDEC->setUpperLimit(_stepperDEC->currentPosition());
+    EEPROMStore::storeDECUpperLimit(_stepperDEC->upperLimit());
+    LOGV3(DEBUG_MOUNT,F("Mount::setDecLimitPosition(Upper): limit DEC: %l -> %l"), _stepperDEC->lowerLimit(), _stepperDEC->upperLimit());
   }
   else{
-    _decLowerLimit = _stepperDEC->currentPosition();
-    EEPROMStore::storeDECLowerLimit(_decLowerLimit);
-    LOGV3(DEBUG_MOUNT,F("Mount::setDecLimitPosition(Lower): limit DEC: %l -> %l"), _decLowerLimit, _decUpperLimit);
+    _stepperDEC->setLowerLimit(_stepperDEC->currentPosition());
+    EEPROMStore::storeDECLowerLimit(_stepperDEC->lowerLimit());
+    LOGV3(DEBUG_MOUNT,F("Mount::setDecLimitPosition(Lower): limit DEC: %l -> %l"), _stepperDEC->lowerLimit(), _stepperDEC->upperLimit());
   }
 }
 
@@ -1939,14 +2274,14 @@ void Mount::setDecLimitPosition(bool upper) {
 /////////////////////////////////
 void Mount::clearDecLimitPosition(bool upper) {
   if (upper) {
-    _decUpperLimit = 0;
-    EEPROMStore::storeDECUpperLimit(_decUpperLimit);
-    LOGV3(DEBUG_MOUNT,F("Mount::clearDecLimitPosition(Upper): limit DEC: %l -> %l"), _decLowerLimit, _decUpperLimit);
+    _stepperDEC->setUpperLimit(0);
+    EEPROMStore::storeDECUpperLimit(0);
+    LOGV3(DEBUG_MOUNT,F("Mount::clearDecLimitPosition(Upper): limit DEC: %l -> %l"), _stepperDEC->lowerLimit(), _stepperDEC->upperLimit());
   }
   else{
-    _decLowerLimit = 0;
-    EEPROMStore::storeDECLowerLimit(_decLowerLimit);
-    LOGV3(DEBUG_MOUNT,F("Mount::clearDecLimitPosition(Lower): limit DEC: %l -> %l"), _decLowerLimit, _decUpperLimit);
+    _stepperDEC->setLowerLimit(0);
+    EEPROMStore::storeDECLowerLimit(0);
+    LOGV3(DEBUG_MOUNT,F("Mount::clearDecLimitPosition(Lower): limit DEC: %l -> %l"), _stepperDEC->lowerLimit(), _stepperDEC->upperLimit());
   }
 }
 
@@ -1956,8 +2291,21 @@ void Mount::clearDecLimitPosition(bool upper) {
 //
 /////////////////////////////////
 void Mount::getDecLimitPositions(long & lowerLimit, long & upperLimit) {
-  lowerLimit = _decLowerLimit;
-  upperLimit = _decUpperLimit;
+  lowerLimit = _stepperDEC->lowerLimit();
+  upperLimit = _stepperDEC->upperLimit();
+}
+
+/////////////////////////////////
+//
+// setDecLimitPositions
+//
+/////////////////////////////////
+void Mount::setDecLimitPositions(long lowerLimit, long upperLimit) {
+  _stepperDEC->setLowerLimit(lowerLimit);
+  _stepperDEC->setUpperLimit(upperLimit);
+  EEPROMStore::storeDECLowerLimit(lowerLimit);
+  EEPROMStore::storeDECUpperLimit(upperLimit);
+  LOGV3(DEBUG_MOUNT,F("Mount::setDecLimitPositions: limit DEC: %l -> %l"), lowerLimit, upperLimit);
 }
 
 /////////////////////////////////
@@ -2125,28 +2473,22 @@ void Mount::calculateRAandDECSteppers(DayTime const& ra, Declination const& dec,
 /////////////////////////////////
 void Mount::moveSteppersTo(float targetRASteps, float targetDECSteps) {   // Units are u-steps (in slew mode)
   // Show time: tell the steppers where to go!
-  _correctForBacklash = false;
   LOGV3(DEBUG_MOUNT,F("Mount::MoveSteppersTo: RA  From: %l  To: %f"), _stepperRA->currentPosition(), targetRASteps);
   LOGV3(DEBUG_MOUNT,F("Mount::MoveSteppersTo: DEC From: %l  To: %f"), _stepperDEC->currentPosition(), targetDECSteps);
 
-  if ((_backlashCorrectionSteps != 0) && ((_stepperRA->currentPosition() - targetRASteps) > 0)) {
-    LOGV2(DEBUG_MOUNT,F("Mount::MoveSteppersTo: Needs backlash correction of %d!"), _backlashCorrectionSteps);
-    targetRASteps -= _backlashCorrectionSteps;
-    _correctForBacklash = true;
+  // Moves to lower positions go past the target and come back up to it, taking up the backlash
+  _stepperRA->moveToTakingUpBacklash(targetRASteps);
+  if (_stepperRA->targetPosition() != (long)targetRASteps) {
+    LOGV2(DEBUG_MOUNT,F("Mount::MoveSteppersTo: Needs backlash correction of %d!"), _stepperRA->backlash());
   }
 
-  _stepperRA->moveTo(targetRASteps);
-
-  if (_decUpperLimit != 0) {
-    targetDECSteps = min(targetDECSteps, (float)_decUpperLimit);
-    LOGV2(DEBUG_MOUNT,F("Mount::MoveSteppersTo: DEC Upper Limit enforced. To: %f"), targetDECSteps);
-  }
-  if (_decLowerLimit != 0) {
-    targetDECSteps = max(targetDECSteps, (float)_decLowerLimit);
-    LOGV2(DEBUG_MOUNT,F("Mount::MoveSteppersTo: DEC Lower Limit enforced. To: %f"), targetDECSteps);
+  long decTarget = _stepperDEC->withinLimits(targetDECSteps);
+  if (decTarget != (long)targetDECSteps) {
+    _slewCutShort = true;
+    LOGV2(DEBUG_MOUNT,F("Mount::MoveSteppersTo: DEC Limit enforced. To: %l"), decTarget);
   }
 
-  _stepperDEC->moveTo(targetDECSteps);
+  _stepperDEC->moveTo(decTarget);
 }
 
 
@@ -2249,6 +2591,10 @@ String Mount::DECString(byte type, byte active) {
   // dec.checkHours();
   // LOGV2(DEBUG_MOUNT_VERBOSE,F("DECString: Postcheck : %s"), dec.ToString());
 
+  if ((type & FORMAT_STRING_MASK) == MEADE_STRING) {
+    return String(dec.formatMeadeString(scratchBuffer, (type & LOW_PRECISION_STRING) == 0));
+  }
+
   dec.formatString(scratchBuffer, formatStringsDEC[type & FORMAT_STRING_MASK]);
 
   // sprintf(scratchBuffer, formatStringsDEC[type & FORMAT_STRING_MASK], dec.getDegreesDisplay().c_str(), dec.getMinutes(), dec.getSeconds());
@@ -2274,6 +2620,10 @@ String Mount::RAString(byte type, byte active) {
     ra = DayTime(currentRA());
   }
 
+  if ((type & FORMAT_STRING_MASK) == MEADE_STRING) {
+    return String(ra.formatMeadeString(scratchBuffer, (type & LOW_PRECISION_STRING) == 0));
+  }
+
   sprintf(scratchBuffer, formatStringsRA[type & FORMAT_STRING_MASK], ra.getHours(), ra.getMinutes(), ra.getSeconds());
   if ((type & FORMAT_STRING_MASK) == LCDMENU_STRING) {
     scratchBuffer[active * 4] = '>';
@@ -2290,10 +2640,10 @@ String Mount::RAString(byte type, byte active) {
 #if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART && DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART && USE_AUTOHOME == 1
 
 void Mount::startFindingHomeDEC()  {
-  _driverDEC->SGTHRS(10);
+  _stepperDEC->driver().tmc()->SGTHRS(10);
   // TODO: Fix broken microstep management to re-instate fine pointing
-  // _driverDEC->microsteps(16);
-  _driverDEC->rms_current(700);
+  // _stepperDEC->setMicrosteps(16);
+  _stepperDEC->setCurrent(700);
   
 
   setManualSlewMode(true);
@@ -2320,13 +2670,13 @@ void Mount::finishFindingHomeDEC()
 }
 
 void Mount::startFindingHomeRA()  {
-  _driverRA->SGTHRS(50);
-  _driverRA->rms_current(1000);
+  _stepperRA->driver().tmc()->SGTHRS(50);
+  _stepperRA->setCurrent(1000);
   // TODO: Fix broken microstep management to re-instate fine pointing
-  // _driverRA->microsteps(FULLSTEP);
-  _driverRA->semin(0);  // turn off coolstep
-  _driverRA->semin(5);
-  //_driverRA->TCOOLTHRS(0xFF);  // turn autocurrent threshold down to prevent false reading
+  // _stepperRA->setMicrosteps(FULLSTEP);
+  _stepperRA->driver().tmc()->semin(0);  // turn off coolstep
+  _stepperRA->driver().tmc()->semin(5);
+  //_stepperRA->driver().tmc()->TCOOLTHRS(0xFF);  // turn autocurrent threshold down to prevent false reading
   
   setManualSlewMode(true);
   //_mountStatus |= STATUS_FINDING_HOME;
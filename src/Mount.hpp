@@ -4,9 +4,14 @@
 #include "Declination.hpp"
 #include "Latitude.hpp"
 #include "Longitude.hpp"
+#include "Axis.hpp"
+#include "Sequencer.hpp"
+#include "GuideStatistics.hpp"
+#include "GuidePort.hpp"
+#include "SessionLog.hpp"
+#include "DriftAlignment.hpp"
 
 // Forward declarations
-class AccelStepper;
 class LcdMenu;
 class TMC2209Stepper;
 
@@ -17,6 +22,11 @@ class TMC2209Stepper;
 #define ALL_DIRECTIONS             B00001111
 #define TRACKING                   B00010000
 
+// Patterns of Mount::dither()
+#define DITHER_RANDOM   'R'   // Anywhere within the distance
+#define DITHER_SPIRAL   'S'   // The next point of a square spiral out to the distance, then from the middle again
+#define DITHER_CENTER   'C'   // Back to where the dithers started
+
 #define LCDMENU_STRING      B0001
 #define MEADE_STRING        B0010
 #define PRINT_STRING        B0011
@@ -26,6 +36,7 @@ class TMC2209Stepper;
 
 #define TARGET_STRING      B01000
 #define CURRENT_STRING     B10000
+#define LOW_PRECISION_STRING B100000   // MEADE_STRING only: LX200 low precision (HH:MM.T# and sDD*MM#)
 
 #define RA_STEPS  1
 #define DEC_STEPS 2
@@ -79,25 +90,14 @@ public:
   #endif
 #endif
 
-#if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-// Configure the RA Driver (TMC2209 UART only)
-  void configureRAdriver(Stream *serial, float rsense, byte driveraddress, int rmscurrent, int stallvalue);
-#endif
-#if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-  // Configure the DEC Driver (TMC2209 UART only)
-  void configureDECdriver(Stream *serial, float rsense, byte driveraddress, int rmscurrent, int stallvalue);
-#endif
-
-// Configure the AZ/ALT drivers.
+  // The drivers of the motors, for setup() to set up the TMC2209s on their UART
+  RAAxis::Driver& driverRA() { return _stepperRA->driver(); }
+  DECAxis::Driver& driverDEC() { return _stepperDEC->driver(); }
 #if AZIMUTH_ALTITUDE_MOTORS == 1
-  #if AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-    void configureAZdriver(Stream *serial, float rsense, byte driveraddress, int rmscurrent, int stallvalue);
-  #endif
-  #if ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-    void configureALTdriver(Stream *serial, float rsense, byte driveraddress, int rmscurrent, int stallvalue);
-  #endif
+  AZAxis::Driver& driverAZ() { return _stepperAZ->driver(); }
+  ALTAxis::Driver& driverALT() { return _stepperALT->driver(); }
 #endif
-  
+
   // Get the current RA tracking speed factor
   float getSpeedCalibration();
 
@@ -153,6 +153,16 @@ public:
   // Get current DEC value.
   const Declination currentDEC() const;
 
+  // Get where the mount points in the sky of the site, in arcseconds. Altitude is -90..90 degrees,
+  // azimuth 0..360 degrees from north through east.
+  void currentAltAz(long& altitude, long& azimuth) const;
+
+  // Get where the given coordinates are in the sky of the site now, in the same way
+  void altAzOf(const DayTime& ra, const Declination& dec, long& altitude, long& azimuth) const;
+
+  // Get the hour angle of the given RA now in seconds, -12h..12h, positive west of the meridian
+  long hourAngleOf(const DayTime& ra) const;
+
   // Set the current RA and DEC position to be the given coordinates
   void syncPosition(DayTime ra, Declination dec);
 
@@ -160,6 +170,13 @@ public:
   // there. Must call loop() frequently to actually move.
   void startSlewingToTarget();
 
+  // Counts the slews to a target (including park and home), so a caller can tell whether the one it started is the last
+  byte targetSlews() const { return _targetSlews; }
+
+  // Whether the last slew to a target ended there, rather than being stopped, replaced by a manual move or kept
+  // short of it by the DEC limits
+  bool slewReachedTarget() const;
+
   // Various status query functions
   bool isSlewingDEC() const;
   bool isSlewingRA() const;
@@ -194,9 +211,27 @@ public:
   // Process any stepper movement. 
   void loop();
 
+  // The queue of targets the mount runs by itself
+  Sequencer& sequencer() { return _sequencer; }
+
+  // The ST-4 guide port (see USE_GUIDE_PORT)
+  GuidePort& guidePort() { return _guidePort; }
+
+  // What the mount did lately (see SESSION_LOG_SIZE)
+  SessionLog& sessionLog() { return _sessionLog; }
+
+  // The drift alignment procedure
+  DriftAlignment& driftAlignment() { return _driftAlignment; }
+
   // Low-leve process any stepper movement on interrupt callback.
   void interruptLoop();
 
+  // The period the stepper interrupt needs for the motors that are moving, in microseconds. 0 when none are.
+  unsigned long stepperInterruptPeriod() const;
+
+  // Has the mount call back with the period right away, and again whenever it changes, to retune the stepper interrupt
+  void setInterruptPeriodCallback(void (*callback)(unsigned long periodMicros));
+
   // Set RA and DEC to the home position
   void setTargetToHome();
 
@@ -209,6 +244,10 @@ public:
   // Set the current stepper positions to be parking position.
   void setParkingPosition();
 
+  // Set the parking position to the given RA and DEC slew steps from home, and get it.
+  void setParkingPosition(long raSteps, long decSteps);
+  void getParkingPosition(long & raSteps, long & decSteps);
+
   // Set the DEC limit position to the current stepper position. If upper is true, sets the upper limit, else the lower limit.
   void setDecLimitPosition(bool upper); 
   
@@ -218,6 +257,9 @@ public:
   // Get the DEC limit positions
   void getDecLimitPositions(long & lowerLimit, long & upperLimit);
 
+  // Set the DEC limit positions (0 for no limit)
+  void setDecLimitPositions(long lowerLimit, long upperLimit);
+
   // Auto Home with TMC2209 UART
   #if (RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART)
     void startFindingHomeRA();
@@ -230,8 +272,34 @@ public:
   void park();
 
   // Runs the RA motor at twice the speed (or stops it), or the DEC motor at tracking speed for the given duration in ms.
+  // While tracking, the pulse is added to the guide statistics.
   void guidePulse(byte direction, int duration);
 
+  // A guide pulse from the ST-4 guide port, that runs until endGuidePortPulse() gives it the length the line was
+  // active (or for GUIDE_PORT_MAX_PULSE ms). It is counted like guidePulse() once it has its length.
+  void startGuidePortPulse(byte direction);
+  void endGuidePortPulse(byte direction, unsigned long lengthMicros);
+
+  // The guide pulses since the statistics were cleared
+  GuideStatistics& guideStatistics() { return _guideStats; }
+
+  // Whether the RA guide pulses correct the speed calibration (see GUIDE_AUTO_CALIBRATION)
+  void setTrackingAutoCalibration(bool on) { _autoCalibrateTracking = on; }
+  bool isTrackingAutoCalibration() const { return _autoCalibrateTracking; }
+
+  // Moves the mount with guide pulses to the next offset of a dither pattern (DITHER_RANDOM etc.), at most the given
+  // arcseconds (on the sky) from where the dithers started. The RA the pulses move is added to the RA position, so
+  // currentRA() and currentDEC() report where the mount points. A slew or sync starts the dithers over.
+  // False if the mount is not just tracking.
+  bool dither(char pattern, int arcseconds);
+
+  // True once the guide pulses of the last dither are done and the mount had DITHER_SETTLE_TIME to settle
+  bool isDitherSettled() const;
+
+  // The offset of the dithers from where they started, in arcseconds on the sky. Positive is the way east and
+  // north guide pulses move.
+  void getDitherOffset(float& raArcseconds, float& decArcseconds) const;
+
   // Stops any guide operation in progress.
   void stopGuiding();
 
@@ -253,8 +321,12 @@ public:
   // Displays the current location of the mount every n ms, where n is defined in Globals.h as DISPLAY_UPDATE_TIME
   void displayStepperPositionThrottled();
 
-  // Runs a phase of the drift alignment procedure
-  void runDriftAlignmentPhase(int direction, int durationSecs);
+  // Moves RA by the given u-steps at the given speed in u-steps/s (0 for the slew speed), without waiting for it.
+  // The move ends like a slew does, see isSlewingRAorDEC(). Tracking is left as it is.
+  void moveRA(long steps, float speed);
+
+  // Sets RA back to the slew speed, after moveRA() ran it at another one
+  void resetRASpeed();
 
   // Toggle the state where we run the motors at a constant speed
   void setManualSlewMode(bool state);
@@ -327,8 +399,37 @@ private:
 
   void autoCalcHa();
 
+  // Tells the interrupt period callback when the motion needs another period
+  void updateInterruptPeriod();
+
+  // The active axes (AXIS_RA etc.) that interruptLoop() runs, and the events it raises when they finish
+  void startMoving(byte axes);
+  void axisFinished(byte axis);
+  byte takeFinishedAxes(byte axes);
+
+  // Makes where the mount points now the middle of the dithers
+  void resetDither();
+
+  // Runs a guide pulse, without counting it in the guide statistics
+  void startGuidePulse(byte direction, int duration);
+
+  // Adds a guide pulse to the guide statistics while tracking, and lets the tracking calibration take it up
+  void countGuidePulse(byte direction, int duration);
+
+  // Nudges the speed calibration towards how far the guide pulses moved TRK, once the window is long enough
+  void calibrateTrackingFromGuiding();
+
 private:
   LcdMenu* _lcdMenu;
+  Sequencer _sequencer;
+  GuidePort _guidePort;
+  SessionLog _sessionLog;
+  DriftAlignment _driftAlignment;
+  GuideStatistics _guideStats;
+  bool _autoCalibrateTracking;
+  unsigned int _guideWindowPulses;      // RA pulses in the window of the guide calibration, 0 until the next starts it
+  long _guideWindowSteps;               // TRK u-steps when the window started
+  unsigned long _guideWindowStartedAt;  // millis()
   float _stepsPerRADegree;    // u-steps/degree when slewing (see RA_STEPS_PER_DEGREE)
   float _stepsPerDECDegree;   // u-steps/degree when slewing (see RA_STEPS_PER_DEGREE)
   int _maxRASpeed;
@@ -339,12 +440,9 @@ private:
   int _maxDECAcceleration;
   int _maxAZAcceleration;
   int _maxALTAcceleration;
-  int _backlashCorrectionSteps;
   int _moveRate;
   long _raParkingPos;     // Parking position in slewing steps
   long _decParkingPos;    // Parking position in slewing steps
-  long _decLowerLimit;    // Movement limit in slewing steps
-  long _decUpperLimit;    // Movement limit in slewing steps
 
 #if USE_GYRO_LEVEL == 1
   float _pitchCalibrationAngle;
@@ -367,45 +465,44 @@ private:
   Longitude _longitude;
 
   // Stepper control for RA, DEC and TRK.
-  AccelStepper* _stepperRA;
-  AccelStepper* _stepperDEC;
-  AccelStepper* _stepperTRK;
-  #if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-    TMC2209Stepper* _driverRA;
-  #endif  
-  #if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-    TMC2209Stepper* _driverDEC;
-  #endif  
+  RAAxis* _stepperRA;
+  DECAxis* _stepperDEC;
+  TRKAxis* _stepperTRK;
 
   #if AZIMUTH_ALTITUDE_MOTORS == 1
-    AccelStepper* _stepperAZ;
-    AccelStepper* _stepperALT;
+    AZAxis* _stepperAZ;
+    ALTAxis* _stepperALT;
     const long _stepsPerAZDegree;    // u-steps/degree (from CTOR)
     const long _stepsPerALTDegree;   // u-steps/degree (from CTOR)
-    bool _azAltWasRunning;
-    #if AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-      TMC2209Stepper* _driverAZ;
-    #endif 
-    #if ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-      TMC2209Stepper* _driverALT;
-    #endif 
   #endif
 
   unsigned long _guideRaEndTime;
   unsigned long _guideDecEndTime;
+  unsigned long _guidePortRaEndTime;    // When the pulses the guide port started were to end, to tell them from others
+  unsigned long _guidePortDecEndTime;
+  float _ditherRA;                      // Arcseconds of the RA axis the dithers moved, positive as guiding east
+  long _ditherDECStart;                 // DEC u-steps where the dithers started. Guiding north adds steps.
+  long _ditherRASteps;                  // Of those, the RA slewing u-steps added to the RA position
+  int _ditherCount;                     // Point of the spiral pattern
+  unsigned long _ditherSettledAt;       // millis() when the last dither is settled
   unsigned long _lastMountPrint = 0;
   unsigned long _lastTrackingPrint = 0;
+  void (*_interruptPeriodCallback)(unsigned long periodMicros) = nullptr;
+  unsigned long _interruptPeriod = 0;
   float _trackingSpeed;                 // RA u-steps/sec when in tracking mode
   float _trackingSpeedCalibration;      // Dimensionless, very close to 1.0
   unsigned long _lastDisplayUpdate;
   unsigned long _trackerStoppedAt;
   bool _compensateForTrackerOff;
   volatile int _mountStatus;
+  volatile byte _activeAxes = 0;
+  volatile byte _finishedAxes = 0;
   char scratchBuffer[24];
   bool _stepperWasRunning;
-  bool _correctForBacklash;
   bool _slewingToHome;
   bool _slewingToPark;
+  byte _targetSlews;
+  bool _slewCutShort;                   // The last slew to a target will not (or did not) get there
   bool _bootComplete;
 
   int _localUtcOffset;
@@ -0,0 +1,284 @@
+#include "../Configuration.hpp"
+#include "Utility.hpp"
+#include "Mount.hpp"
+#include "Parameters.hpp"
+
+/////////////////////////////////
+// Accessors
+/////////////////////////////////
+static void getRAStepsPerDegree(Mount* mount, ParameterValue& value) { value.real = mount->getStepsPerDegree(RA_STEPS); }
+static void setRAStepsPerDegree(Mount* mount, const ParameterValue& value) { mount->setStepsPerDegree(RA_STEPS, value.real); }
+
+static void getDECStepsPerDegree(Mount* mount, ParameterValue& value) { value.real = mount->getStepsPerDegree(DEC_STEPS); }
+static void setDECStepsPerDegree(Mount* mount, const ParameterValue& value) { mount->setStepsPerDegree(DEC_STEPS, value.real); }
+
+static void getSpeedCalibration(Mount* mount, ParameterValue& value) { value.real = mount->getSpeedCalibration(); }
+static void setSpeedCalibration(Mount* mount, const ParameterValue& value) { mount->setSpeedCalibration(value.real, true); }
+
+static void getBacklashSteps(Mount* mount, ParameterValue& value) { value.integer = mount->getBacklashCorrection(); }
+static void setBacklashSteps(Mount* mount, const ParameterValue& value) { mount->setBacklashCorrection(value.integer); }
+
+static void getLatitude(Mount* mount, ParameterValue& value) { value.real = mount->latitude().getTotalHours(); }
+static void setLatitude(Mount* mount, const ParameterValue& value) { mount->setLatitude(Latitude(value.real)); }
+
+static void getLongitude(Mount* mount, ParameterValue& value) { value.real = mount->longitude().getTotalHours(); }
+static void setLongitude(Mount* mount, const ParameterValue& value) { mount->setLongitude(Longitude(value.real)); }
+
+#if USE_GYRO_LEVEL == 1
+static void getPitchCalibration(Mount* mount, ParameterValue& value) { value.real = mount->getPitchCalibrationAngle(); }
+static void setPitchCalibration(Mount* mount, const ParameterValue& value) { mount->setPitchCalibrationAngle(value.real); }
+
+static void getRollCalibration(Mount* mount, ParameterValue& value) { value.real = mount->getRollCalibrationAngle(); }
+static void setRollCalibration(Mount* mount, const ParameterValue& value) { mount->setRollCalibrationAngle(value.real); }
+#endif
+
+static void getRAParkingPosition(Mount* mount, ParameterValue& value)
+{
+  long decSteps;
+  mount->getParkingPosition(value.integer, decSteps);
+}
+
+static void setRAParkingPosition(Mount* mount, const ParameterValue& value)
+{
+  long raSteps, decSteps;
+  mount->getParkingPosition(raSteps, decSteps);
+  mount->setParkingPosition(value.integer, decSteps);
+}
+
+static void getDECParkingPosition(Mount* mount, ParameterValue& value)
+{
+  long raSteps;
+  mount->getParkingPosition(raSteps, value.integer);
+}
+
+static void setDECParkingPosition(Mount* mount, const ParameterValue& value)
+{
+  long raSteps, decSteps;
+  mount->getParkingPosition(raSteps, decSteps);
+  mount->setParkingPosition(raSteps, value.integer);
+}
+
+static void getDECLowerLimit(Mount* mount, ParameterValue& value)
+{
+  long upperLimit;
+  mount->getDecLimitPositions(value.integer, upperLimit);
+}
+
+static void setDECLowerLimit(Mount* mount, const ParameterValue& value)
+{
+  long lowerLimit, upperLimit;
+  mount->getDecLimitPositions(lowerLimit, upperLimit);
+  mount->setDecLimitPositions(value.integer, upperLimit);
+}
+
+static void getDECUpperLimit(Mount* mount, ParameterValue& value)
+{
+  long lowerLimit;
+  mount->getDecLimitPositions(lowerLimit, value.integer);
+}
+
+static void setDECUpperLimit(Mount* mount, const ParameterValue& value)
+{
+  long lowerLimit, upperLimit;
+  mount->getDecLimitPositions(lowerLimit, upperLimit);
+  mount->setDecLimitPositions(lowerLimit, value.integer);
+}
+
+static void getTrackingSpeed(Mount* mount, ParameterValue& value) { value.real = mount->getSpeed(TRACKING); }
+
+/////////////////////////////////
+// The registry
+/////////////////////////////////
+static const char raStepsName[] PROGMEM = "RAStepsPerDegree";
+static const char decStepsName[] PROGMEM = "DECStepsPerDegree";
+static const char speedCalibrationName[] PROGMEM = "SpeedCalibration";
+static const char backlashName[] PROGMEM = "BacklashSteps";
+static const char latitudeName[] PROGMEM = "Latitude";
+static const char longitudeName[] PROGMEM = "Longitude";
+#if USE_GYRO_LEVEL == 1
+static const char pitchName[] PROGMEM = "PitchCalibration";
+static const char rollName[] PROGMEM = "RollCalibration";
+#endif
+static const char raParkingName[] PROGMEM = "RAParkingPosition";
+static const char decParkingName[] PROGMEM = "DECParkingPosition";
+static const char decLowerLimitName[] PROGMEM = "DECLowerLimit";
+static const char decUpperLimitName[] PROGMEM = "DECUpperLimit";
+static const char trackingSpeedName[] PROGMEM = "TrackingSpeed";
+
+static const Parameter registry[] PROGMEM = {
+  { PARAMETER_RA_STEPS_PER_DEGREE, raStepsName, PARAMETER_FLOAT, PARAMETER_PERSISTENT, 1.0f, 100000.0f, getRAStepsPerDegree, setRAStepsPerDegree },
+  { PARAMETER_DEC_STEPS_PER_DEGREE, decStepsName, PARAMETER_FLOAT, PARAMETER_PERSISTENT, 1.0f, 100000.0f, getDECStepsPerDegree, setDECStepsPerDegree },
+  { PARAMETER_SPEED_CALIBRATION, speedCalibrationName, PARAMETER_FLOAT, PARAMETER_PERSISTENT, 0.5f, 1.5f, getSpeedCalibration, setSpeedCalibration },
+  { PARAMETER_BACKLASH_STEPS, backlashName, PARAMETER_INT16, PARAMETER_PERSISTENT, 0.0f, 32767.0f, getBacklashSteps, setBacklashSteps },
+  { PARAMETER_LATITUDE, latitudeName, PARAMETER_FLOAT, PARAMETER_PERSISTENT, -90.0f, 90.0f, getLatitude, setLatitude },
+  { PARAMETER_LONGITUDE, longitudeName, PARAMETER_FLOAT, PARAMETER_PERSISTENT, -180.0f, 180.0f, getLongitude, setLongitude },
+#if USE_GYRO_LEVEL == 1
+  { PARAMETER_PITCH_CALIBRATION, pitchName, PARAMETER_FLOAT, PARAMETER_PERSISTENT, -90.0f, 90.0f, getPitchCalibration, setPitchCalibration },
+  { PARAMETER_ROLL_CALIBRATION, rollName, PARAMETER_FLOAT, PARAMETER_PERSISTENT, -90.0f, 90.0f, getRollCalibration, setRollCalibration },
+#endif
+  { PARAMETER_RA_PARKING_POSITION, raParkingName, PARAMETER_INT32, PARAMETER_PERSISTENT, -2147483648.0f, 2147483647.0f, getRAParkingPosition, setRAParkingPosition },
+  { PARAMETER_DEC_PARKING_POSITION, decParkingName, PARAMETER_INT32, PARAMETER_PERSISTENT, -2147483648.0f, 2147483647.0f, getDECParkingPosition, setDECParkingPosition },
+  { PARAMETER_DEC_LOWER_LIMIT, decLowerLimitName, PARAMETER_INT32, PARAMETER_PERSISTENT, -2147483648.0f, 2147483647.0f, getDECLowerLimit, setDECLowerLimit },
+  { PARAMETER_DEC_UPPER_LIMIT, decUpperLimitName, PARAMETER_INT32, PARAMETER_PERSISTENT, -2147483648.0f, 2147483647.0f, getDECUpperLimit, setDECUpperLimit },
+  { PARAMETER_TRACKING_SPEED, trackingSpeedName, PARAMETER_FLOAT, PARAMETER_READONLY, 0.0f, 0.0f, getTrackingSpeed, nullptr },
+};
+
+byte Parameters::count()
+{
+  return sizeof(registry) / sizeof(registry[0]);
+}
+
+void Parameters::describe(byte index, Parameter& parameter)
+{
+  memcpy_P(&parameter, &registry[index], sizeof(Parameter));
+}
+
+bool Parameters::find(byte id, Parameter& parameter)
+{
+  for (byte i = 0; i < count(); i++) {
+    describe(i, parameter);
+    if (parameter.id == id) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool Parameters::get(Mount* mount, byte id, ParameterValue& value)
+{
+  Parameter parameter;
+  if (!find(id, parameter)) {
+    return false;
+  }
+  parameter.get(mount, value);
+  return true;
+}
+
+bool Parameters::set(Mount* mount, byte id, const ParameterValue& value)
+{
+  Parameter parameter;
+  if (!find(id, parameter) || (parameter.flags & PARAMETER_READONLY)) {
+    return false;
+  }
+  float number = (parameter.type == PARAMETER_FLOAT) ? value.real : (float)value.integer;
+  if (isnan(number) || (number < parameter.minimum) || (number > parameter.maximum)) {
+    LOGV3(DEBUG_MOUNT, F("Parameters: %d is out of range (%f)"), id, number);
+    return false;
+  }
+  parameter.apply(mount, value);
+  return true;
+}
+
+String Parameters::format(const Parameter& parameter, const ParameterValue& value)
+{
+  if (parameter.type == PARAMETER_FLOAT) {
+    return String(value.real, 6);
+  }
+  return String(value.integer);
+}
+
+bool Parameters::parse(const Parameter& parameter, const char* text, ParameterValue& value)
+{
+  char* end;
+  if (parameter.type == PARAMETER_FLOAT) {
+    value.real = (float)strtod(text, &end);
+  }
+  else {
+    value.integer = strtol(text, &end, 10);
+  }
+  return (end != text) && (*end == '\0');
+}
+
+/////////////////////////////////
+// Parameter images
+/////////////////////////////////
+static const char hexDigits[] = "0123456789ABCDEF";
+
+static void appendHex(String& image, byte value)
+{
+  image += hexDigits[value >> 4];
+  image += hexDigits[value & 0x0F];
+}
+
+static int hexValue(char digit)
+{
+  if ((digit >= '0') && (digit <= '9')) return digit - '0';
+  if ((digit >= 'A') && (digit <= 'F')) return digit - 'A' + 10;
+  if ((digit >= 'a') && (digit <= 'f')) return digit - 'a' + 10;
+  return -1;
+}
+
+// Reads two hex digits, false if there are not two
+static bool readHex(const char*& hex, byte& value)
+{
+  int high = hexValue(hex[0]);
+  int low = (high < 0) ? -1 : hexValue(hex[1]);
+  if (low < 0) {
+    return false;
+  }
+  value = (high << 4) | low;
+  hex += 2;
+  return true;
+}
+
+String Parameters::readImage(Mount* mount)
+{
+  String image;
+  image.reserve(count() * 10);
+  Parameter parameter;
+  for (byte i = 0; i < count(); i++) {
+    describe(i, parameter);
+    if (parameter.flags & PARAMETER_READONLY) {
+      continue;
+    }
+    ParameterValue value;
+    parameter.get(mount, value);
+    uint32_t bits = value.integer;
+    if (parameter.type == PARAMETER_FLOAT) {
+      memcpy(&bits, &value.real, sizeof(bits));
+    }
+    appendHex(image, parameter.id);
+    for (byte b = 0; b < PARAMETER_TYPE_SIZE(parameter.type); b++) {
+      appendHex(image, (bits >> (8 * b)) & 0xFF);
+    }
+  }
+  return image;
+}
+
+bool Parameters::writeImage(Mount* mount, const char* hex)
+{
+  while (*hex != '\0') {
+    byte id;
+    Parameter parameter;
+    if (!readHex(hex, id) || !find(id, parameter)) {
+      return false;
+    }
+    byte size = PARAMETER_TYPE_SIZE(parameter.type);
+    uint32_t bits = 0;
+    for (byte b = 0; b < size; b++) {
+      byte part;
+      if (!readHex(hex, part)) {
+        return false;
+      }
+      bits |= (uint32_t)part << (8 * b);
+    }
+
+    ParameterValue value;
+    if (parameter.type == PARAMETER_FLOAT) {
+      memcpy(&value.real, &bits, sizeof(bits));
+    }
+    else if (parameter.type == PARAMETER_INT16) {
+      value.integer = (int16_t)bits;
+    }
+    else if (parameter.type == PARAMETER_INT32) {
+      value.integer = (int32_t)bits;
+    }
+    else {
+      value.integer = bits;
+    }
+    if (!set(mount, id, value)) {
+      return false;
+    }
+  }
+  return true;
+}
@@ -0,0 +1,89 @@
+#pragma once
+
+#include "inc/Globals.hpp"
+
+// Forward declarations
+class Mount;
+
+// The type of a parameter value, which is also how many bytes it takes in a parameter image
+enum ParameterType : byte {
+  PARAMETER_BYTE = 1,
+  PARAMETER_INT16 = 2,
+  PARAMETER_INT32 = 4,
+  PARAMETER_FLOAT = 0x84,   // 4 bytes, IEEE 754
+};
+#define PARAMETER_TYPE_SIZE(type) ((type) & 0x07)
+
+// Parameter flags
+#define PARAMETER_PERSISTENT  B00000001   // Setting it stores it in EEPROM
+#define PARAMETER_READONLY    B00000010   // Can only be read
+
+// The ids of the parameters. These are what clients store, so never change or reuse one.
+enum ParameterId : byte {
+  PARAMETER_RA_STEPS_PER_DEGREE = 1,
+  PARAMETER_DEC_STEPS_PER_DEGREE = 2,
+  PARAMETER_SPEED_CALIBRATION = 3,
+  PARAMETER_BACKLASH_STEPS = 4,
+  PARAMETER_LATITUDE = 5,
+  PARAMETER_LONGITUDE = 6,
+  PARAMETER_PITCH_CALIBRATION = 7,
+  PARAMETER_ROLL_CALIBRATION = 8,
+  PARAMETER_RA_PARKING_POSITION = 9,
+  PARAMETER_DEC_PARKING_POSITION = 10,
+  PARAMETER_DEC_LOWER_LIMIT = 11,
+  PARAMETER_DEC_UPPER_LIMIT = 12,
+  PARAMETER_TRACKING_SPEED = 13,
+};
+
+union ParameterValue {
+  long integer;   // PARAMETER_BYTE, PARAMETER_INT16, PARAMETER_INT32
+  float real;     // PARAMETER_FLOAT
+};
+
+struct Parameter {
+  byte id;
+  const char* name;   // In PROGMEM
+  byte type;
+  byte flags;
+  float minimum;
+  float maximum;
+  void (*get)(Mount* mount, ParameterValue& value);
+  void (*apply)(Mount* mount, const ParameterValue& value);   // nullptr for PARAMETER_READONLY
+};
+
+//////////////////////////////////////
+// The registry of the mount's tunable settings.
+//
+// Each setting is described once, in a table in flash, with the accessors of Mount that read and
+// apply it. The Meade :XP commands get, set and list any of them, and read or restore all of
+// them as one parameter image: per parameter its id and then its value in PARAMETER_TYPE_SIZE
+// bytes, least significant byte first.
+//////////////////////////////////////
+class Parameters
+{
+public:
+  // The number of parameters in this configuration
+  static byte count();
+
+  // Copies the description of the index-th parameter out of flash
+  static void describe(byte index, Parameter& parameter);
+
+  // Finds the parameter with the given id. False if there is none.
+  static bool find(byte id, Parameter& parameter);
+
+  static bool get(Mount* mount, byte id, ParameterValue& value);
+
+  // Applies the value. False if the parameter does not exist, is read-only or the value is out of its range.
+  static bool set(Mount* mount, byte id, const ParameterValue& value);
+
+  // Text form of a value, as the :XP commands use it
+  static String format(const Parameter& parameter, const ParameterValue& value);
+  static bool parse(const Parameter& parameter, const char* text, ParameterValue& value);
+
+  // The image of all parameters that can be set, as hex digits
+  static String readImage(Mount* mount);
+
+  // Applies the parameters in an image (or part of one) in hex digits. Stops at the first one that
+  // cannot be set and returns false.
+  static bool writeImage(Mount* mount, const char* hex);
+};
@@ -0,0 +1,182 @@
+#include "../Configuration.hpp"
+#include "Utility.hpp"
+#include "Mount.hpp"
+#include "Sequencer.hpp"
+
+// How often a waiting target checks its start condition. Altitude needs the pointing math.
+#define START_CHECK_INTERVAL 1000
+
+Sequencer::Sequencer(Mount* mount)
+{
+  _mount = mount;
+  _count = 0;
+  _current = 0;
+  _endAction = SEQUENCE_END_PARK;
+  _state = IDLE;
+  _stateSince = 0;
+  _lastCheck = 0;
+  _lastDither = 0;
+  _slew = 0;
+}
+
+bool Sequencer::add(const SequenceTarget& target)
+{
+  if ((_count >= SEQUENCE_MAX_TARGETS) || ((_state != IDLE) && (_state != DONE))) {
+    return false;
+  }
+  _targets[_count++] = target;
+  LOGV3(DEBUG_MOUNT, F("Sequencer: Added target %d (%c)"), _count, target.startCondition);
+  return true;
+}
+
+void Sequencer::clear()
+{
+  stop();
+  _count = 0;
+  _current = 0;
+}
+
+void Sequencer::setEndAction(char endAction)
+{
+  _endAction = endAction;
+}
+
+bool Sequencer::start()
+{
+  if (_count == 0) {
+    return false;
+  }
+  LOGV2(DEBUG_MOUNT, F("Sequencer: Starting %d targets"), _count);
+  startTarget(0);
+  return true;
+}
+
+void Sequencer::stop()
+{
+  if (_state != IDLE) {
+    LOGV2(DEBUG_MOUNT, F("Sequencer: Stopped at target %d"), _current + 1);
+  }
+  _state = IDLE;
+}
+
+long Sequencer::stateSeconds() const
+{
+  if ((_state == IDLE) || (_state == DONE)) {
+    return 0;
+  }
+  long seconds = (millis() - _stateSince) / 1000;
+  if (_state == ON_TARGET) {
+    return _targets[_current].trackSeconds - seconds;
+  }
+  return seconds;
+}
+
+void Sequencer::enterState(State state)
+{
+  _state = state;
+  _stateSince = millis();
+}
+
+void Sequencer::startTarget(byte index)
+{
+  _current = index;
+  enterState(WAITING);
+  _lastCheck = _stateSince - START_CHECK_INTERVAL;
+}
+
+bool Sequencer::startConditionMet(const SequenceTarget& target) const
+{
+  switch (target.startCondition) {
+    case SEQUENCE_START_AT_TIME: {
+      // Within the 12 hours after the time, so a time just past midnight waits through the evening
+      long sinceStart = _mount->getLocalTime().getTotalSeconds() - target.startValue;
+      if (sinceStart < 0) {
+        sinceStart += 24L * 3600L;
+      }
+      return sinceStart < 12L * 3600L;
+    }
+
+    case SEQUENCE_START_ALTITUDE: {
+      long altitude, azimuth;
+      _mount->altAzOf(target.ra, target.dec, altitude, azimuth);
+      return altitude >= target.startValue * 3600L;
+    }
+
+    case SEQUENCE_START_MERIDIAN:
+      return _mount->hourAngleOf(target.ra) >= target.startValue * 60L;
+
+    default:
+      return true;
+  }
+}
+
+void Sequencer::loop()
+{
+  if ((_state == IDLE) || (_state == DONE)) {
+    return;
+  }
+
+  if ((_state != SLEWING) && (_mount->isParked() || _mount->isParking())) {
+    LOGV1(DEBUG_MOUNT, F("Sequencer: The mount parks, stopping."));
+    stop();
+    return;
+  }
+
+  unsigned long now = millis();
+  const SequenceTarget& target = _targets[_current];
+  switch (_state) {
+    case WAITING:
+      if (now - _lastCheck < START_CHECK_INTERVAL) {
+        break;
+      }
+      _lastCheck = now;
+      if (startConditionMet(target)) {
+        LOGV4(DEBUG_MOUNT, F("Sequencer: Target %d starts, slewing to %s %s"), _current + 1, target.ra.ToString(), target.dec.ToString());
+        _mount->targetRA() = target.ra;
+        _mount->targetDEC() = target.dec;
+        _mount->startSlewingToTarget();
+        _slew = _mount->targetSlews();
+        enterState(SLEWING);
+      }
+      break;
+
+    case SLEWING:
+      if (_mount->isSlewingRAorDEC()) {
+        break;
+      }
+      if ((_mount->targetSlews() != _slew) || !_mount->slewReachedTarget()) {
+        // Stopped (:Q), moved by hand, held back by the DEC limits, or another slew took over
+        LOGV2(DEBUG_MOUNT, F("Sequencer: The slew to target %d did not get there, stopping."), _current + 1);
+        stop();
+      }
+      else {
+        LOGV2(DEBUG_MOUNT, F("Sequencer: On target %d"), _current + 1);
+        enterState(ON_TARGET);
+        _lastDither = now;
+      }
+      break;
+
+    case ON_TARGET:
+      if (now - _stateSince >= target.trackSeconds * 1000UL) {
+        if (_current + 1 < _count) {
+          startTarget(_current + 1);
+        }
+        else {
+          LOGV2(DEBUG_MOUNT, F("Sequencer: Done, end action %c"), _endAction);
+          enterState(DONE);
+          if (_endAction == SEQUENCE_END_PARK) {
+            _mount->park();
+          }
+        }
+      }
+      else if ((target.ditherSeconds != 0) && (now - _lastDither >= target.ditherSeconds * 1000UL)) {
+        // Skipped while a guide pulse (of a client, or the last dither) runs
+        _mount->dither(DITHER_SPIRAL, target.ditherArcseconds);
+        _lastDither = now;
+      }
+      break;
+
+    default:
+      break;
+  }
+}
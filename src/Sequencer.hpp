@@ -0,0 +1,85 @@
+#pragma once
+
+#include "Declination.hpp"
+
+// Forward declarations
+class Mount;
+
+// When a target of a sequence may start
+#define SEQUENCE_START_NOW        'N'
+#define SEQUENCE_START_AT_TIME    'T'   // startValue is the local time in seconds after midnight
+#define SEQUENCE_START_ALTITUDE   'A'   // startValue is the altitude in degrees the target must have risen to
+#define SEQUENCE_START_MERIDIAN   'M'   // startValue is the minutes the target must be past the meridian (negative for before it)
+
+// What the mount does after the last target
+#define SEQUENCE_END_TRACK        'T'   // Keep tracking the last target
+#define SEQUENCE_END_PARK         'P'
+
+struct SequenceTarget {
+  DayTime ra;
+  Declination dec;
+  char startCondition;
+  long startValue;
+  unsigned int trackSeconds;    // How long to stay on the target once there
+  unsigned int ditherSeconds;   // Dither every this many seconds while on the target, 0 for never
+  unsigned int ditherArcseconds;  // How far the dithers go from the target, on the sky
+};
+
+//////////////////////////////////////
+// Runs a queue of targets on the mount, so an imaging session goes on without a PC.
+//
+// Each target waits for its start condition while the mount keeps tracking where it is, then
+// the mount slews to it and tracks it for its time, dithering in a spiral around it (see
+// Mount::dither()). After the last target the mount parks
+// or keeps tracking. Mount::loop() runs it and nothing in it waits, so serial and WiFi clients
+// can come and go. Parking the mount, or :XQX, stops it, and so does a slew to a target that
+// does not get there.
+//////////////////////////////////////
+class Sequencer
+{
+public:
+  enum State : char {
+    IDLE = 'I',
+    WAITING = 'W',    // For the start condition of the current target
+    SLEWING = 'S',
+    ON_TARGET = 'T',  // Tracking it for its time
+    DONE = 'D',       // Ran the last target
+  };
+
+  Sequencer(Mount* mount);
+
+  // Adds a target to the end of the queue. False if the queue is full (SEQUENCE_MAX_TARGETS) or it is running.
+  bool add(const SequenceTarget& target);
+  void clear();
+  void setEndAction(char endAction);
+
+  // Starts at the first target. False if there are none.
+  bool start();
+  void stop();
+
+  // Moves the sequence on. Called from Mount::loop().
+  void loop();
+
+  State state() const { return _state; }
+  byte currentTarget() const { return _current; }
+  byte targetCount() const { return _count; }
+
+  // Seconds until the current target is done tracking, or that it has been waiting for its start
+  long stateSeconds() const;
+
+private:
+  bool startConditionMet(const SequenceTarget& target) const;
+  void startTarget(byte index);
+  void enterState(State state);
+
+  Mount* _mount;
+  SequenceTarget _targets[SEQUENCE_MAX_TARGETS];
+  byte _count;
+  byte _current;
+  char _endAction;
+  State _state;
+  unsigned long _stateSince;    // millis() when the state was entered
+  unsigned long _lastCheck;     // millis() when the start condition was last checked
+  unsigned long _lastDither;
+  byte _slew;                   // Mount::targetSlews() of the slew to the current target
+};
@@ -0,0 +1,223 @@
+#include "../Configuration.hpp"
+#include "Utility.hpp"
+#include "SessionLog.hpp"
+
+// SESSION_LOG_SIZE 0 leaves the log out, but keeps the code building
+#define RING_SIZE ((SESSION_LOG_SIZE > 0) ? SESSION_LOG_SIZE : 1)
+
+SessionLog::SessionLog()
+{
+  _recording = (SESSION_LOG_SIZE > 0);
+  clear();
+}
+
+void SessionLog::clear()
+{
+  _started = false;
+  _written = 0;
+  _dropped = 0;
+  _recordLength = 0;
+}
+
+void SessionLog::setRecording(bool recording)
+{
+  _recording = recording && (SESSION_LOG_SIZE > 0);
+}
+
+void SessionLog::update(long ra, long dec, long trk, unsigned long rate, int status)
+{
+  if (!_recording) {
+    return;
+  }
+  if (rate > SESSION_LOG_MAX_RATE) {
+    rate = 0;
+  }
+
+  unsigned long now = millis();
+  if (!_started) {
+    _started = true;
+    _tick = now / SESSION_LOG_TICK;
+    _lastSample = now;
+    _ra = ra;
+    _dec = dec;
+    _trk = trk;
+    _status = status;
+    _rate = rate;
+    _rateTick = _tick;
+    _startTick = _tick;
+    _startRA = ra;
+    _startDEC = dec;
+    _startTRK = trk;
+    _startStatus = status;
+    _startRate = rate;
+    _startRateTick = _tick;
+    return;
+  }
+
+  if (status != _status) {
+    beginRecord('T');
+    addValue((unsigned int)status);
+    endRecord();
+    _status = status;
+  }
+
+  if (rate != _rate) {
+    // TRK moved at the old rate up to here
+    beginRecord('R');
+    _trk += predictedSteps(_rate, _tick - _rateTick);
+    _rateTick = _tick;
+    addValue(rate);
+    endRecord();
+    _rate = rate;
+  }
+
+  if (now - _lastSample >= SESSION_LOG_INTERVAL) {
+    _lastSample = now;
+    long trkPredicted = _trk + predictedSteps(_rate, now / SESSION_LOG_TICK - _rateTick);
+    if ((ra != _ra) || (dec != _dec) || (abs(trk - trkPredicted) > 1)) {
+      beginRecord('S');
+      _trk += predictedSteps(_rate, _tick - _rateTick);
+      _rateTick = _tick;
+      addSignedValue(ra - _ra);
+      addSignedValue(dec - _dec);
+      addSignedValue(trk - _trk);
+      endRecord();
+      _ra = ra;
+      _dec = dec;
+      _trk = trk;
+    }
+  }
+}
+
+long SessionLog::predictedSteps(unsigned long rate, unsigned long ticks)
+{
+  // Both are capped, so this fits in 32 bits
+  ticks = min(ticks, SESSION_LOG_PREDICT_TICKS);
+  return (rate * ticks + 50000UL) / 100000UL;
+}
+
+void SessionLog::addGuidePulse(byte direction, int duration)
+{
+  if (_recording && _started) {
+    beginRecord('G');
+    addValue(direction);
+    addValue(duration);
+    endRecord();
+  }
+}
+
+void SessionLog::addSlew(long targetRA, long targetDEC)
+{
+  if (_recording && _started) {
+    beginRecord('M');
+    addSignedValue(targetRA);
+    addSignedValue(targetDEC);
+    endRecord();
+  }
+}
+
+void SessionLog::getStart(unsigned long& tick, long& ra, long& dec, long& trk, int& status, unsigned long& rate, unsigned long& rateTick) const
+{
+  tick = _startTick;
+  ra = _startRA;
+  dec = _startDEC;
+  trk = _startTRK;
+  status = _startStatus;
+  rate = _startRate;
+  rateTick = _startRateTick;
+}
+
+byte SessionLog::read(unsigned long& offset, byte* bytes, byte maxLength) const
+{
+  if (offset < _dropped) {
+    offset = _dropped;
+  }
+  byte length = 0;
+  while ((length < maxLength) && (offset + length < _written)) {
+    bytes[length] = _ring[(offset + length) % RING_SIZE];
+    length++;
+  }
+  return length;
+}
+
+void SessionLog::beginRecord(char type)
+{
+  unsigned long now = millis() / SESSION_LOG_TICK;
+  _record[0] = type;
+  _recordLength = 1;
+  addValue(now - _tick);
+  _tick = now;
+}
+
+void SessionLog::addValue(unsigned long value)
+{
+  // 7 bits at a time, the top bit says that more follow
+  while (value >= 0x80) {
+    _record[_recordLength++] = (value & 0x7F) | 0x80;
+    value >>= 7;
+  }
+  _record[_recordLength++] = value;
+}
+
+void SessionLog::addSignedValue(long value)
+{
+  // Zigzag, so small negative values stay short too
+  addValue(((unsigned long)value << 1) ^ (unsigned long)(value >> 31));
+}
+
+void SessionLog::endRecord()
+{
+  while (_written - _dropped + _recordLength > RING_SIZE) {
+    dropRecord();
+  }
+  for (byte i = 0; i < _recordLength; i++) {
+    _ring[(_written + i) % RING_SIZE] = _record[i];
+  }
+  _written += _recordLength;
+}
+
+unsigned long SessionLog::readValue(unsigned long& offset) const
+{
+  unsigned long value = 0;
+  byte shift = 0;
+  byte b;
+  do {
+    b = _ring[offset++ % RING_SIZE];
+    value |= (unsigned long)(b & 0x7F) << shift;
+    shift += 7;
+  } while (b & 0x80);
+  return value;
+}
+
+void SessionLog::dropRecord()
+{
+  unsigned long offset = _dropped;
+  char type = _ring[offset++ % RING_SIZE];
+  _startTick += readValue(offset);
+  if ((type == 'S') || (type == 'R')) {
+    _startTRK += predictedSteps(_startRate, _startTick - _startRateTick);
+    _startRateTick = _startTick;
+  }
+  if (type == 'S') {
+    long moved[3];
+    for (byte i = 0; i < 3; i++) {
+      unsigned long value = readValue(offset);
+      moved[i] = (long)(value >> 1) ^ -(long)(value & 1);
+    }
+    _startRA += moved[0];
+    _startDEC += moved[1];
+    _startTRK += moved[2];
+  }
+  else if (type == 'R') {
+    _startRate = readValue(offset);
+  }
+  else if (type == 'T') {
+    _startStatus = readValue(offset);
+  }
+  else {
+    readValue(offset);
+    readValue(offset);
+  }
+  LOGV3(DEBUG_GENERAL, F("SessionLog: Dropped %c record of %l bytes"), type, offset - _dropped);
+  _dropped = offset;
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "inc/Globals.hpp"
+
+// The unit of the record times, in ms
+#define SESSION_LOG_TICK    10
+
+// Added to the direction of a guide pulse record for the pulses of a dither
+#define SESSION_LOG_DITHER  B10000000
+
+// The fastest tracking rate that is logged, in TRK steps per 1000s. Faster ones are logged as 0.
+#define SESSION_LOG_MAX_RATE      100000UL
+
+// How far past the last 'S' or 'R' record the tracking rate predicts TRK, in SESSION_LOG_TICK ms
+#define SESSION_LOG_PREDICT_TICKS 6000UL
+
+//////////////////////////////////////
+// Records what the mount does in a RAM ring of SESSION_LOG_SIZE bytes, to find out afterwards why a
+// frame trailed.
+//
+// Each record is a type letter followed by unsigned LEB128 varints. The first one is the time since
+// the record before in SESSION_LOG_TICK ms, signed values are zigzag encoded:
+//   'S' sample   time, RA and DEC steps moved, and TRK steps moved beyond what the tracking rate predicts
+//   'R' rate     time, new tracking rate in TRK steps per 1000s (0 while it does not track)
+//   'G' guide    time, direction (NORTH etc., SESSION_LOG_DITHER for dithers), duration in ms
+//   'M' slew     time, target RA and DEC stepper positions
+//   'T' status   time, new mount status
+// The tracking rate predicts that TRK moved (rate * ticks + 50000) / 100000 steps since the last 'S' or
+// 'R' record, with ticks at most SESSION_LOG_PREDICT_TICKS. 'S' and 'R' records add that to TRK before
+// anything else. A sample is only written, every SESSION_LOG_INTERVAL ms, when RA or DEC moved or TRK
+// is more than a step away from the prediction, so steady tracking takes one 'S' record a minute.
+// When the ring is full the oldest records are dropped, and folded into the state they started
+// from (see getStart()), so the log always decodes from its first byte. Bytes are numbered from
+// when the log was cleared, so a client can read it in chunks. session_log.py decodes it.
+//////////////////////////////////////
+class SessionLog
+{
+public:
+  SessionLog();
+
+  // Forgets all records. The next update() starts the log from the mount state then.
+  void clear();
+
+  // While paused nothing is recorded, e.g. so nothing is dropped during a download
+  void setRecording(bool recording);
+  bool isRecording() const { return _recording; }
+
+  // Records the status and tracking rate (TRK steps per 1000s) when they changed, and a sample every
+  // SESSION_LOG_INTERVAL ms. Called from Mount::loop().
+  void update(long ra, long dec, long trk, unsigned long rate, int status);
+
+  void addGuidePulse(byte direction, int duration);
+  void addSlew(long targetRA, long targetDEC);
+
+  // The byte numbers the ring holds, from start up to (not including) end
+  unsigned long start() const { return _dropped; }
+  unsigned long end() const { return _written; }
+
+  // The state the first byte starts from: its time in SESSION_LOG_TICK ms, the stepper positions and status,
+  // the tracking rate and the time that TRK is predicted from
+  void getStart(unsigned long& tick, long& ra, long& dec, long& trk, int& status, unsigned long& rate, unsigned long& rateTick) const;
+
+  // Copies up to maxLength bytes from byte number offset (or start(), if those were dropped). Returns how many.
+  byte read(unsigned long& offset, byte* bytes, byte maxLength) const;
+
+private:
+  void beginRecord(char type);
+  void addValue(unsigned long value);
+  void addSignedValue(long value);
+  void endRecord();
+  unsigned long readValue(unsigned long& offset) const;
+  void dropRecord();
+  static long predictedSteps(unsigned long rate, unsigned long ticks);
+
+  bool _recording;
+  bool _started;
+  byte _ring[(SESSION_LOG_SIZE > 0) ? SESSION_LOG_SIZE : 1];
+  unsigned long _written;         // Bytes written since clear()
+  unsigned long _dropped;         // Bytes dropped since clear()
+
+  byte _record[1 + 4 * 5];        // The record being put together, its type and at most 4 values of 5 bytes
+  byte _recordLength;
+
+  // The state at the end of the log
+  unsigned long _tick;
+  unsigned long _lastSample;      // millis()
+  long _ra;
+  long _dec;
+  long _trk;
+  int _status;
+  unsigned long _rate;
+  unsigned long _rateTick;        // Of the last 'S' or 'R' record
+
+  // The state at the start of it
+  unsigned long _startTick;
+  long _startRA;
+  long _startDEC;
+  long _startTRK;
+  int _startStatus;
+  unsigned long _startRate;
+  unsigned long _startRateTick;
+};
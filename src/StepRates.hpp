@@ -0,0 +1,57 @@
+#pragma once
+
+#include "../Configuration.hpp"
+
+// Seconds per astronomical day (23h 56m 4.0905s)
+#define SECONDS_PER_DAY 86164.0905
+
+constexpr float siderealDegreesInHour = 14.95904348958;
+
+//////////////////////////////////////
+// The step rates the configuration asks of the stepper interrupt, evaluated at compile time.
+//
+// The interrupt makes at most STEPPER_MAX_STEP_RATE steps per second on a motor. A slew that is
+// too fast only takes longer (Configuration.hpp warns about it), but tracking or guiding that the
+// interrupt cannot keep up with would point the mount wrong, so they fail the build here. The
+// error names the highest microstepping that fits, as the template argument of the failing check.
+//
+// The rates use the configured steps per degree, not a calibration stored in EEPROM.
+//////////////////////////////////////
+namespace StepRates
+{
+  // u-steps/s of RA tracking, before the speed calibration (as in Mount::setSpeedCalibration())
+  constexpr float raTracking = RA_STEPS_PER_DEGREE * (RA_TRACKING_MICROSTEPPING / RA_SLEW_MICROSTEPPING) * 360.0 / SECONDS_PER_DAY;
+
+  // u-steps/s of the fastest guide pulses (as in Mount::guidePulse())
+  constexpr float raGuiding = (RA_PULSE_MULTIPLIER + 1) * RA_STEPS_PER_DEGREE * (RA_TRACKING_MICROSTEPPING / RA_SLEW_MICROSTEPPING) * siderealDegreesInHour / 3600.0f;
+  constexpr float decGuiding = DEC_PULSE_MULTIPLIER * DEC_STEPS_PER_DEGREE * (DEC_GUIDE_MICROSTEPPING / DEC_SLEW_MICROSTEPPING) * siderealDegreesInHour / 3600.0f;
+
+  // The highest microstepping, from 256 down, at which a rate of stepsPerSecond at full steps fits the interrupt
+  constexpr int highestMicrostepping(float stepsPerSecond, int microstepping = 256)
+  {
+    return ((microstepping <= 1) || (stepsPerSecond * microstepping <= STEPPER_MAX_STEP_RATE))
+      ? microstepping
+      : highestMicrostepping(stepsPerSecond, microstepping / 2);
+  }
+
+#if (STEPPER_MAX_STEP_RATE > 0)
+
+  #if RA_HARDWARE_TRACKING == 0
+    // RA_HARDWARE_TRACKING steps tracking and guiding with a timer, not the interrupt
+    template <int feasible>
+    struct RATrackingMicrosteppingAtMost
+    {
+      static_assert(RA_TRACKING_MICROSTEPPING <= feasible, "RA guiding needs more steps/s than the stepper interrupt can make. Lower RA_TRACKING_MICROSTEPPING to the value in this error.");
+    };
+    static_assert(sizeof(RATrackingMicrosteppingAtMost<highestMicrostepping(raGuiding / RA_TRACKING_MICROSTEPPING)>) > 0, "");
+  #endif
+
+  template <int feasible>
+  struct DECGuideMicrosteppingAtMost
+  {
+    static_assert(DEC_GUIDE_MICROSTEPPING <= feasible, "DEC guiding needs more steps/s than the stepper interrupt can make. Lower DEC_GUIDE_MICROSTEPPING to the value in this error.");
+  };
+  static_assert(sizeof(DECGuideMicrosteppingAtMost<highestMicrostepping(decGuiding / DEC_GUIDE_MICROSTEPPING)>) > 0, "");
+
+#endif
+}
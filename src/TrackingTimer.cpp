@@ -0,0 +1,204 @@
+#include "../Configuration.hpp"
+#include "TrackingTimer.hpp"
+
+#ifndef F_CPU
+  #define F_CPU 16000000UL  // The host build models the Mega's clock
+#endif
+
+// Fewer ticks between toggles than this leave the compare interrupt no time to load the next half period
+#define MIN_HALF_PERIOD_TICKS 160
+
+static const unsigned int prescalers[] = { 1, 8, 64, 256, 1024 };  // Clock select 1 to 5
+
+bool TrackingTimer::timing(float stepsPerSecond, byte& clockSelect, unsigned long& halfPeriod)
+{
+  if (stepsPerSecond <= 0.0f) {
+    return false;
+  }
+  for (byte i = 0; i < 5; i++) {
+    float ticks = (F_CPU * 128.0f) / (prescalers[i] * stepsPerSecond);  // 256ths of a tick, per half step
+    if (ticks < MIN_HALF_PERIOD_TICKS * 256.0f) {
+      return false;
+    }
+    if (ticks < 65536.0f * 256.0f) {
+      clockSelect = i + 1;
+      halfPeriod = (unsigned long)(ticks + 0.5f);
+      return true;
+    }
+  }
+  return false;
+}
+
+#if RA_HARDWARE_TRACKING == 1
+
+#if defined(__AVR_ATmega2560__)
+
+#include <util/atomic.h>
+
+// The registers of the timer of the STEP pin: TIMER_REG(TCCR, A) is TCCR3A for Timer3
+#if RA_STEP_PIN == 5
+  #define STEP_TIMER 3
+#elif RA_STEP_PIN == 6
+  #define STEP_TIMER 4
+#elif RA_STEP_PIN == 46
+  #define STEP_TIMER 5
+#endif
+#define TIMER_REG__(prefix, timer, suffix) prefix##timer##suffix
+#define TIMER_REG_(prefix, timer, suffix) TIMER_REG__(prefix, timer, suffix)
+#define TIMER_REG(prefix, suffix) TIMER_REG_(prefix, STEP_TIMER, suffix)
+
+static volatile unsigned long _toggles = 0;
+static volatile unsigned long _halfPeriod = 0;  // 1/256 ticks
+static volatile byte _fraction = 0;
+static volatile byte _newClockSelect = 0;       // Prescaler to switch to at the next toggle, 0 for none
+static bool _running = false;
+
+// The counter has just been cleared and the pin toggled
+ISR(TIMER_REG(TIMER, _COMPA_vect))
+{
+  _toggles++;
+  unsigned int fraction = _fraction + (byte)_halfPeriod;
+  _fraction = (byte)fraction;
+  TIMER_REG(OCR, A) = (unsigned int)(_halfPeriod >> 8) - 1 + (fraction >> 8);
+  if (_newClockSelect) {
+    TIMER_REG(TCCR, B) = _BV(TIMER_REG(WGM, 2)) | _newClockSelect;
+    _newClockSelect = 0;
+  }
+}
+
+bool TrackingTimer::start(float stepsPerSecond)
+{
+  byte clockSelect;
+  unsigned long halfPeriod;
+  if (!timing(stepsPerSecond, clockSelect, halfPeriod)) {
+    return false;
+  }
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    TIMER_REG(TCCR, B) = 0;
+    TIMER_REG(TCNT, ) = 0;
+    _toggles = 0;
+    _fraction = 0;
+    _newClockSelect = 0;
+    _halfPeriod = halfPeriod;
+    TIMER_REG(OCR, A) = (unsigned int)(halfPeriod >> 8) - 1;
+    TIMER_REG(TCCR, A) = _BV(TIMER_REG(COM, A0));          // Toggle OCnA on compare match
+    TIMER_REG(TIFR, ) = _BV(TIMER_REG(OCF, A));
+    TIMER_REG(TIMSK, ) |= _BV(TIMER_REG(OCIE, A));
+    TIMER_REG(TCCR, B) = _BV(TIMER_REG(WGM, 2)) | clockSelect;  // CTC, OCRnA is TOP
+    _running = true;
+  }
+  return true;
+}
+
+bool TrackingTimer::setRate(float stepsPerSecond)
+{
+  byte clockSelect;
+  unsigned long halfPeriod;
+  if (!timing(stepsPerSecond, clockSelect, halfPeriod)) {
+    return false;
+  }
+
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    _halfPeriod = halfPeriod;
+    if ((TIMER_REG(TCCR, B) & 0x07) != clockSelect) {
+      _newClockSelect = clockSelect;
+    }
+  }
+  return true;
+}
+
+long TrackingTimer::stop()
+{
+  long made;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    TIMER_REG(TCCR, B) = 0;
+    TIMER_REG(TIMSK, ) &= ~_BV(TIMER_REG(OCIE, A));
+    if (_toggles & 1) {
+      // STEP is high. Force the falling edge, so the pin (and the next start) is low again.
+      TIMER_REG(TCCR, C) = _BV(TIMER_REG(FOC, A));
+    }
+    TIMER_REG(TCCR, A) = 0;  // Back to the port, which holds STEP low for software steps
+    made = (_toggles + 1) >> 1;
+    _toggles = 0;
+    _running = false;
+  }
+  return made;
+}
+
+long TrackingTimer::steps()
+{
+  unsigned long toggles;
+  ATOMIC_BLOCK(ATOMIC_RESTORESTATE) {
+    toggles = _toggles;
+  }
+  return (toggles + 1) >> 1;
+}
+
+bool TrackingTimer::isRunning()
+{
+  return _running;
+}
+
+#elif defined(OAT_HOST_BUILD)
+
+// The steps the timer would have made in virtual time. A rate change keeps the fraction of
+// the step in progress, as the timer does.
+static bool _running = false;
+static float _rate = 0.0f;
+static unsigned long _since = 0;  // micros() of the last rate change
+static double _stepsBefore = 0;   // Steps (and fraction) made before the last rate change
+
+static double elapsedSteps()
+{
+  return _stepsBefore + (micros() - _since) * (double)_rate / 1000000.0;
+}
+
+bool TrackingTimer::start(float stepsPerSecond)
+{
+  byte clockSelect;
+  unsigned long halfPeriod;
+  if (!timing(stepsPerSecond, clockSelect, halfPeriod)) {
+    return false;
+  }
+  _rate = stepsPerSecond;
+  _since = micros();
+  _stepsBefore = 0;
+  _running = true;
+  return true;
+}
+
+bool TrackingTimer::setRate(float stepsPerSecond)
+{
+  byte clockSelect;
+  unsigned long halfPeriod;
+  if (!timing(stepsPerSecond, clockSelect, halfPeriod)) {
+    return false;
+  }
+  _stepsBefore = elapsedSteps();
+  _since = micros();
+  _rate = stepsPerSecond;
+  return true;
+}
+
+long TrackingTimer::stop()
+{
+  long made = steps();
+  _running = false;
+  return made;
+}
+
+long TrackingTimer::steps()
+{
+  // The first step is the first toggle, half a period after the start
+  return _running ? (long)floor(elapsedSteps() + 0.5) : 0;
+}
+
+bool TrackingTimer::isRunning()
+{
+  return _running;
+}
+
+#endif
+
+#endif
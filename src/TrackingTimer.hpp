@@ -0,0 +1,34 @@
+#pragma once
+
+#include "inc/Globals.hpp"
+
+//////////////////////////////////////
+// Generates the RA tracking steps with a 16-bit timer of the ATmega2560 (RA_HARDWARE_TRACKING).
+//
+// The timer runs in CTC mode and toggles its output compare pin, the RA STEP pin, every half
+// step period, so the pulses need no code at all and have no interrupt jitter. The compare
+// interrupt only counts the toggles and loads the next half period, alternating between two
+// compare values so the average rate is exact to 1/256 of a timer tick. The host build models
+// the timer in virtual time.
+//////////////////////////////////////
+class TrackingTimer
+{
+public:
+  // Starts stepping from STEP low, the first step half a period from now. False if the rate is out of range.
+  static bool start(float stepsPerSecond);
+
+  // Changes the rate of a running timer, from the next toggle on
+  static bool setRate(float stepsPerSecond);
+
+  // Stops the timer, ending a step pulse that is still high, and returns the steps made since start()
+  static long stop();
+
+  // Steps made since start()
+  static long steps();
+
+  static bool isRunning();
+
+  // How the timer runs at the given rate: the clock select bits of the prescaler, and the time between
+  // two toggles in 1/256 timer ticks. False if no prescaler can reach the rate.
+  static bool timing(float stepsPerSecond, byte& clockSelect, unsigned long& halfPeriod);
+};
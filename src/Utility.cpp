@@ -209,6 +209,11 @@ int freeMemory()
 {
   return ESP.getFreeHeap();
 }
+#elif defined(OAT_HOST_BUILD)
+int freeMemory()
+{
+  return 0;
+}
 #else
 
 #ifdef __arm__
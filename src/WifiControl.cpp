@@ -1,12 +1,12 @@
 #include "../Configuration.hpp"
 #include "Utility.hpp"
 #include "WifiControl.hpp"
-#include "MeadeCommandProcessor.hpp"
 #include "Mount.hpp"
 
 #if (WIFI_ENABLED == 1)
 
 WifiControl::WifiControl(Mount* mount, LcdMenu* lcdMenu) 
+    : _transport(&client, mount, DEBUG_WIFI, "WifiTCP")
 {
     _mount = mount;
     _lcdMenu = lcdMenu;
@@ -16,8 +16,6 @@ void WifiControl::setup() {
 
     LOGV2(DEBUG_WIFI,F("Wifi: Starting up Wifi As Mode %d\n"), WIFI_MODE);
 
-  _cmdProcessor = MeadeCommandProcessor::instance();
-
   switch (WIFI_MODE) {
   case WIFI_MODE_INFRASTRUCTURE: // startup Infrastructure Mode
       startInfrastructureMode();
@@ -137,36 +135,14 @@ void WifiControl::infraToAPFailover() {
 
 void WifiControl::tcpLoop() {
     if (client && client.connected()) {
-        while (client.available()) {
-            LOGV2(DEBUG_WIFI,F("WifiTCP: Available bytes %d. Peeking."), client.available());
-
-            // Peek first byte and check for ACK (0x06) handshake
-            LOGV2(DEBUG_WIFI,F("WifiTCP: First byte is %x"), client.peek());
-            if (client.peek() == 0x06) {
-                client.read();
-                LOGV1(DEBUG_WIFI,F("WifiTCP: Query <-- Handshake request"));
-                client.write("1");
-                LOGV1(DEBUG_WIFI,F("WifiTCP: Reply --> 1"));
-            }
-            else {
-                String cmd = client.readStringUntil('#');
-                LOGV2(DEBUG_WIFI,F("WifiTCP: Query <-- %s#"), cmd.c_str());
-                String retVal = _cmdProcessor->processCommand(cmd);
-
-                if (retVal != "") {
-                    client.write(retVal.c_str());
-                    LOGV2(DEBUG_WIFI,F("WifiTCP: Reply --> %s"), retVal.c_str());
-                }
-                else{
-                    LOGV1(DEBUG_WIFI,F("WifiTCP: No Reply"));
-                }
-            }
-
-            _mount->loop();
-        }
+        _transport.processInput();
     }
     else {
         client = _tcpServer->available();
+        if (client) {
+            LOGV1(DEBUG_WIFI,F("WifiTCP: Client connected"));
+            _transport.reset();
+        }
     }
 }
 
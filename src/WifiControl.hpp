@@ -10,10 +10,11 @@
 #include <WiFiSTA.h>
 #endif
 
+#include "CommandTransport.hpp"
+
 // Forward declarations
 class Mount;
 class LcdMenu;
-class MeadeCommandProcessor;
 
 class WifiControl {
 public: 
@@ -30,11 +31,11 @@ private:
     wl_status_t _status;
     Mount* _mount;
     LcdMenu* _lcdMenu;
-    MeadeCommandProcessor* _cmdProcessor;
 
     WiFiServer* _tcpServer;
     WiFiUDP* _udp;
     WiFiClient client;
+    CommandTransport _transport;
 
     unsigned long _infraStart = 0;
     unsigned long _infraWait = 30000; // 30 second timeout for 
@@ -1,6 +1,5 @@
 #pragma once
 
-#include <AccelStepper.h>
 #include "inc/Globals.hpp"
 
 #include "Utility.hpp"
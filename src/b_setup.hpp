@@ -62,7 +62,8 @@ WifiControl wifiControl(&mount, &lcdMenu);
  *    loop() function runs on Core 1, therefore serial and UI activity also runs on Core 1. 
  *    Note that Wifi and Bluetooth drivers will be sharing Core 0 with stepperControlTask().
  *    This configuration decouples stepper servicing from other OAT activities by using both cores.
- * 3) By default (e.g. for ATmega2560) a periodic timer is configured for a 500 us (2 kHz rate interval).
+ * 3) By default (e.g. for ATmega2560) a periodic timer is configured for a 500 us (2 kHz rate interval),
+ *    which slows down to STEPPER_INTERRUPT_MAX_PERIOD while only tracking and stops while nothing moves.
  *    This timr generates interrupts which are handled by stepperControlCallback(). The stepper 
  *    servicing therefore suspends loop() to generate motion, ensuring smooth tracking.
  */
@@ -88,13 +89,240 @@ void IRAM_ATTR stepperControlTask(void* payload)
 #else
 // This is the callback function for the timer interrupt on ATMega platforms. 
 // It should do very minimal work, only calling Mount::interruptLoop() to step the stepper motors as needed.
-// It is called every 500 us (2 kHz rate)
+// It is called every 500 us (2 kHz rate) while slewing, less often while tracking (see Mount::stepperInterruptPeriod())
 void stepperControlTimerCallback(void* payload) {
   Mount* mount = reinterpret_cast<Mount*>(payload);
   if (mount)
     mount->interruptLoop();
 }
 
+// Retunes the timer when the motors that are moving need another interrupt period
+void stepperInterruptPeriodChanged(unsigned long periodMicros) {
+  if (periodMicros == 0) {
+    InterruptCallback::stop();
+  }
+  else if (!InterruptCallback::setInterval(periodMicros / 1000.0f, stepperControlTimerCallback, &mount)) {
+    LOGV2(DEBUG_MOUNT, F("CANNOT set interrupt timer to %l us!"), periodMicros);
+  }
+}
+
+#endif
+
+/////////////////////////////////
+//   Driver configuration
+/////////////////////////////////
+#if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+void configureRADriver() {
+  LOGV1(DEBUG_ANY, F("Configure RA driver TMC2209 UART..."));
+  RAAxis::Driver& driver = mount.driverRA();
+  driver.begin(&RA_SERIAL_PORT, R_SENSE, RA_DRIVER_ADDRESS, RA_AUDIO_FEEDBACK == 1);
+  driver.tmc()->toff(4);
+  driver.tmc()->fclktrim(4);
+  driver.setCurrent(RA_RMSCURRENT);
+  driver.setMicrosteps(RA_TRACKING_MICROSTEPPING);   // System starts in tracking mode
+  driver.tmc()->ihold(1); // its save to assume that the only time RA stands still is during parking and the current can be limited to a minimum
+  driver.tmc()->irun(31);
+}
+#endif
+
+#if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+void configureDECDriver() {
+  LOGV1(DEBUG_ANY, F("Configure DEC driver TMC2209 UART..."));
+  DECAxis::Driver& driver = mount.driverDEC();
+  driver.begin(&DEC_SERIAL_PORT, R_SENSE, DEC_DRIVER_ADDRESS, DEC_AUDIO_FEEDBACK == 1);
+  driver.setCurrent(DEC_RMSCURRENT);
+  driver.setMicrosteps(DEC_SLEW_MICROSTEPPING);
+  driver.tmc()->semin(5);
+  driver.tmc()->semax(2);
+  driver.tmc()->sedn(0b01);
+  driver.tmc()->SGTHRS(DEC_STALL_VALUE);
+  driver.tmc()->ihold(DEC_HOLDCURRENT);
+}
+#endif
+
+#if AZIMUTH_ALTITUDE_MOTORS == 1
+void configureAZALTDrivers() {
+  #if AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+    LOGV1(DEBUG_ANY, F("Configure AZ driver..."));
+    mount.driverAZ().begin(&AZ_SERIAL_PORT, R_SENSE, AZ_DRIVER_ADDRESS, AZ_AUDIO_FEEDBACK == 1);
+    mount.driverAZ().tmc()->toff(4);
+    mount.driverAZ().tmc()->fclktrim(4);
+    mount.driverAZ().setCurrent(AZ_RMSCURRENT);
+    mount.driverAZ().setMicrosteps(AZ_MICROSTEPPING);
+  #endif
+  #if ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+    LOGV1(DEBUG_ANY, F("Configure ALT driver..."));
+    mount.driverALT().begin(&ALT_SERIAL_PORT, R_SENSE, ALT_DRIVER_ADDRESS, ALT_AUDIO_FEEDBACK == 1);
+    mount.driverALT().tmc()->toff(4);
+    mount.driverALT().tmc()->fclktrim(4);
+    mount.driverALT().setCurrent(ALT_RMSCURRENT);
+    mount.driverALT().setMicrosteps(ALT_MICROSTEPPING);
+  #endif
+}
+#endif
+
+/////////////////////////////////
+//   Start tracking
+/////////////////////////////////
+// Starts servicing the steppers and tracking. The last step of the boot.
+void startTracking() {
+  // Setup service to periodically service the steppers. 
+  #if (RUN_STEPPERS_IN_MAIN_LOOP != 0)
+    // Nothing to do - Mount::loop() will manage steppers in-line
+
+  #elif defined(ESP32)
+
+    disableCore0WDT();
+    xTaskCreatePinnedToCore(
+      stepperControlTask,    // Function to run on this core
+      "StepperControl",      // Name of this task
+      32767,                 // Stack space in bytes
+      &mount,                // payload
+      2,                     // Priority (2 is higher than 1)
+      &StepperTask,          // The location that receives the thread id
+      0);                    // The core to run this on
+      
+  #else
+    // 2 kHz updates at most (higher frequency interferes with serial communications and complete messes up OATControl communications)
+    if (!InterruptCallback::setInterval(STEPPER_INTERRUPT_MIN_PERIOD / 1000.0f, stepperControlTimerCallback, &mount))
+    {
+      LOGV1(DEBUG_MOUNT, F("CANNOT setup interrupt timer!"));
+    }
+    mount.setInterruptPeriodCallback(stepperInterruptPeriodChanged);
+  #endif
+
+  #if USE_GUIDE_PORT == 1
+    mount.guidePort().begin();
+  #endif
+
+  // Start the tracker.
+  LOGV2(DEBUG_ANY, F("Start Tracking, %l ms after power-on..."), millis());
+  mount.startSlewing(TRACKING);
+
+  mount.bootComplete();
+  LOGV1(DEBUG_ANY, F("Boot complete!"));
+}
+
+#if FAST_BOOT == 1
+/////////////////////////////////
+//   Fast boot
+/////////////////////////////////
+// With FAST_BOOT, the parts of the boot that would hold up tracking are tasks that the main loop
+// runs (see runBootTasks()), each as soon as the tasks it depends on are done and it is ready.
+// Nothing waits in delay(): a task that waits for hardware polls it.
+#define BOOT_SPLASH           B00000001
+#define BOOT_RA_DRIVER        B00000010
+#define BOOT_DEC_DRIVER       B00000100
+#define BOOT_AZ_ALT_DRIVERS   B00001000
+#define BOOT_TRACKING         B00010000
+#define BOOT_WIFI             B00100000
+
+struct BootTask {
+  byte task;
+  byte dependsOn;   // The tasks that have to be done first
+  bool (*ready)();  // Polled until it returns true, nullptr if the task can run as soon as its dependencies are done
+  void (*run)();
+};
+
+#if DISPLAY_TYPE != DISPLAY_TYPE_NONE
+unsigned long splashUntil = 0;
+
+bool splashShown() {
+  return (long)(millis() - splashUntil) >= 0;
+}
+
+void endSplash() {
+  okToUpdateMenu = true;
+}
+#endif
+
+#if (RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART)
+// A TMC2209 takes a moment after power-up before it answers on its UART. One that never
+// does is configured anyway after BOOT_DRIVER_TIMEOUT, as the slow boot would.
+bool driverAnswers(Stream* serial, byte address) {
+  TMC2209Stepper driver(serial, R_SENSE, address);
+  return (driver.test_connection() == 0) || (millis() >= BOOT_DRIVER_TIMEOUT);
+}
+#endif
+
+#if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+bool raDriverAnswers() { return driverAnswers(&RA_SERIAL_PORT, RA_DRIVER_ADDRESS); }
+#endif
+#if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+bool decDriverAnswers() { return driverAnswers(&DEC_SERIAL_PORT, DEC_DRIVER_ADDRESS); }
+#endif
+#if (AZIMUTH_ALTITUDE_MOTORS == 1) && ((AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART))
+bool azAltDriversAnswer() {
+  #if AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+    if (!driverAnswers(&AZ_SERIAL_PORT, AZ_DRIVER_ADDRESS)) {
+      return false;
+    }
+  #endif
+  #if ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+    if (!driverAnswers(&ALT_SERIAL_PORT, ALT_DRIVER_ADDRESS)) {
+      return false;
+    }
+  #endif
+  return true;
+}
+#endif
+
+#if (WIFI_ENABLED == 1)
+void setupWifi() {
+  LOGV1(DEBUG_ANY, F("Setup Wifi..."));
+  wifiControl.setup();
+}
+#endif
+
+// Tracking waits for the RA and DEC drivers, so nothing steps at the microstepping they power up with
+const BootTask bootTasks[] = {
+  #if DISPLAY_TYPE != DISPLAY_TYPE_NONE
+    { BOOT_SPLASH, 0, splashShown, endSplash },
+  #endif
+  #if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+    { BOOT_RA_DRIVER, 0, raDriverAnswers, configureRADriver },
+  #endif
+  #if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
+    { BOOT_DEC_DRIVER, 0, decDriverAnswers, configureDECDriver },
+  #endif
+  #if (AZIMUTH_ALTITUDE_MOTORS == 1) && ((AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) || (ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART))
+    { BOOT_AZ_ALT_DRIVERS, 0, azAltDriversAnswer, configureAZALTDrivers },
+  #endif
+  { BOOT_TRACKING, BOOT_RA_DRIVER | BOOT_DEC_DRIVER, nullptr, startTracking },
+  #if (WIFI_ENABLED == 1)
+    { BOOT_WIFI, BOOT_TRACKING, nullptr, setupWifi },
+  #endif
+};
+
+byte bootTasksDone = 0xFF;  // Tasks that this configuration does not have count as done
+bool bootTasksPending = false;
+
+void startBootTasks() {
+  for (const BootTask& task : bootTasks) {
+    bootTasksDone &= ~task.task;
+  }
+  bootTasksPending = true;
+}
+
+// Runs the boot tasks that can run now. Called from the main loop until they are all done.
+void runBootTasks() {
+  if (!bootTasksPending) {
+    return;
+  }
+  bootTasksPending = false;
+  for (const BootTask& task : bootTasks) {
+    if (bootTasksDone & task.task) {
+      continue;
+    }
+    if (((bootTasksDone & task.dependsOn) == task.dependsOn) && ((task.ready == nullptr) || task.ready())) {
+      task.run();
+      bootTasksDone |= task.task;
+    }
+    else {
+      bootTasksPending = true;
+    }
+  }
+}
 #endif
 
 /////////////////////////////////
@@ -212,7 +440,13 @@ void setup() {
     lcdMenu.printMenu("OpenAstroTracker");
     lcdMenu.setCursor(5, 1);
     lcdMenu.printMenu(VERSION);
-    delay(1000);  // Pause on splash screen
+    #if FAST_BOOT == 1
+      // Leave the splash screen up without waiting for it. The boot tasks take it down.
+      okToUpdateMenu = false;
+      splashUntil = millis() + BOOT_SPLASH_TIME;
+    #else
+      delay(BOOT_SPLASH_TIME);  // Pause on splash screen
+    #endif
 
     // Check for EEPROM reset (Button down during boot)
     if (lcdButtons.currentState() == btnDOWN){
@@ -258,14 +492,16 @@ void setup() {
   LOGV1(DEBUG_ANY, F("Initialize LX200 handler..."));
   MeadeCommandProcessor::createProcessor(&mount, &lcdMenu);
 
-  #if (WIFI_ENABLED == 1)
+  #if (WIFI_ENABLED == 1) && (FAST_BOOT == 0)
     LOGV1(DEBUG_ANY, F("Setup Wifi..."));
     wifiControl.setup();
   #endif
 
   // Configure the mount
-  // Delay for a while to get UARTs booted...
-  delay(1000);  
+  #if FAST_BOOT == 0
+    // Delay for a while to get UARTs booted...
+    delay(1000);  
+  #endif
 
   // Set the stepper motor parameters
   #if RA_STEPPER_TYPE == STEPPER_TYPE_28BYJ48 
@@ -288,13 +524,11 @@ void setup() {
     #error New stepper type? Configure it here.
   #endif
 
-  #if RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-    LOGV1(DEBUG_ANY, F("Configure RA driver TMC2209 UART..."));
-    mount.configureRAdriver(&RA_SERIAL_PORT, R_SENSE, RA_DRIVER_ADDRESS, RA_RMSCURRENT, RA_STALL_VALUE);
+  #if (RA_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) && (FAST_BOOT == 0)
+    configureRADriver();
   #endif
-  #if DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-    LOGV1(DEBUG_ANY, F("Configure DEC driver TMC2209 UART..."));
-    mount.configureDECdriver(&DEC_SERIAL_PORT, R_SENSE, DEC_DRIVER_ADDRESS, DEC_RMSCURRENT, DEC_STALL_VALUE);
+  #if (DEC_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART) && (FAST_BOOT == 0)
+    configureDECDriver();
   #endif
 
   #if AZIMUTH_ALTITUDE_MOTORS == 1
@@ -304,19 +538,14 @@ void setup() {
     #elif AZ_DRIVER_TYPE == DRIVER_TYPE_A4988_GENERIC || AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_STANDALONE || AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
       mount.configureAZStepper(AZmotorPin1, AZmotorPin2, AZ_STEPPER_SPEED, AZ_STEPPER_ACCELERATION);
     #endif
-    #if AZ_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-      LOGV1(DEBUG_ANY, F("Configure AZ driver..."));
-      mount.configureAZdriver(&AZ_SERIAL_PORT, R_SENSE, AZ_DRIVER_ADDRESS, AZ_RMSCURRENT, AZ_STALL_VALUE);
-    #endif
     LOGV1(DEBUG_ANY, F("Configure Alt stepper..."));
     #if ALT_DRIVER_TYPE == DRIVER_TYPE_ULN2003 
       mount.configureALTStepper(ALTmotorPin1, ALTmotorPin2, ALTmotorPin3, ALTmotorPin4, ALT_STEPPER_SPEED, ALT_STEPPER_ACCELERATION);
     #elif ALT_DRIVER_TYPE == DRIVER_TYPE_A4988_GENERIC || ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_STANDALONE || ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
       mount.configureALTStepper(ALTmotorPin1, ALTmotorPin2, ALT_STEPPER_SPEED, ALT_STEPPER_ACCELERATION);
     #endif
-    #if ALT_DRIVER_TYPE == DRIVER_TYPE_TMC2209_UART
-      LOGV1(DEBUG_ANY, F("Configure ALT driver..."));
-      mount.configureALTdriver(&ALT_SERIAL_PORT, R_SENSE, ALT_DRIVER_ADDRESS, ALT_RMSCURRENT, ALT_STALL_VALUE);
+    #if FAST_BOOT == 0
+      configureAZALTDrivers();
     #endif
   #endif
 
@@ -335,34 +564,11 @@ void setup() {
   // For LCD screen, it's better to initialize the target to where we are (RA)
   mount.targetRA() = mount.currentRA();
 
-  // Setup service to periodically service the steppers. 
-  #if (RUN_STEPPERS_IN_MAIN_LOOP != 0)
-    // Nothing to do - Mount::loop() will manage steppers in-line
-
-  #elif defined(ESP32)
-
-    disableCore0WDT();
-    xTaskCreatePinnedToCore(
-      stepperControlTask,    // Function to run on this core
-      "StepperControl",      // Name of this task
-      32767,                 // Stack space in bytes
-      &mount,                // payload
-      2,                     // Priority (2 is higher than 1)
-      &StepperTask,          // The location that receives the thread id
-      0);                    // The core to run this on
-      
+  #if FAST_BOOT == 1
+    // Tracks right away, unless it has to wait for a driver
+    startBootTasks();
+    runBootTasks();
   #else
-    // 2 kHz updates (higher frequency interferes with serial communications and complete messes up OATControl communications)
-    if (!InterruptCallback::setInterval(0.5f, stepperControlTimerCallback, &mount))
-    {
-      LOGV1(DEBUG_MOUNT, F("CANNOT setup interrupt timer!"));
-    }
+    startTracking();
   #endif
-
-  // Start the tracker.
-  LOGV1(DEBUG_ANY, F("Start Tracking..."));
-  mount.startSlewing(TRACKING);
-
-  mount.bootComplete();
-  LOGV1(DEBUG_ANY, F("Boot complete!"));
 }
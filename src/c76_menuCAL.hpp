@@ -41,8 +41,9 @@ enum {
 
 // Drift calibration goes through 2 states
 // 15- Display four durations and wait for the user to select one
-// 16- Start the calibration run after user presses SELECT. This state waits 1.5s, takes duration time
-//     to slew east in half the time selected, then waits 1.5s and slews west in the same duration, and waits 1.5s.
+// 16- The mount runs the drift alignment (see DriftAlignment.hpp) after the user presses SELECT. This state shows
+//     what it does until it is done. It waits 1.5s, takes duration time to slew east in half the time selected,
+//     then waits 1.5s and slews west in the same duration, and waits 1.5s. RIGHT stops it.
 #define DRIFT_CALIBRATION_WAIT 30
 #define DRIFT_CALIBRATION_RUNNING 31
 
@@ -322,30 +323,10 @@ bool processCalibrationKeys()
   }
   else if (calState == DRIFT_CALIBRATION_RUNNING)
   {
-    lcdMenu.setCursor(0, 1);
-    lcdMenu.printMenu("Pause 1.5s ...");
-    mount.stopSlewing(TRACKING);
-    mount.delay(1500);
-
-    lcdMenu.setCursor(0, 1);
-    lcdMenu.printMenu("Eastward pass...");
-    mount.runDriftAlignmentPhase(EAST, driftDuration);
-
-    lcdMenu.setCursor(0, 1);
-    lcdMenu.printMenu("Pause 1.5s ...");
-    mount.delay(1500);
-
-    lcdMenu.setCursor(0, 1);
-    lcdMenu.printMenu("Westward pass...");
-    mount.runDriftAlignmentPhase(WEST, driftDuration);
-
-    lcdMenu.setCursor(0, 1);
-    lcdMenu.printMenu("Done. Pause 1.5s");
-    mount.delay(1500);
-    mount.runDriftAlignmentPhase(0, 0);
-
-    mount.startSlewing(TRACKING);
-    calState = HIGHLIGHT_DRIFT;
+    if (!mount.driftAlignment().isRunning())
+    {
+      calState = HIGHLIGHT_DRIFT;
+    }
   }
 
   if (checkForKeyChange && lcdButtons.keyChanged(&key))
@@ -698,6 +679,7 @@ bool processCalibrationKeys()
         // These are the times for one way. So total time is 2 x duration + 4.5s
         int duration[] = {27, 57, 87, 147};
         driftDuration = duration[driftSubIndex];
+        mount.driftAlignment().start(driftDuration);
         calState = DRIFT_CALIBRATION_RUNNING;
       }
       else if (key == btnRIGHT)
@@ -709,6 +691,16 @@ bool processCalibrationKeys()
     }
     break;
 
+    case DRIFT_CALIBRATION_RUNNING:
+    {
+      if (key == btnRIGHT)
+      {
+        mount.driftAlignment().stop();
+        calState = HIGHLIGHT_DRIFT;
+      }
+    }
+    break;
+
     case PARKING_POS_CONFIRM:
     {
       if (key == btnDOWN || key == btnLEFT || key == btnUP)
@@ -1060,6 +1052,16 @@ void printCalibrationSubmenu()
     scratchBuffer[driftSubIndex * 4] = '>';
     lcdMenu.printMenu(scratchBuffer);
   }
+  else if (calState == DRIFT_CALIBRATION_RUNNING)
+  {
+    switch (mount.driftAlignment().state())
+    {
+      case DriftAlignment::EAST_PASS: lcdMenu.printMenu("Eastward pass..."); break;
+      case DriftAlignment::WEST_PASS: lcdMenu.printMenu("Westward pass..."); break;
+      case DriftAlignment::BACKLASH: lcdMenu.printMenu("Backlash..."); break;
+      default: lcdMenu.printMenu("Pause 1.5s ..."); break;
+    }
+  }
   else if (calState == RA_STEP_CALIBRATION)
   {
     sprintf(scratchBuffer, "RA Steps: %s", String(0.1 * RAStepsPerDegree, 1).c_str());
@@ -29,6 +29,14 @@
 
   void loop() {
 
+    #if FAST_BOOT == 1
+      runBootTasks();
+      if (!mount.isBootComplete()) {
+        // Nothing steps before startTracking(), so keys and commands wait until then, as during the slow boot
+        return;
+      }
+    #endif
+
     #if LCD_BUTTON_TEST == 1
       int adc_key_in;
 
@@ -226,6 +234,12 @@
 #else // DISPLAY not NONE
 
   void loop() {
+    #if FAST_BOOT == 1
+      runBootTasks();
+      if (!mount.isBootComplete()) {
+        return;
+      }
+    #endif
     #ifdef ESP32
       serialLoop();
     #if (BLUETOOTH_ENABLED == 1)
@@ -2,11 +2,13 @@
 
 #if (BLUETOOTH_ENABLED == 1)
 #if SUPPORT_SERIAL_CONTROL == 1
-#include "MeadeCommandProcessor.hpp"
+#include "CommandTransport.hpp"
 #include "BluetoothSerial.h"
 BluetoothSerial SerialBT;
 #define BLUETOOTH_SERIAL SerialBT
 
+CommandTransport bluetoothTransport(&BLUETOOTH_SERIAL, &mount, DEBUG_SERIAL, "SerialBT");
+
 bool bt_connected = false;
 void processSerialBTData();
 void bt_callback(esp_spp_cb_event_t event, esp_spp_cb_param_t *param);
@@ -21,40 +23,14 @@ void bluetoothLoop()
     }
     if (bt_connected) {
         processSerialBTData();
+    } else {
+        // Don't let a half-received command from the last client leak into the next one.
+        bluetoothTransport.reset();
     }
 }
 
 void processSerialBTData() {
-    char buffer[2];
-    while (BLUETOOTH_SERIAL.available() > 0) {
-        if (BLUETOOTH_SERIAL.readBytes(buffer, 1) == 1) {
-            if (buffer[0] == '#') { 
-                // Empty command sent?
-            } else if (buffer[0] == 0x06) {
-                // ACK from client, requesting Alignment Query, 
-                // allows Stellaris (And others?) to tell if this 
-                // is a LX200/Meade comaptible mount
-                LOGV1(DEBUG_SERIAL, F("SerialBT: Received: ACK request, replying"));
-                // Assuming Polar alignment mounting mode
-                BLUETOOTH_SERIAL.print('P'); 
-            } else {
-                String inCmd = String(buffer[0]) + BLUETOOTH_SERIAL.readStringUntil('#');
-                LOGV2(DEBUG_SERIAL, F("SerialBT: Received: %s"), inCmd.c_str());
-                // Handle NexStar attempt to prevent communication issue
-                if (inCmd == "Ka" || inCmd == "K*") {
-                    continue;
-                }
-            
-                String retVal = MeadeCommandProcessor::instance()->processCommand(inCmd);
-                if (retVal != "") {
-                    LOGV2(DEBUG_SERIAL, F("SerialBT: Replied:  %s"), retVal);
-                    SerialBT.print(retVal);
-                }
-            }
-        }
-           
-        mount.loop();
-    }
+    bluetoothTransport.processInput();
 }
 
 void bt_callback(esp_spp_cb_event_t event, esp_spp_cb_param_t *param) {
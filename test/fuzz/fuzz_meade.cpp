@@ -0,0 +1,127 @@
+// Fuzzing target for the Meade command processor (pio run -e fuzz).
+//
+// Each input is a stream of bytes as a client would send them. It goes through the
+// same CommandTransport as the serial port, into MeadeCommandProcessor::processCommand()
+// and a simulated Mount running on virtual time. Memory errors are caught by the
+// sanitizers the fuzz environment builds with. A command that keeps the firmware busy
+// for more than MAX_VIRTUAL_MINUTES of virtual time is reported as a hang.
+//
+// Built as is, the program runs every file named on its command line (or stdin when
+// there are none), which is what AFL expects. Define OAT_LIBFUZZER and link with
+// -fsanitize=fuzzer (clang) to get a libFuzzer target instead:
+//
+//    program test/fuzz/corpus/*            replay the seed corpus
+//    afl-fuzz -i test/fuzz/corpus -o findings -- program
+//    program -max_len=256 corpus_dir test/fuzz/corpus      (libFuzzer)
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include <EEPROM.h>
+#include "../test_native/simulation.h"
+#include "CommandTransport.hpp"
+
+#define MAX_VIRTUAL_MINUTES 60
+
+namespace {
+
+HostSerial client;
+CommandTransport transport(&client, &test::simulation::mount, DEBUG_SERIAL, "Fuzz");
+unsigned long long inputStartedAt = 0;
+
+void watchForHang(unsigned long long nowMicros)
+{
+    test::simulation::stepperInterrupt(nowMicros);
+    if (nowMicros - inputStartedAt > MAX_VIRTUAL_MINUTES * 60ULL * 1000000ULL)
+    {
+        fprintf(stderr, "Fuzz: input kept the firmware busy for more than %d virtual minutes\n", MAX_VIRTUAL_MINUTES);
+        abort();
+    }
+}
+
+// Stops the motors and restores the default configuration, so that each input
+// starts from much the same mount. Settings held by the processor itself (like
+// the :U# precision) carry over, as they would for a real client.
+void resetMount()
+{
+    Mount &mount = test::simulation::mount;
+    mount.driftAlignment().stop();
+    mount.stopSlewing(ALL_DIRECTIONS | TRACKING);
+    mount.waitUntilStopped(ALL_DIRECTIONS);
+    EEPROM.clear();
+    mount.readConfiguration();
+    inSerialControl = false;
+
+    while (client.read() >= 0)
+    {
+    }
+    client.takeOutput();
+    transport.reset();
+}
+
+} // namespace
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    test::simulation::boot();
+    resetMount();
+
+    inputStartedAt = host::currentMicros();
+    host::setIdleHook(watchForHang);
+    client.inject((const char *)data, size);
+
+    // Read in queue-sized bites with the main loop running in between, like serialEvent() does
+    while (client.available() > 0)
+    {
+        transport.processInput();
+        test::simulation::run(1000);
+        watchForHang(host::currentMicros());
+    }
+
+    host::setIdleHook(test::simulation::stepperInterrupt);
+    client.takeOutput();
+    return 0;
+}
+
+#ifndef OAT_LIBFUZZER
+
+namespace {
+
+void runFile(FILE *file)
+{
+    std::vector<uint8_t> input;
+    int c;
+    while ((c = fgetc(file)) != EOF)
+    {
+        input.push_back((uint8_t)c);
+    }
+    LLVMFuzzerTestOneInput(input.data(), input.size());
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        runFile(stdin);
+        return 0;
+    }
+
+    for (int i = 1; i < argc; i++)
+    {
+        FILE *file = fopen(argv[i], "rb");
+        if (file == nullptr)
+        {
+            fprintf(stderr, "Fuzz: cannot open %s\n", argv[i]);
+            return 1;
+        }
+        printf("Fuzz: %s\n", argv[i]);
+        runFile(file);
+        fclose(file);
+    }
+    return 0;
+}
+
+#endif
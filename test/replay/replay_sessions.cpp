@@ -0,0 +1,500 @@
+// Replays recorded client sessions against the simulated mount (pio run -e replay).
+//
+// Each capture is the LX200 traffic of one session, as logged on the serial port or
+// TCP connection, turned into a text file with one line per command sent or reply
+// received:
+//
+//    # NINA and PHD2 through the ASCOM driver
+//    client ASCOM 57600          a client and the baud rate of its link (0 for TCP)
+//    main-loop 2000              microseconds the main loop spends on other work per pass (default 100)
+//    max-latency 50              fail when a reply takes longer than this many milliseconds
+//    max-loop-gap 20             fail when commands hold up the main loop for longer than this many milliseconds
+//    12.345 ASCOM > :GR#         at 12.345 seconds, ASCOM sent :GR#
+//    12.351 ASCOM < ??:??:??#    and got this reply to it
+//
+// In replies, '?' matches any one character and '~' any run of characters (both are
+// never sent by the firmware). The times of replies are not used: the commands are
+// sent at their recorded times and the replies of the firmware are timed as they
+// come. Commands without a recorded reply are sent but not timed.
+//
+// For every capture this reports the replies that did not match, the latency of the
+// replies by command (from the time the command was sent to the last byte of the
+// reply) and the longest time the main loop went without looking at its input.
+// The program fails when any capture has wrong or missing replies or exceeds its budgets.
+//
+//    program test/replay/captures/*
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+#include <EEPROM.h>
+#include "../test_native/simulation.h"
+#include "CommandTransport.hpp"
+
+// How long the firmware gets to send the replies still missing after the last command
+#define DRAIN_SECONDS 10
+
+namespace {
+
+struct Reply
+{
+    int client;
+    std::string command;
+    std::string expected;
+    unsigned long long sentAt;
+};
+
+struct Client
+{
+    std::string name;
+    std::unique_ptr<HostSerial> serial;
+    std::unique_ptr<CommandTransport> transport;
+    std::string received;
+    std::vector<int> waiting; // Replies not received yet, in the order they were asked for
+};
+
+struct Send
+{
+    unsigned long long at;
+    int client;
+    std::string bytes;
+    int reply; // Index into Capture::replies, or -1
+};
+
+struct Capture
+{
+    std::vector<Client> clients;
+    std::vector<Send> sends;
+    std::vector<Reply> replies;
+    unsigned long mainLoopMicros = 100;
+    double maxLatencyMs = 0;
+    double maxLoopGapMs = 0;
+};
+
+struct Results
+{
+    std::map<std::string, std::vector<double>> latencies; // By command, in milliseconds
+    std::string slowestCommand;
+    double slowestMs = 0;
+    int wrongReplies = 0;
+    double maxLoopGapMs = 0;
+    double maxLoopGapAt = 0;
+};
+
+Capture *capture = nullptr;
+Results *results = nullptr;
+size_t nextSend = 0;
+unsigned long long startedAt = 0;
+unsigned long long deadline = 0;
+
+double seconds(unsigned long long micros) { return (micros - startedAt) / 1000000.0; }
+
+// Unescapes \xNN, \\ and \r\n so that ACK bytes and line endings can be recorded
+std::string unescape(const std::string &text)
+{
+    std::string bytes;
+    for (size_t i = 0; i < text.size(); i++)
+    {
+        if ((text[i] != '\\') || (i + 1 == text.size()))
+        {
+            bytes += text[i];
+            continue;
+        }
+        char code = text[++i];
+        if ((code == 'x') && (i + 2 < text.size()))
+        {
+            bytes += (char)strtol(text.substr(i + 1, 2).c_str(), nullptr, 16);
+            i += 2;
+        }
+        else
+        {
+            bytes += (code == 'r') ? '\r' : ((code == 'n') ? '\n' : code);
+        }
+    }
+    return bytes;
+}
+
+int findClient(const std::string &name)
+{
+    for (size_t i = 0; i < capture->clients.size(); i++)
+    {
+        if (capture->clients[i].name == name)
+        {
+            return (int)i;
+        }
+    }
+    return -1;
+}
+
+bool loadCapture(const char *path, Capture &loaded)
+{
+    FILE *file = fopen(path, "r");
+    if (file == nullptr)
+    {
+        fprintf(stderr, "Replay: cannot open %s\n", path);
+        return false;
+    }
+
+    capture = &loaded;
+    char line[512];
+    int lineNumber = 0;
+    bool ok = true;
+    while (ok && (fgets(line, sizeof(line), file) != nullptr))
+    {
+        lineNumber++;
+        std::string text(line);
+        while (!text.empty() && ((text.back() == '\n') || (text.back() == '\r')))
+        {
+            text.pop_back();
+        }
+        if (text.empty() || (text[0] == '#'))
+        {
+            continue;
+        }
+
+        char word[64];
+        char name[64];
+        char direction[4];
+        double value;
+        int consumed = 0;
+        if (sscanf(text.c_str(), "client %63s %lf", name, &value) == 2)
+        {
+            Client client;
+            client.name = name;
+            client.serial.reset(new HostSerial());
+            client.serial->setTransmitRate((unsigned long)value);
+            loaded.clients.push_back(std::move(client));
+        }
+        else if (sscanf(text.c_str(), "main-loop %lf", &value) == 1)
+        {
+            loaded.mainLoopMicros = (unsigned long)value;
+        }
+        else if (sscanf(text.c_str(), "max-latency %lf", &value) == 1)
+        {
+            loaded.maxLatencyMs = value;
+        }
+        else if (sscanf(text.c_str(), "max-loop-gap %lf", &value) == 1)
+        {
+            loaded.maxLoopGapMs = value;
+        }
+        else if ((sscanf(text.c_str(), "%lf %63s %3s %n", &value, word, direction, &consumed) == 3) && (consumed > 0))
+        {
+            int client = findClient(word);
+            std::string bytes = unescape(text.substr(consumed));
+            unsigned long long at = (unsigned long long)(value * 1000000.0 + 0.5);
+            if ((client < 0) || bytes.empty())
+            {
+                ok = false;
+            }
+            else if (strcmp(direction, ">") == 0)
+            {
+                loaded.sends.push_back({ at, client, bytes, -1 });
+            }
+            else if (strcmp(direction, "<") == 0)
+            {
+                // A reply belongs to the last command its client sent
+                int send = (int)loaded.sends.size() - 1;
+                while ((send >= 0) && (loaded.sends[send].client != client))
+                {
+                    send--;
+                }
+                if ((send < 0) || (loaded.sends[send].reply >= 0))
+                {
+                    ok = false;
+                }
+                else
+                {
+                    loaded.sends[send].reply = (int)loaded.replies.size();
+                    loaded.replies.push_back({ client, loaded.sends[send].bytes, bytes, 0 });
+                }
+            }
+            else
+            {
+                ok = false;
+            }
+        }
+        else
+        {
+            ok = false;
+        }
+
+        if (!ok)
+        {
+            fprintf(stderr, "Replay: %s:%d: cannot read [%s]\n", path, lineNumber, text.c_str());
+        }
+    }
+    fclose(file);
+
+    std::stable_sort(loaded.sends.begin(), loaded.sends.end(), [](const Send &a, const Send &b) { return a.at < b.at; });
+    return ok;
+}
+
+// Matches the '?' and '~' wildcards of a recorded reply
+bool matches(const char *expected, const char *actual)
+{
+    if (*expected == '\0')
+    {
+        return *actual == '\0';
+    }
+    if (*expected == '~')
+    {
+        for (const char *rest = actual;; rest++)
+        {
+            if (matches(expected + 1, rest))
+            {
+                return true;
+            }
+            if (*rest == '\0')
+            {
+                return false;
+            }
+        }
+    }
+    if ((*actual == '\0') || ((*expected != '?') && (*expected != *actual)))
+    {
+        return false;
+    }
+    return matches(expected + 1, actual + 1);
+}
+
+// Returns how many of the received bytes make up the reply, or 0 when it is not complete yet.
+// Replies ending in '#' end with as many '#'s as were recorded, others have their recorded length.
+size_t replyLength(const std::string &expected, const std::string &received)
+{
+    if (expected.back() != '#')
+    {
+        return (received.size() >= expected.size()) ? expected.size() : 0;
+    }
+    size_t terminators = std::count(expected.begin(), expected.end(), '#');
+    for (size_t i = 0; i < received.size(); i++)
+    {
+        if ((received[i] == '#') && (--terminators == 0))
+        {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+// The command name a reply is reported under, e.g. :GR or :XGH
+std::string commandName(const std::string &command)
+{
+    size_t start = command.find(':');
+    if (start == std::string::npos)
+    {
+        return "ACK";
+    }
+    size_t end = start + 1;
+    while ((end < command.size()) && isalpha(command[end]))
+    {
+        end++;
+    }
+    return command.substr(start, end - start);
+}
+
+void collectReplies(unsigned long long now)
+{
+    for (Client &client : capture->clients)
+    {
+        client.received += client.serial->takeOutput();
+        while (!client.waiting.empty())
+        {
+            Reply &reply = capture->replies[client.waiting.front()];
+            size_t length = replyLength(reply.expected, client.received);
+            if (length == 0)
+            {
+                break;
+            }
+
+            std::string actual = client.received.substr(0, length);
+            client.received.erase(0, length);
+            client.waiting.erase(client.waiting.begin());
+            if (!matches(reply.expected.c_str(), actual.c_str()))
+            {
+                if (results->wrongReplies++ < 10)
+                {
+                    printf("  %.3f %s: %s replied [%s], expected [%s]\n", seconds(reply.sentAt), client.name.c_str(), reply.command.c_str(), actual.c_str(), reply.expected.c_str());
+                }
+                continue;
+            }
+
+            double ms = (now - reply.sentAt) / 1000.0;
+            results->latencies[commandName(reply.command)].push_back(ms);
+            if (ms > results->slowestMs)
+            {
+                results->slowestMs = ms;
+                results->slowestCommand = reply.command;
+            }
+        }
+    }
+}
+
+// Hands the recorded bytes to the transports as they come in, like the UART does
+void deliverInput(unsigned long long now)
+{
+    while ((nextSend < capture->sends.size()) && (startedAt + capture->sends[nextSend].at <= now))
+    {
+        Send &send = capture->sends[nextSend++];
+        Client &client = capture->clients[send.client];
+        client.serial->inject(send.bytes.c_str(), send.bytes.size());
+        if (send.reply >= 0)
+        {
+            capture->replies[send.reply].sentAt = startedAt + send.at;
+            client.waiting.push_back(send.reply);
+        }
+    }
+}
+
+// Runs while the firmware waits or writes, as the timer and UART interrupts would
+void whileBusy(unsigned long long now)
+{
+    test::simulation::stepperInterrupt(now);
+    deliverInput(now);
+    collectReplies(now);
+    if (now > deadline + DRAIN_SECONDS * 1000000ULL)
+    {
+        fprintf(stderr, "Replay: the firmware is still busy %d seconds after the last command\n", 2 * DRAIN_SECONDS);
+        abort();
+    }
+}
+
+// Stops the motors and restores the default configuration, so that each capture
+// starts from the same mount.
+void resetMount()
+{
+    Mount &mount = test::simulation::mount;
+    mount.stopSlewing(ALL_DIRECTIONS | TRACKING);
+    mount.waitUntilStopped(ALL_DIRECTIONS);
+    EEPROM.clear();
+    mount.readConfiguration();
+    mount.startSlewing(TRACKING);
+    inSerialControl = false;
+}
+
+bool replay(const char *path)
+{
+    Capture loaded;
+    Results replayed;
+    if (!loadCapture(path, loaded))
+    {
+        return false;
+    }
+    capture = &loaded;
+    results = &replayed;
+
+    test::simulation::boot();
+    resetMount();
+    for (Client &client : loaded.clients)
+    {
+        client.transport.reset(new CommandTransport(client.serial.get(), &test::simulation::mount, DEBUG_SERIAL, client.name.c_str()));
+    }
+
+    nextSend = 0;
+    startedAt = host::currentMicros();
+    unsigned long long lastSendAt = loaded.sends.empty() ? 0 : loaded.sends.back().at;
+    deadline = startedAt + lastSendAt + DRAIN_SECONDS * 1000000ULL;
+    host::setIdleHook(whileBusy);
+    std::chrono::steady_clock::time_point hostStart = std::chrono::steady_clock::now();
+
+    // The main loop: look at the input of every client, then give the mount its time slice
+    unsigned long long lastInputCheck = startedAt;
+    bool waitingForReplies = true;
+    while ((nextSend < loaded.sends.size()) || (waitingForReplies && (host::currentMicros() < deadline)))
+    {
+        unsigned long long now = host::currentMicros();
+        double gapMs = (now - lastInputCheck) / 1000.0;
+        if (gapMs > replayed.maxLoopGapMs)
+        {
+            replayed.maxLoopGapMs = gapMs;
+            replayed.maxLoopGapAt = seconds(lastInputCheck);
+        }
+        lastInputCheck = now;
+
+        deliverInput(now);
+        for (Client &client : loaded.clients)
+        {
+            client.transport->processInput();
+        }
+        test::simulation::mount.loop();
+        delayMicroseconds(loaded.mainLoopMicros);
+
+        collectReplies(host::currentMicros());
+        waitingForReplies = false;
+        for (Client &client : loaded.clients)
+        {
+            waitingForReplies |= !client.waiting.empty();
+        }
+    }
+
+    long long hostMicros = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - hostStart).count();
+    host::setIdleHook(test::simulation::stepperInterrupt);
+
+    int missing = 0;
+    for (Client &client : loaded.clients)
+    {
+        for (int reply : client.waiting)
+        {
+            if (missing++ < 10)
+            {
+                printf("  %.3f %s: %s got no reply, expected [%s]\n", seconds(loaded.replies[reply].sentAt), client.name.c_str(), loaded.replies[reply].command.c_str(), loaded.replies[reply].expected.c_str());
+            }
+        }
+        client.transport.reset();
+    }
+
+    printf("%s: %d commands over %.1f s, replayed in %lld ms\n", path, (int)loaded.sends.size(), seconds(host::currentMicros()), hostMicros / 1000);
+    printf("  %-8s %6s %9s %9s %9s\n", "command", "count", "p50 ms", "p95 ms", "max ms");
+    for (auto &latencies : replayed.latencies)
+    {
+        std::vector<double> &ms = latencies.second;
+        std::sort(ms.begin(), ms.end());
+        printf("  %-8s %6d %9.2f %9.2f %9.2f\n", latencies.first.c_str(), (int)ms.size(), ms[ms.size() / 2], ms[ms.size() * 95 / 100], ms.back());
+    }
+    printf("  slowest reply %.2f ms (%s), longest main loop gap %.2f ms at %.3f s\n", replayed.slowestMs, replayed.slowestCommand.c_str(), replayed.maxLoopGapMs, replayed.maxLoopGapAt);
+
+    bool passed = true;
+    if ((replayed.wrongReplies > 0) || (missing > 0))
+    {
+        printf("  FAIL: %d wrong and %d missing replies\n", replayed.wrongReplies, missing);
+        passed = false;
+    }
+    if ((loaded.maxLatencyMs > 0) && (replayed.slowestMs > loaded.maxLatencyMs))
+    {
+        printf("  FAIL: slowest reply is over the budget of %.2f ms\n", loaded.maxLatencyMs);
+        passed = false;
+    }
+    if ((loaded.maxLoopGapMs > 0) && (replayed.maxLoopGapMs > loaded.maxLoopGapMs))
+    {
+        printf("  FAIL: longest main loop gap is over the budget of %.2f ms\n", loaded.maxLoopGapMs);
+        passed = false;
+    }
+    return passed;
+}
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    if (argc < 2)
+    {
+        fprintf(stderr, "Usage: %s capture...\n", argv[0]);
+        return 2;
+    }
+
+    int failed = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        if (!replay(argv[i]))
+        {
+            failed++;
+        }
+    }
+    printf("%d of %d captures passed\n", argc - 1 - failed, argc - 1);
+    return (failed == 0) ? 0 : 1;
+}
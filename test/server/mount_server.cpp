@@ -0,0 +1,328 @@
+// Runs the simulated mount as a virtual OAT on a local TCP port (pio run -e server).
+//
+// Clients connect to it like to the WiFi port of a real mount and talk LX200 to the
+// firmware's own CommandTransport, MeadeCommandProcessor and Mount. Virtual time
+// follows the wall clock, or runs a given number of times faster, so drivers (ASCOM
+// through a TCP bridge, INDI lx200 drivers, scripts) see the same replies and timing
+// as from hardware, and command latency can be measured end to end.
+//
+//    program [-p port] [-s speed] [-r capture]
+//
+//    -p port      TCP port to listen on at 127.0.0.1 (default WIFI_PORT, 4030)
+//    -s speed     how many times faster than real time the mount runs (default 1)
+//    -r capture   writes the traffic in the capture format of test/replay, with the
+//                 time of each command and reply, for making new replay captures
+//
+// The mount starts from a blank EEPROM, tracking, every time the server starts. That is
+// also where the replay tool starts, so recorded sessions replay with the same replies.
+
+#include <arpa/inet.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <signal.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+#include "../test_native/simulation.h"
+#include "CommandTransport.hpp"
+
+// Virtual microseconds the main loop spends on other work per pass, as in the replay tool
+#define MAIN_LOOP_MICROS 100
+
+// How often the sockets are serviced while the firmware is busy in a command (virtual time)
+#define BUSY_SERVICE_MICROS 1000
+
+namespace {
+
+struct Client
+{
+    int socket;
+    std::string name;
+    std::unique_ptr<HostSerial> serial;
+    std::unique_ptr<CommandTransport> transport;
+    std::string command; // Bytes of the command being received, for the capture
+    bool closed;
+};
+
+typedef std::chrono::steady_clock clock;
+
+std::vector<std::unique_ptr<Client>> clients;
+int listener = -1;
+int clientCount = 0;
+double speed = 1.0;
+FILE *capture = nullptr;
+clock::time_point wallStart;
+unsigned long long virtualStart = 0;
+unsigned long long lastService = 0;
+volatile sig_atomic_t running = 1;
+
+double seconds(unsigned long long micros) { return (micros - virtualStart) / 1000000.0; }
+
+// Where virtual time should be by now
+unsigned long long virtualTarget()
+{
+    long long wallMicros = std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - wallStart).count();
+    return virtualStart + (unsigned long long)(wallMicros * speed);
+}
+
+// Writes bytes the way test/replay reads them back: \xNN for ACK and other control bytes
+void writeCaptureLine(const Client &client, const char *direction, const std::string &bytes)
+{
+    if (capture == nullptr)
+    {
+        return;
+    }
+    fprintf(capture, "%.3f %s %s ", seconds(host::currentMicros()), client.name.c_str(), direction);
+    for (char c : bytes)
+    {
+        if (c == '\\')
+        {
+            fputs("\\\\", capture);
+        }
+        else if ((unsigned char)c < ' ')
+        {
+            fprintf(capture, "\\x%02X", (unsigned char)c);
+        }
+        else
+        {
+            fputc(c, capture);
+        }
+    }
+    fputc('\n', capture);
+    fflush(capture);
+}
+
+// Splits what a client sent into commands for the capture
+void captureInput(Client &client, const char *bytes, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        client.command += bytes[i];
+        if ((bytes[i] == '#') || (bytes[i] == 0x06))
+        {
+            writeCaptureLine(client, ">", client.command);
+            client.command.clear();
+        }
+    }
+}
+
+// Moves bytes between the sockets and the clients' serial ports, like the UART would
+void serviceClients()
+{
+    for (auto &client : clients)
+    {
+        if (client->closed)
+        {
+            continue;
+        }
+
+        std::string output = client->serial->takeOutput();
+        if (!output.empty())
+        {
+            writeCaptureLine(*client, "<", output);
+            if (send(client->socket, output.data(), output.size(), MSG_NOSIGNAL) < 0)
+            {
+                client->closed = true;
+                continue;
+            }
+        }
+
+        char bytes[256];
+        ssize_t received = recv(client->socket, bytes, sizeof(bytes), MSG_DONTWAIT);
+        if (received > 0)
+        {
+            captureInput(*client, bytes, received);
+            client->serial->inject(bytes, received);
+        }
+        else if ((received == 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK)))
+        {
+            client->closed = true;
+        }
+    }
+}
+
+// Runs while the firmware waits or writes, as the timer and UART interrupts would. A command
+// that keeps the firmware busy still takes its time on the wall clock.
+void whileBusy(unsigned long long now)
+{
+    test::simulation::stepperInterrupt(now);
+    if (now - lastService < BUSY_SERVICE_MICROS)
+    {
+        return;
+    }
+    lastService = now;
+    serviceClients();
+    while (running && (virtualTarget() < now))
+    {
+        usleep(1000);
+    }
+}
+
+void acceptClients()
+{
+    sockaddr_in address;
+    socklen_t length = sizeof(address);
+    int socket = accept(listener, (sockaddr *)&address, &length);
+    if (socket < 0)
+    {
+        return;
+    }
+    int noDelay = 1;
+    setsockopt(socket, IPPROTO_TCP, TCP_NODELAY, &noDelay, sizeof(noDelay));
+
+    std::unique_ptr<Client> client(new Client());
+    client->socket = socket;
+    client->name = "TCP" + std::to_string(++clientCount);
+    client->serial.reset(new HostSerial());
+    client->transport.reset(new CommandTransport(client->serial.get(), &test::simulation::mount, DEBUG_WIFI, client->name.c_str()));
+    client->closed = false;
+    printf("Server: %s connected from %s:%d at %.3f s\n", client->name.c_str(), inet_ntoa(address.sin_addr), ntohs(address.sin_port), seconds(host::currentMicros()));
+    if (capture != nullptr)
+    {
+        fprintf(capture, "client %s 0\n", client->name.c_str());
+    }
+    clients.push_back(std::move(client));
+}
+
+void dropClosedClients()
+{
+    for (size_t i = 0; i < clients.size();)
+    {
+        if (clients[i]->closed)
+        {
+            printf("Server: %s disconnected at %.3f s\n", clients[i]->name.c_str(), seconds(host::currentMicros()));
+            close(clients[i]->socket);
+            clients.erase(clients.begin() + i);
+        }
+        else
+        {
+            i++;
+        }
+    }
+}
+
+// Sleeps until a client connects or sends something, or the mount is due to run again
+void waitForInput()
+{
+    std::vector<pollfd> sockets;
+    sockets.push_back({ listener, POLLIN, 0 });
+    for (auto &client : clients)
+    {
+        sockets.push_back({ client->socket, POLLIN, 0 });
+    }
+    poll(sockets.data(), sockets.size(), 1);
+}
+
+bool listenOn(int port)
+{
+    listener = socket(AF_INET, SOCK_STREAM, 0);
+    int reuse = 1;
+    setsockopt(listener, SOL_SOCKET, SO_REUSEADDR, &reuse, sizeof(reuse));
+    sockaddr_in address = {};
+    address.sin_family = AF_INET;
+    address.sin_port = htons(port);
+    address.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    if ((bind(listener, (sockaddr *)&address, sizeof(address)) < 0) || (listen(listener, 4) < 0))
+    {
+        fprintf(stderr, "Server: cannot listen on port %d: %s\n", port, strerror(errno));
+        return false;
+    }
+    fcntl(listener, F_SETFL, O_NONBLOCK);
+    return true;
+}
+
+// Stops the motors and restores the default configuration, like the replay tool does
+void resetMount()
+{
+    Mount &mount = test::simulation::mount;
+    mount.stopSlewing(ALL_DIRECTIONS | TRACKING);
+    mount.waitUntilStopped(ALL_DIRECTIONS);
+    EEPROM.clear();
+    mount.readConfiguration();
+    mount.startSlewing(TRACKING);
+    inSerialControl = false;
+}
+
+void stop(int) { running = 0; }
+
+} // namespace
+
+int main(int argc, char **argv)
+{
+    int port = WIFI_PORT;
+    int option;
+    while ((option = getopt(argc, argv, "p:s:r:")) != -1)
+    {
+        switch (option)
+        {
+            case 'p': port = atoi(optarg); break;
+            case 's': speed = atof(optarg); break;
+            case 'r':
+                capture = fopen(optarg, "w");
+                if (capture == nullptr)
+                {
+                    fprintf(stderr, "Server: cannot write %s\n", optarg);
+                    return 2;
+                }
+                fprintf(capture, "# Recorded by test/server at %gx real time\n", speed);
+                break;
+            default:
+                fprintf(stderr, "Usage: %s [-p port] [-s speed] [-r capture]\n", argv[0]);
+                return 2;
+        }
+    }
+    if ((speed <= 0) || !listenOn(port))
+    {
+        return 2;
+    }
+    signal(SIGINT, stop);
+    signal(SIGTERM, stop);
+
+    test::simulation::boot();
+    resetMount();
+    host::setIdleHook(whileBusy);
+    virtualStart = lastService = host::currentMicros();
+    wallStart = clock::now();
+    printf("Server: virtual OAT %s listening on 127.0.0.1:%d at %gx real time\n", VERSION, port, speed);
+    fflush(stdout);
+
+    // The main loop: look at the input of every client, then give the mount its time slice.
+    // It runs whenever virtual time is behind the wall clock, and sleeps otherwise.
+    while (running)
+    {
+        acceptClients();
+        serviceClients();
+        dropClosedClients();
+        if (host::currentMicros() >= virtualTarget())
+        {
+            fflush(stdout);
+            waitForInput();
+            continue;
+        }
+
+        for (auto &client : clients)
+        {
+            client->transport->processInput();
+        }
+        test::simulation::mount.loop();
+        delayMicroseconds(MAIN_LOOP_MICROS);
+    }
+
+    printf("Server: stopped at %.3f s\n", seconds(host::currentMicros()));
+    clients.clear();
+    close(listener);
+    if (capture != nullptr)
+    {
+        fclose(capture);
+    }
+    return 0;
+}
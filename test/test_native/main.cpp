@@ -0,0 +1,41 @@
+#include <unity.h>
+
+#include "test_command_transport.h"
+#include "test_daytime.h"
+#include "test_fixed_trig.h"
+#include "test_meade_format.h"
+#include "test_meade_parse.h"
+#include "test_parameters.h"
+#include "test_plant.h"
+#include "test_sequencer.h"
+#include "test_dither.h"
+#include "test_guiding.h"
+#include "test_guide_port.h"
+#include "test_session_log.h"
+#include "test_drift_alignment.h"
+#include "test_tracking.h"
+#include "test_trajectory.h"
+
+int main(int argc, char **argv) {
+    UNITY_BEGIN();
+
+    test::command_transport::run();
+    test::daytime::run();
+    test::fixed_trig::run();
+    test::meade_format::run();
+    test::meade_parse::run();
+    test::parameters::run();
+    test::trajectory::run();
+    test::plant_model::run();
+    test::tracking::run();
+    test::sequencer::run();
+    test::dither::run();
+    test::guiding::run();
+    test::guide_port::run();
+    test::session_log::run();
+    test::drift_alignment::run();
+
+    UNITY_END();
+
+    return 0;
+}
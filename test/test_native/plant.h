@@ -0,0 +1,215 @@
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+#include "simulation.h"
+
+// A mechanical model of the mount, driven by the steps the simulated firmware makes.
+// Each axis is a motor rotor held to its commanded step position by the stepper's
+// sinusoidal torque curve, driving the axis through a belt with stretch, damping and
+// play. The motor's torque falls off with speed, so a motor asked for too much speed
+// or acceleration slips and loses steps, as a real one does. The RA pulley adds its
+// periodic error.
+//
+// Angles are in degrees of the axis and times in seconds. The default parameters are
+// plausible for a 28BYJ-48 OAT, not measured; change them to match a mount.
+namespace test {
+    namespace plant {
+
+        struct AxisModel
+        {
+            float stepsPerDegree;          // Steps (as the firmware counts them) per degree of the axis
+            float stepsPerElectricalCycle; // Steps per period of the motor's torque curve (4 full steps)
+            float holdingAcceleration;     // What the motor's holding torque accelerates the axis with, deg/s²
+            float torqueCornerSpeed;       // Axis speed at which the motor's torque has halved, deg/s
+            float rotorInertiaRatio;       // Inertia of the motor and pulley over that of the axis, as seen by the axis
+            float motorDamping;            // Viscous damping of the rotor, 1/s
+            float beltStiffness;           // Acceleration of the axis per degree of belt stretch, 1/s²
+            float beltDamping;             // 1/s
+            float backlash;                // Total play between motor and axis, deg
+            float friction;                // Deceleration of the axis by friction, deg/s²
+            float imbalance;               // Acceleration of the axis by an off-balance load, deg/s²
+            float periodicErrorArcsec;     // Amplitude of the pulley's periodic error
+            float periodicErrorPeriod;     // Degrees the axis turns per turn of the pulley
+        };
+
+        struct AxisState
+        {
+            float commanded;  // Where the steps made so far put the axis
+            float rotor;
+            float rotorSpeed;
+            float axis;
+            float axisSpeed;
+        };
+
+        struct Sample
+        {
+            float seconds;
+            float raErrorArcsec;  // Pointing of the axis minus where the firmware put it
+            float decErrorArcsec;
+            long raLostSteps;
+            long decLostSteps;
+        };
+
+        // Substeps the model is integrated in per 500us. The stepper interrupt runs at a
+        // varying period, so the model catches up with the time since its last run.
+        #define PLANT_SUBSTEPS 25
+        #define PLANT_SUBSTEP_MICROS (500.0f / PLANT_SUBSTEPS)
+        #define PLANT_SAMPLE_MICROS 100000ULL
+
+        AxisModel raModel;
+        AxisModel decModel;
+        AxisState raState;
+        AxisState decState;
+        std::vector<Sample> samples;
+        unsigned long long startedAt = 0;
+        unsigned long long nextSampleAt = 0;
+        unsigned long long modelledUntil = 0;
+
+        AxisModel defaultModel(float stepsPerDegree, int microstepping)
+        {
+            AxisModel model;
+            model.stepsPerDegree = stepsPerDegree;
+            model.stepsPerElectricalCycle = 4.0f * microstepping;
+            model.holdingAcceleration = 20.0f;
+            model.torqueCornerSpeed = 0.25f;
+            model.rotorInertiaRatio = 0.1f;
+            model.motorDamping = 2.0f;
+            model.beltStiffness = 35000.0f;
+            model.beltDamping = 40.0f;
+            model.backlash = 0.01f;
+            model.friction = 0.2f;
+            model.imbalance = 0.0f;
+            model.periodicErrorArcsec = 0.0f;
+            model.periodicErrorPeriod = 360.0f;
+            return model;
+        }
+
+        // The RA pulley turns once for every pulley circumference the ring turns
+        AxisModel defaultRAModel()
+        {
+            AxisModel model = defaultModel(simulation::mount.getStepsPerDegree(RA_STEPS), RA_SLEW_MICROSTEPPING);
+            model.imbalance = 0.4f; // Enough to keep the play in the belt taken up while tracking
+            model.periodicErrorArcsec = 15.0f;
+            model.periodicErrorPeriod = 360.0f * RA_PULLEY_TEETH * GT2_BELT_PITCH / RA_WHEEL_CIRCUMFERENCE;
+            return model;
+        }
+
+        AxisModel defaultDECModel()
+        {
+            return defaultModel(simulation::mount.getStepsPerDegree(DEC_STEPS), DEC_SLEW_MICROSTEPPING);
+        }
+
+        // Both RA steppers drive the same motor, the tracking one at its own microstepping
+        float commandedRA()
+        {
+            Mount& mount = simulation::mount;
+            float steps = mount.getCurrentStepperPosition(EAST)
+                + mount.getCurrentStepperPosition(TRACKING) * (float)RA_SLEW_MICROSTEPPING / RA_TRACKING_MICROSTEPPING;
+            return steps / raModel.stepsPerDegree;
+        }
+
+        float commandedDEC()
+        {
+            return simulation::mount.getCurrentStepperPosition(NORTH) / decModel.stepsPerDegree;
+        }
+
+        void integrate(const AxisModel& model, AxisState& state, float dt)
+        {
+            float lag = state.commanded - state.rotor;
+            float phase = 2.0f * (float)M_PI * lag * model.stepsPerDegree / model.stepsPerElectricalCycle;
+            float motor = model.holdingAcceleration * sinf(phase) / (1.0f + fabsf(state.rotorSpeed) / model.torqueCornerSpeed);
+
+            float stretch = state.rotor - state.axis;
+            float engaged = stretch - constrain(stretch, -model.backlash / 2.0f, model.backlash / 2.0f);
+            float belt = 0.0f;
+            if (engaged != 0.0f)
+            {
+                belt = model.beltStiffness * engaged + model.beltDamping * (state.rotorSpeed - state.axisSpeed);
+            }
+
+            state.rotorSpeed += dt * (motor - belt - model.motorDamping * state.rotorSpeed * model.rotorInertiaRatio) / model.rotorInertiaRatio;
+            state.rotor += dt * state.rotorSpeed;
+
+            // Friction holds the axis still until the belt and the load pull harder than it
+            float load = belt + model.imbalance;
+            if ((state.axisSpeed == 0.0f) && (fabsf(load) <= model.friction))
+            {
+                return;
+            }
+            float axisAcceleration = load - ((state.axisSpeed > 0.0f) || ((state.axisSpeed == 0.0f) && (load > 0.0f)) ? model.friction : -model.friction);
+            float newSpeed = state.axisSpeed + dt * axisAcceleration;
+            state.axisSpeed = ((newSpeed > 0.0f) != (state.axisSpeed > 0.0f)) && (state.axisSpeed != 0.0f) ? 0.0f : newSpeed;
+            state.axis += dt * state.axisSpeed;
+        }
+
+        float pointing(const AxisModel& model, const AxisState& state)
+        {
+            return state.axis + model.periodicErrorArcsec / 3600.0f * sinf(2.0f * (float)M_PI * state.axis / model.periodicErrorPeriod);
+        }
+
+        // Steps the rotor has slipped by: it settles a whole number of torque cycles away
+        long lostSteps(const AxisModel& model, const AxisState& state)
+        {
+            float cycles = roundf((state.commanded - state.rotor) * model.stepsPerDegree / model.stepsPerElectricalCycle);
+            return (long)(cycles * model.stepsPerElectricalCycle);
+        }
+
+        void afterInterrupt(unsigned long long interruptMicros)
+        {
+            raState.commanded = commandedRA();
+            decState.commanded = commandedDEC();
+            const float dt = PLANT_SUBSTEP_MICROS / 1000000.0f;
+            long substeps = (long)((interruptMicros - modelledUntil) / PLANT_SUBSTEP_MICROS + 0.5f);
+            for (long i = 0; i < substeps; i++)
+            {
+                integrate(raModel, raState, dt);
+                integrate(decModel, decState, dt);
+            }
+            modelledUntil = interruptMicros;
+
+            if (interruptMicros >= nextSampleAt)
+            {
+                nextSampleAt += PLANT_SAMPLE_MICROS;
+                samples.push_back({ (interruptMicros - startedAt) / 1000000.0f,
+                    (pointing(raModel, raState) - raState.commanded) * 3600.0f,
+                    (pointing(decModel, decState) - decState.commanded) * 3600.0f,
+                    lostSteps(raModel, raState), lostSteps(decModel, decState) });
+            }
+        }
+
+        // Puts both axes at rest where the firmware has them, and models them from now on
+        void attach(const AxisModel& ra, const AxisModel& dec)
+        {
+            raModel = ra;
+            decModel = dec;
+            raState = { commandedRA(), commandedRA(), 0.0f, commandedRA(), 0.0f };
+            decState = { commandedDEC(), commandedDEC(), 0.0f, commandedDEC(), 0.0f };
+            samples.clear();
+            startedAt = nextSampleAt = modelledUntil = simulation::lastInterrupt;
+            simulation::interruptObserver = afterInterrupt;
+        }
+
+        void detach()
+        {
+            simulation::interruptObserver = nullptr;
+        }
+
+        // Writes the samples as CSV, for plotting the pointing error over time
+        void writeSamples(const char* path)
+        {
+            FILE* file = fopen(path, "w");
+            if (file == nullptr)
+            {
+                return;
+            }
+            fprintf(file, "seconds,ra_error_arcsec,dec_error_arcsec,ra_lost_steps,dec_lost_steps\n");
+            for (const Sample& sample : samples)
+            {
+                fprintf(file, "%.1f,%.2f,%.2f,%ld,%ld\n", sample.seconds, sample.raErrorArcsec, sample.decErrorArcsec, sample.raLostSteps, sample.decLostSteps);
+            }
+            fclose(file);
+        }
+    }
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include <Arduino.h>
+#include <EEPROM.h>
+#include "Configuration.hpp"
+#include "Utility.hpp"
+#include "EPROMStore.hpp"
+#include "LcdMenu.hpp"
+#include "Mount.hpp"
+#include "MeadeCommandProcessor.hpp"
+
+bool inSerialControl = false;
+
+// Runs the firmware's Mount and MeadeCommandProcessor on virtual time, servicing
+// the steppers at the period the mount asks for, as the timer interrupt on the Mega does.
+namespace test {
+    namespace simulation {
+
+        LcdMenu lcdMenu(16, 2, 2);
+        Mount mount(&lcdMenu);
+        unsigned long long lastInterrupt = 0;
+
+        // The period of the stepper interrupt in microseconds, 0 while it is stopped
+        unsigned long interruptPeriod = STEPPER_INTERRUPT_MIN_PERIOD;
+
+        // When not 0, the interrupt runs at this period whatever the mount asks for
+        unsigned long fixedInterruptPeriod = 0;
+
+        // When set, called after every run of the stepper interrupt (e.g. to record steps).
+        typedef void (*InterruptObserver)(unsigned long long interruptMicros);
+        InterruptObserver interruptObserver = nullptr;
+
+        // Restarts the interrupt at the new period, as InterruptCallback::setInterval() does
+        void setInterruptPeriod(unsigned long periodMicros)
+        {
+            interruptPeriod = (fixedInterruptPeriod != 0) ? fixedInterruptPeriod : periodMicros;
+            lastInterrupt = host::currentMicros();
+        }
+
+        void stepperInterrupt(unsigned long long nowMicros)
+        {
+            if (interruptPeriod == 0)
+            {
+                return;
+            }
+            while (nowMicros - lastInterrupt >= interruptPeriod)
+            {
+                lastInterrupt += interruptPeriod;
+                mount.interruptLoop();
+                if (interruptObserver != nullptr)
+                {
+                    interruptObserver(lastInterrupt);
+                }
+            }
+        }
+
+        // Brings the mount up the way setup() does, tracking at the default position.
+        void boot()
+        {
+            static bool booted = false;
+            host::setIdleHook(stepperInterrupt);
+            if (booted)
+            {
+                return;
+            }
+            booted = true;
+
+            EEPROMStore::initialize();
+            MeadeCommandProcessor::createProcessor(&mount, &lcdMenu);
+#if RA_STEPPER_TYPE == STEPPER_TYPE_28BYJ48
+            mount.configureRAStepper(RA_IN4_PIN, RA_IN2_PIN, RA_IN3_PIN, RA_IN1_PIN, RA_STEPPER_SPEED, RA_STEPPER_ACCELERATION);
+#else
+            mount.configureRAStepper(RA_STEP_PIN, RA_DIR_PIN, RA_STEPPER_SPEED, RA_STEPPER_ACCELERATION);
+#endif
+            mount.configureDECStepper(DEC_IN1_PIN, DEC_IN3_PIN, DEC_IN2_PIN, DEC_IN4_PIN, RA_STEPPER_SPEED, DEC_STEPPER_ACCELERATION);
+            mount.readConfiguration();
+            mount.setHA(EEPROMStore::getHATime());
+            mount.targetRA() = mount.currentRA();
+            mount.setInterruptPeriodCallback(setInterruptPeriod);
+            mount.guidePort().begin();
+            mount.startSlewing(TRACKING);
+            mount.bootComplete();
+        }
+
+        // Stops the motors and puts the mount at home with a blank EEPROM and the same LST
+        // and interrupt phase every time, then starts tracking. Scenarios that start from
+        // here step the same way on every run.
+        void startFromHome()
+        {
+            boot();
+            mount.stopSlewing(ALL_DIRECTIONS | TRACKING);
+            mount.waitUntilStopped(ALL_DIRECTIONS);
+            EEPROM.clear();
+            mount.readConfiguration();
+            mount.setHome(true);
+            mount.setHA(DayTime(3, 0, 0));
+            inSerialControl = false;
+
+            // Nothing moves, so the interrupt stops. Tracking starts it again from now.
+            mount.setInterruptPeriodCallback(setInterruptPeriod);
+            mount.startSlewing(TRACKING);
+        }
+
+        // Runs a Meade command (without the '#') and returns the reply
+        String command(const char* cmd)
+        {
+            return MeadeCommandProcessor::instance()->processCommand(String(cmd));
+        }
+
+        // Sets the target RA to the given hour angle in seconds (west of the meridian positive). Returns the :Sr reply.
+        String setTargetHourAngle(long hourAngle)
+        {
+            long ra = mount.hourAngleOf(DayTime()) - hourAngle;
+            ra = ((ra % 86400L) + 86400L) % 86400L;
+            char cmd[20];
+            snprintf(cmd, sizeof(cmd), ":Sr%02ld:%02ld:%02ld", ra / 3600, (ra / 60) % 60, ra % 60);
+            return command(cmd);
+        }
+
+        // Advances virtual time by the given number of microseconds, running the
+        // stepper interrupt and the mount loop as the main loop would.
+        void run(unsigned long long micros)
+        {
+            unsigned long long end = host::currentMicros() + micros;
+            while (host::currentMicros() < end)
+            {
+                host::advanceMicros(100);
+                stepperInterrupt(host::currentMicros());
+                mount.loop();
+            }
+        }
+    }
+}
@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include "unity.h"
+#include "simulation.h"
+#include "CommandTransport.hpp"
+
+namespace test {
+    namespace command_transport {
+
+        // Transports live for the whole run, like the ones in the firmware do.
+        HostSerial clientA;
+        HostSerial clientB;
+        CommandTransport transportA(&clientA, &simulation::mount, DEBUG_SERIAL, "ClientA");
+        CommandTransport transportB(&clientB, &simulation::mount, DEBUG_SERIAL, "ClientB");
+
+        unsigned long long trackingStoppedAt = 0;
+
+        void startTest()
+        {
+            simulation::boot();
+            simulation::mount.startSlewing(TRACKING);
+            for (HostSerial* client : { &clientA, &clientB })
+            {
+                while (client->read() >= 0)
+                {
+                }
+                client->takeOutput();
+                client->setTransmitRate(0);
+            }
+            transportA.reset();
+            transportB.reset();
+        }
+
+        // Notes when the mount stops tracking while the stepper interrupt runs.
+        void watchForStop(unsigned long long nowMicros)
+        {
+            simulation::stepperInterrupt(nowMicros);
+            if ((trackingStoppedAt == 0) && !simulation::mount.isSlewingTRK())
+            {
+                trackingStoppedAt = nowMicros;
+            }
+        }
+
+        void test_ack_and_framing()
+        {
+            startTest();
+
+            clientA.inject("\x06");
+            transportA.processInput();
+            TEST_ASSERT_EQUAL_STRING("1", clientA.takeOutput().c_str());
+
+            // Stray bytes between commands are dropped, partial commands wait for their '#'
+            clientA.inject("#Ka#\r\n:GV");
+            transportA.processInput();
+            TEST_ASSERT_EQUAL_STRING("", clientA.takeOutput().c_str());
+            clientA.inject("P#");
+            transportA.processInput();
+            TEST_ASSERT_EQUAL_STRING("OpenAstroTracker#", clientA.takeOutput().c_str());
+        }
+
+        void test_overlong_command_is_dropped()
+        {
+            startTest();
+
+            clientA.inject(":GVP0123456789012345678901234567890123456789#:GVP#");
+            transportA.processInput();
+            TEST_ASSERT_EQUAL_STRING("OpenAstroTracker#", clientA.takeOutput().c_str());
+        }
+
+        void test_stop_overtakes_queued_polls()
+        {
+            startTest();
+            clientA.setTransmitRate(SERIAL_BAUDRATE);
+
+            // A client that pipelines its polling, with a stop right behind it
+            for (int i = 0; i < 20; i++)
+            {
+                clientA.inject(":GR#");
+            }
+            clientA.inject(":Q#");
+
+            trackingStoppedAt = 0;
+            host::setIdleHook(watchForStop);
+            unsigned long long sentAt = host::currentMicros();
+            transportA.processInput();
+            host::setIdleHook(simulation::stepperInterrupt);
+
+            // Answering the polls takes over 30ms at 57600 baud. The stop must not wait for that.
+            TEST_ASSERT_NOT_EQUAL(0, trackingStoppedAt);
+            TEST_ASSERT_LESS_THAN(1000, (long)(trackingStoppedAt - sentAt));
+
+            std::string replies = clientA.takeOutput();
+            TEST_ASSERT_EQUAL('1', replies[0]);
+            TEST_ASSERT_EQUAL(20, (int)std::count(replies.begin(), replies.end(), '#'));
+        }
+
+        void test_stop_ends_a_slew_queued_ahead_of_it()
+        {
+            startTest();
+
+            // The stop runs first, then again after the slew it overtook
+            clientA.inject(":Sr03:00:00#:Sd+30*00:00#:MS#:Q#");
+            transportA.processInput();
+            TEST_ASSERT_EQUAL_STRING("1110", clientA.takeOutput().c_str());
+            TEST_ASSERT_FALSE(simulation::mount.isSlewingRAorDEC());
+            simulation::run(2000000);
+            TEST_ASSERT_FALSE(simulation::mount.isSlewingRAorDEC());
+
+            // Also when the slew waits on another transport, behind a poll
+            clientB.inject(":GVP#:Sr03:00:00#:Sd+30*00:00#:MS#");
+            clientA.inject(":Q#");
+            transportB.processInput();
+            TEST_ASSERT_EQUAL_STRING("1", clientA.takeOutput().c_str());
+            TEST_ASSERT_EQUAL_STRING("OpenAstroTracker#110", clientB.takeOutput().c_str());
+            TEST_ASSERT_FALSE(simulation::mount.isSlewingRAorDEC());
+
+            // Commands sent after the stop are not affected
+            clientA.inject(":Q#:MS#");
+            transportA.processInput();
+            TEST_ASSERT_EQUAL_STRING("10", clientA.takeOutput().c_str());
+            TEST_ASSERT_TRUE(simulation::mount.isSlewingRAorDEC());
+            simulation::mount.stopSlewing(ALL_DIRECTIONS);
+            simulation::mount.waitUntilStopped(ALL_DIRECTIONS);
+        }
+
+        void test_stop_latency_under_polling_load()
+        {
+            startTest();
+            clientA.setTransmitRate(SERIAL_BAUDRATE);
+            clientB.setTransmitRate(SERIAL_BAUDRATE);
+
+            trackingStoppedAt = 0;
+            host::setIdleHook(watchForStop);
+            unsigned long long sentAt = 0;
+            for (int i = 0; (i < 200) && (trackingStoppedAt == 0); i++)
+            {
+                // Client A keeps a backlog of status queries (as a hub multiplexing
+                // several clients would) and the main loop spends 2ms on display work.
+                while (clientA.available() < 80)
+                {
+                    clientA.inject(":GR#:GD#:GX#");
+                }
+                if (i == 50)
+                {
+                    clientB.inject(":GR#:GD#:Q#");
+                    sentAt = host::currentMicros();
+                }
+                transportA.processInput();
+                transportB.processInput();
+                simulation::run(2000);
+            }
+            host::setIdleHook(simulation::stepperInterrupt);
+
+            TEST_ASSERT_NOT_EQUAL(0, trackingStoppedAt);
+            TEST_ASSERT_LESS_THAN(5000, (long)(trackingStoppedAt - sentAt));
+        }
+
+        void run() {
+            RUN_TEST(test_ack_and_framing);
+            RUN_TEST(test_overlong_command_is_dropped);
+            RUN_TEST(test_stop_overtakes_queued_polls);
+            RUN_TEST(test_stop_ends_a_slew_queued_ahead_of_it);
+            RUN_TEST(test_stop_latency_under_polling_load);
+        }
+    }
+}
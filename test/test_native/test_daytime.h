@@ -0,0 +1,143 @@
+#pragma once
+
+#include <chrono>
+#include <type_traits>
+#include "unity.h"
+#include "DayTime.hpp"
+#include "Declination.hpp"
+#include "Latitude.hpp"
+#include "Longitude.hpp"
+
+namespace test {
+    namespace daytime {
+
+        static_assert(std::is_trivially_copyable<DayTime>::value, "DayTime is a plain value");
+        static_assert(std::is_trivially_copyable<Declination>::value, "Declination is a plain value");
+        static_assert(std::is_trivially_copyable<Latitude>::value, "Latitude is a plain value");
+        static_assert(std::is_trivially_copyable<Longitude>::value, "Longitude is a plain value");
+        static_assert(sizeof(Declination) == sizeof(long), "Declination is only its seconds");
+        static_assert(DayTime(12, 34, 56).getTotalSeconds() == 45296L, "DayTime can be a constant");
+        static_assert(Declination(-5, 30, 0).getTotalSeconds() == -19800L, "Declination can be a constant");
+
+        // The way the classes were before: range checks as virtual functions, called from
+        // the arithmetic in DayTime.cpp
+        class VirtualDayTime
+        {
+        public:
+            VirtualDayTime(long seconds) : totalSeconds(seconds) {}
+            virtual ~VirtualDayTime() {}
+            __attribute__((noinline)) void addSeconds(long deltaSecs)
+            {
+                totalSeconds += deltaSecs;
+                checkHours();
+            }
+            virtual void checkHours()
+            {
+                while (totalSeconds >= 24L * 3600L)
+                {
+                    totalSeconds -= 24L * 3600L;
+                }
+                while (totalSeconds < 0)
+                {
+                    totalSeconds += 24L * 3600L;
+                }
+            }
+            long totalSeconds;
+        };
+
+        class VirtualDeclination : public VirtualDayTime
+        {
+        public:
+            VirtualDeclination(long seconds) : VirtualDayTime(seconds) {}
+            virtual void checkHours() override
+            {
+                totalSeconds = constrain(totalSeconds, -180L * 3600L, 0L);
+            }
+        };
+
+        void test_each_type_keeps_its_range()
+        {
+            DayTime time(23, 59, 30);
+            time.addSeconds(45);
+            TEST_ASSERT_EQUAL(15, time.getTotalSeconds());
+            time.addMinutes(-1);
+            TEST_ASSERT_EQUAL(24L * 3600L - 45, time.getTotalSeconds());
+
+            Declination dec(-1, 0, 0);
+            dec.addMinutes(90);
+            TEST_ASSERT_EQUAL(0, dec.getTotalSeconds());
+            dec.addDegrees(-200);
+            TEST_ASSERT_EQUAL(-180L * 3600L, dec.getTotalSeconds());
+            dec.addSeconds(30);
+            TEST_ASSERT_EQUAL(-180L * 3600L + 30, dec.getTotalSeconds());
+            dec.set(-12, 0, 0);
+            TEST_ASSERT_EQUAL(-12L * 3600L, dec.getTotalSeconds());
+
+            Longitude longitude;
+            TEST_ASSERT_EQUAL(DayTime::PARSE_OK, Longitude::ParseFromMeade("270*00", longitude));
+            TEST_ASSERT_EQUAL(90L * 3600L, longitude.getTotalSeconds());
+        }
+
+        void test_to_string_into_own_buffers()
+        {
+            char first[32];
+            char second[32];
+            DayTime ra(1, 2, 3);
+            DayTime other(4, 5, 6);
+            TEST_ASSERT_EQUAL_STRING("01:02:03 (1.03417)", ra.ToString(first));
+            TEST_ASSERT_EQUAL_STRING("04:05:06 (4.08500)", other.ToString(second));
+            TEST_ASSERT_EQUAL_STRING("01:02:03 (1.03417)", first);
+            TEST_ASSERT_EQUAL_STRING(ra.ToString(), first);
+
+            Declination dec = Declination::FromSeconds(45L * 3600L + 30);
+            TEST_ASSERT_EQUAL_STRING(dec.ToString(), dec.ToString(first));
+        }
+
+        // Compares the size and the time to add seconds against the classes with a vtable
+        void test_benchmark_against_virtual()
+        {
+            typedef std::chrono::steady_clock clock;
+            const long rounds = 2000000;
+
+            // Through pointers, as the firmware passes them around, so the calls stay virtual
+            VirtualDayTime virtualRA(0);
+            VirtualDeclination virtualDEC(-90L * 3600L);
+            VirtualDayTime *volatile virtualRAPointer = &virtualRA;
+            VirtualDayTime *volatile virtualDECPointer = &virtualDEC;
+            clock::time_point start = clock::now();
+            for (long i = 0; i < rounds; i += 2)
+            {
+                virtualRAPointer->addSeconds((i & 2) ? 7 : -7);
+                virtualDECPointer->addSeconds((i & 2) ? 7 : -7);
+            }
+            long long virtualNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+            DayTime ra;
+            Declination dec(-90, 0, 0);
+            DayTime *volatile raPointer = &ra;
+            Declination *volatile decPointer = &dec;
+            start = clock::now();
+            for (long i = 0; i < rounds; i += 2)
+            {
+                raPointer->addSeconds((i & 2) ? 7 : -7);
+                decPointer->addSeconds((i & 2) ? 7 : -7);
+            }
+            long long valueNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+            TEST_ASSERT_EQUAL(virtualRA.totalSeconds, ra.getTotalSeconds());
+            TEST_ASSERT_EQUAL(virtualDEC.totalSeconds, dec.getTotalSeconds());
+
+            char message[160];
+            sprintf(message, "DayTime: %d bytes, was %d with a vtable. addSeconds %.2f ns, was %.2f ns", (int)sizeof(DayTime),
+                (int)sizeof(VirtualDayTime), 1.0 * valueNanos / rounds, 1.0 * virtualNanos / rounds);
+            TEST_MESSAGE(message);
+            TEST_ASSERT_LESS_THAN(sizeof(VirtualDayTime), sizeof(DayTime));
+        }
+
+        void run() {
+            RUN_TEST(test_each_type_keeps_its_range);
+            RUN_TEST(test_to_string_into_own_buffers);
+            RUN_TEST(test_benchmark_against_virtual);
+        }
+    }
+}
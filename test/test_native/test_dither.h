@@ -0,0 +1,135 @@
+#pragma once
+
+#include <math.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "simulation.h"
+
+// Dithering with guide pulses, and what it does to the position the mount reports
+namespace test {
+    namespace dither {
+
+        using simulation::command;
+
+        // Slews to an hour west of the meridian at DEC +45 and tracks there
+        void startOnTarget()
+        {
+            simulation::startFromHome();
+            simulation::setTargetHourAngle(3600L);
+            command(":Sd+45*00:00");
+            TEST_ASSERT_EQUAL_STRING("0", command(":MS").c_str());
+            for (int i = 0; (i < 1200) && simulation::mount.isSlewingRAorDEC(); i++)
+            {
+                simulation::run(100000);
+            }
+            TEST_ASSERT_FALSE(simulation::mount.isSlewingRAorDEC());
+            TEST_ASSERT_TRUE(simulation::mount.isSlewingTRK());
+        }
+
+        // Checks the :XOG reply. DEC goes in whole steps, and its guide pulses end with a step of ramp down.
+        void assertStatus(int settled, int ra, int dec)
+        {
+            int gotSettled;
+            long gotRA, gotDEC;
+            TEST_ASSERT_EQUAL(3, sscanf(command(":XOG").c_str(), "%d,%ld,%ld#", &gotSettled, &gotRA, &gotDEC));
+            TEST_ASSERT_EQUAL(settled, gotSettled);
+            TEST_ASSERT_INT_WITHIN(1, ra, gotRA);
+            TEST_ASSERT_INT_WITHIN(2.5f * 3600.0f / DEC_STEPS_PER_DEGREE, dec, gotDEC);
+        }
+
+        // Runs until the dither settled and returns the seconds that took
+        float settle()
+        {
+            float seconds = 0;
+            while (!simulation::mount.isDitherSettled() && (seconds < 40.0f))
+            {
+                simulation::run(50000);
+                seconds += 0.05f;
+            }
+            TEST_ASSERT_TRUE(simulation::mount.isDitherSettled());
+            return seconds;
+        }
+
+        // The first point of the spiral is half the distance east. The RA position takes up what TRK moved
+        // on top of tracking, so the reported coordinates follow, and going back to the start undoes it.
+        void test_spiral_moves_the_position()
+        {
+            startOnTarget();
+            long raSeconds = simulation::mount.currentRA().getTotalSeconds();
+            long decSeconds = simulation::mount.currentDEC().getTotalSeconds();
+            long raSteps = simulation::mount.getCurrentStepperPosition(EAST);
+            long trkSteps = simulation::mount.getCurrentStepperPosition(TRACKING);
+            unsigned long startedAt = millis();
+
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XOS300").c_str());
+            assertStatus(0, 150, 0);
+            TEST_ASSERT_TRUE(simulation::mount.isGuiding());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XOS300").c_str());
+
+            // 150" on the sky at DEC 45 is 212" of RA, 14 seconds of RA time
+            float seconds = settle();
+            TEST_ASSERT_FLOAT_WITHIN(1.0f, 212.0f / 15.0f / (2.0f - RA_PULSE_MULTIPLIER) + DITHER_SETTLE_TIME / 1000.0f, seconds);
+            assertStatus(1, 150, 0);
+            TEST_ASSERT_INT_WITHIN(1, raSeconds + 14, simulation::mount.currentRA().getTotalSeconds());
+            TEST_ASSERT_EQUAL(decSeconds, simulation::mount.currentDEC().getTotalSeconds());
+
+            long raMoved = simulation::mount.getCurrentStepperPosition(EAST) - raSteps;
+            float tracked = simulation::mount.getSpeed(TRACKING) * (millis() - startedAt) / 1000.0f;
+            float trkMoved = (simulation::mount.getCurrentStepperPosition(TRACKING) - trkSteps - tracked) * RA_SLEW_MICROSTEPPING / RA_TRACKING_MICROSTEPPING;
+            TEST_ASSERT_FLOAT_WITHIN(fabsf(raMoved) * 0.02f + 3.0f, raMoved, trkMoved);
+            TEST_ASSERT_TRUE(raMoved < 0);
+
+            // Second point is north east, the DEC axis moves too
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XOS300").c_str());
+            settle();
+            assertStatus(1, 150, 150);
+            TEST_ASSERT_INT_WITHIN(2.5f * 3600.0f / DEC_STEPS_PER_DEGREE, 150, abs(simulation::mount.currentDEC().getTotalSeconds() - decSeconds));
+
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XOC").c_str());
+            settle();
+            assertStatus(1, 0, 0);
+            TEST_ASSERT_INT_WITHIN(1, raSteps, simulation::mount.getCurrentStepperPosition(EAST));
+            TEST_ASSERT_INT_WITHIN(1, raSeconds, simulation::mount.currentRA().getTotalSeconds());
+            TEST_ASSERT_INT_WITHIN(2.5f * 3600.0f / DEC_STEPS_PER_DEGREE, decSeconds, simulation::mount.currentDEC().getTotalSeconds());
+        }
+
+        void test_random_stays_within_the_distance()
+        {
+            startOnTarget();
+            for (int i = 0; i < 8; i++)
+            {
+                TEST_ASSERT_EQUAL_STRING("1#", command(":XOR40").c_str());
+                settle();
+                float ra, dec;
+                simulation::mount.getDitherOffset(ra, dec);
+                TEST_ASSERT_FLOAT_WITHIN(41.0f, 0.0f, ra);
+                TEST_ASSERT_FLOAT_WITHIN(41.0f + 2.5f * 3600.0f / DEC_STEPS_PER_DEGREE, 0.0f, dec);
+            }
+        }
+
+        // Only while just tracking, and a slew makes where it goes the new start
+        void test_slews_start_over()
+        {
+            startOnTarget();
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XOX40").c_str());
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XOS40").c_str());
+            settle();
+            assertStatus(1, 20, 0);
+
+            command(":Sd+40*00:00");
+            command(":MS");
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XOS40").c_str());
+            TEST_ASSERT_EQUAL_STRING("1,0,0#", command(":XOG").c_str());
+
+            simulation::mount.stopSlewing(ALL_DIRECTIONS | TRACKING);
+            simulation::mount.waitUntilStopped(ALL_DIRECTIONS);
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XOS40").c_str());
+        }
+
+        void run() {
+            RUN_TEST(test_spiral_moves_the_position);
+            RUN_TEST(test_random_stays_within_the_distance);
+            RUN_TEST(test_slews_start_over);
+        }
+    }
+}
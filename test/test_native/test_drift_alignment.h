@@ -0,0 +1,99 @@
+#pragma once
+
+#include <stdio.h>
+#include "unity.h"
+#include "simulation.h"
+
+// The drift alignment, run by the mount while the command processor keeps answering
+namespace test {
+    namespace drift_alignment {
+
+        using simulation::command;
+
+        char state()
+        {
+            return command(":XDG")[0];
+        }
+
+        // Runs the mount until the drift alignment is in the given state, for at most the given seconds
+        bool runUntil(char wanted, int seconds)
+        {
+            for (int i = 0; (i < seconds * 10) && (state() != wanted); i++)
+            {
+                simulation::run(100000);
+            }
+            return state() == wanted;
+        }
+
+        long passSteps()
+        {
+            return floor(simulation::mount.getStepsPerDegree(RA_STEPS) * 5.3f / 60.0f);
+        }
+
+        void test_passes_run_while_commands_are_answered()
+        {
+            simulation::startFromHome();
+            long raSteps = simulation::mount.getCurrentStepperPosition(EAST);
+            unsigned long startedAt = millis();
+            TEST_ASSERT_EQUAL_STRING("", command(":XD033").c_str());
+            TEST_ASSERT_TRUE(millis() - startedAt < 10);
+            TEST_ASSERT_EQUAL_STRING("P,64#", command(":XDG").c_str());
+            TEST_ASSERT_FALSE(simulation::mount.isSlewingTRK());
+
+            // Half way through the east pass RA moved about half of it, and the mount still answers
+            TEST_ASSERT_TRUE(runUntil('E', 5));
+            simulation::run(15000000);
+            TEST_ASSERT_INT_WITHIN(passSteps() / 10, raSteps + passSteps() / 2, simulation::mount.getCurrentStepperPosition(EAST));
+            TEST_ASSERT_EQUAL_STRING("|#", command(":D").c_str());
+
+            TEST_ASSERT_TRUE(runUntil('W', 25));
+            TEST_ASSERT_INT_WITHIN(1, raSteps + passSteps() - 20, simulation::mount.getCurrentStepperPosition(EAST));
+            TEST_ASSERT_TRUE(runUntil('I', 40));
+
+            // Back where it started, tracking again
+            TEST_ASSERT_EQUAL(raSteps, simulation::mount.getCurrentStepperPosition(EAST));
+            TEST_ASSERT_TRUE(simulation::mount.isSlewingTRK());
+            TEST_ASSERT_INT_WITHIN(2000, 2 * 30000 + 4500, millis() - startedAt);
+        }
+
+        void test_stops_and_slews_end_it()
+        {
+            simulation::startFromHome();
+            command(":XD033");
+            TEST_ASSERT_TRUE(runUntil('E', 5));
+            simulation::run(5000000);
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XDX").c_str());
+            TEST_ASSERT_EQUAL_STRING("I,0#", command(":XDG").c_str());
+            TEST_ASSERT_TRUE(simulation::mount.isSlewingTRK());
+            simulation::run(2000000);
+            TEST_ASSERT_FALSE(simulation::mount.isSlewingRAorDEC());
+
+            // A slew takes over
+            command(":XD033");
+            TEST_ASSERT_TRUE(runUntil('E', 5));
+            command(":Sd+85*00:00");
+            TEST_ASSERT_EQUAL_STRING("0", command(":MS").c_str());
+            TEST_ASSERT_EQUAL('I', state());
+            for (int i = 0; (i < 1200) && simulation::mount.isSlewingRAorDEC(); i++)
+            {
+                simulation::run(100000);
+            }
+            TEST_ASSERT_TRUE(simulation::mount.isSlewingTRK());
+
+            // So does :Q, which stops the mount as it stops slews
+            command(":XD033");
+            TEST_ASSERT_TRUE(runUntil('E', 5));
+            TEST_ASSERT_EQUAL_STRING("1", command(":Q").c_str());
+            TEST_ASSERT_EQUAL('I', state());
+            simulation::run(5000000);
+            TEST_ASSERT_EQUAL('I', state());
+            TEST_ASSERT_FALSE(simulation::mount.isSlewingRAorDEC());
+            simulation::mount.startSlewing(TRACKING);
+        }
+
+        void run() {
+            RUN_TEST(test_passes_run_while_commands_are_answered);
+            RUN_TEST(test_stops_and_slews_end_it);
+        }
+    }
+}
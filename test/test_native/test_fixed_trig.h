@@ -0,0 +1,176 @@
+#pragma once
+
+#include <chrono>
+#include <math.h>
+#include "unity.h"
+#include "simulation.h"
+#include "FixedTrig.hpp"
+
+namespace test {
+    namespace fixed_trig {
+
+        const double arcsecPerUnit = 1296000.0 / 4294967296.0;
+
+        double radians(FixedTrig::Angle angle)
+        {
+            return (int32_t)angle * (2.0 * M_PI / 4294967296.0);
+        }
+
+        // Arcseconds between two angles, the short way round
+        double arcsecBetween(FixedTrig::Angle a, FixedTrig::Angle b)
+        {
+            return fabs((double)(int32_t)(a - b)) * arcsecPerUnit;
+        }
+
+        void test_sin_and_cos_within_one_lsb()
+        {
+            int worst = 0;
+            for (uint32_t i = 0; i < 1000000; i++)
+            {
+                FixedTrig::Angle angle = i * 4294967u + i / 7;
+                int expectedSin = lround(sin(radians(angle)) * 32768.0);
+                int expectedCos = lround(cos(radians(angle)) * 32768.0);
+                worst = max(worst, abs(FixedTrig::sin(angle) - min(expectedSin, 32767)));
+                worst = max(worst, abs(FixedTrig::cos(angle) - min(expectedCos, 32767)));
+            }
+            TEST_ASSERT_LESS_OR_EQUAL(1, worst);
+            TEST_ASSERT_EQUAL(0, FixedTrig::sin(0));
+            TEST_ASSERT_EQUAL(32767, FixedTrig::sin(FixedTrig::QUARTER_TURN));
+            TEST_ASSERT_EQUAL(-32767, FixedTrig::cos(FixedTrig::HALF_TURN));
+        }
+
+        void test_atan2_within_arcseconds()
+        {
+            double worst = 0;
+            const int32_t scales[] = { 1, 100, 32767, 1000000, 2000000000 };
+            for (int32_t scale : scales)
+            {
+                for (int i = 0; i < 20000; i++)
+                {
+                    double direction = i * (2.0 * M_PI / 20000.0) + 0.0001;
+                    int32_t x = lround(cos(direction) * scale);
+                    int32_t y = lround(sin(direction) * scale);
+                    if ((x == 0) && (y == 0))
+                    {
+                        continue;
+                    }
+                    FixedTrig::Angle expected = (FixedTrig::Angle)(int64_t)llround(atan2((double)y, (double)x) * 4294967296.0 / (2.0 * M_PI));
+                    worst = max(worst, arcsecBetween(FixedTrig::atan2(y, x), expected));
+                }
+            }
+            char message[80];
+            sprintf(message, "atan2: worst error %.2f\"", worst);
+            TEST_MESSAGE(message);
+            TEST_ASSERT_LESS_THAN(4000, worst * 1000);
+            TEST_ASSERT_EQUAL(0, FixedTrig::atan2(0, 0));
+            TEST_ASSERT_EQUAL(FixedTrig::HALF_TURN, FixedTrig::atan2(0, -5));
+        }
+
+        void test_sqrt_and_conversions()
+        {
+            for (uint32_t value = 0; value < 4000000000u; value += 999983u)
+            {
+                TEST_ASSERT_EQUAL((uint16_t)floor(sqrt((double)value)), FixedTrig::sqrt(value));
+            }
+            TEST_ASSERT_EQUAL(65535, FixedTrig::sqrt(0xFFFFFFFFu));
+
+            for (long arcsec = -648000L; arcsec < 648000L; arcsec += 997)
+            {
+                TEST_ASSERT_INT_WITHIN(1, arcsec, FixedTrig::toArcSeconds(FixedTrig::fromArcSeconds(arcsec)));
+            }
+            TEST_ASSERT_EQUAL(FixedTrig::QUARTER_TURN, FixedTrig::fromDegrees(-270.0f));
+            TEST_ASSERT_FLOAT_WITHIN(0.0001f, -90.0f, FixedTrig::toDegrees(FixedTrig::fromArcSeconds(270L * 3600L)));
+        }
+
+        // Where the mount points, from the same hour angle with double precision
+        void expectedAltAz(double haHours, double decDegrees, double latDegrees, double &altitude, double &azimuth)
+        {
+            double ha = haHours * M_PI / 12.0, dec = decDegrees * M_PI / 180.0, lat = latDegrees * M_PI / 180.0;
+            double x = sin(dec) * cos(lat) - cos(dec) * sin(lat) * cos(ha);
+            double y = -cos(dec) * sin(ha);
+            double z = sin(dec) * sin(lat) + cos(dec) * cos(lat) * cos(ha);
+            altitude = atan2(z, sqrt(x * x + y * y)) * 180.0 / M_PI * 3600.0;
+            azimuth = atan2(y, x) * 180.0 / M_PI * 3600.0;
+            if (azimuth < 0)
+            {
+                azimuth += 360.0 * 3600.0;
+            }
+        }
+
+        void test_mount_alt_az()
+        {
+            simulation::startFromHome();
+            Mount &mount = simulation::mount;
+
+            // At home the mount points at the pole, which is as high as the site's latitude
+            long altitude, azimuth;
+            mount.currentAltAz(altitude, azimuth);
+            TEST_ASSERT_INT_WITHIN(10, mount.latitude().getTotalSeconds(), altitude);
+            TEST_ASSERT_TRUE((azimuth < 10) || (azimuth > 360L * 3600L - 10));
+
+            const float decs[] = { 60.0f, 20.0f, -10.0f };
+            const float has[] = { -4.5f, 0.5f, 3.0f };
+            for (int i = 0; i < 3; i++)
+            {
+                DayTime ra(mount.LST());
+                ra.addSeconds(lround(-has[i] * 3600.0f));
+                mount.syncPosition(ra, Declination::FromSeconds(lround(decs[i] * 3600.0f)));
+
+                // The hour angle the mount works with, including the time it has been tracking
+                DayTime lst(mount.LST());
+                lst.addSeconds(mount.getCurrentStepperPosition(TRACKING) / mount.getSpeed(TRACKING));
+                double ha = lst.getTotalHours() - mount.currentRA().getTotalHours();
+                double expectedAltitude, expectedAzimuth;
+                expectedAltAz(ha, decs[i], mount.latitude().getTotalHours(), expectedAltitude, expectedAzimuth);
+
+                mount.currentAltAz(altitude, azimuth);
+                TEST_ASSERT_FLOAT_WITHIN(15.0, expectedAltitude, altitude);
+                TEST_ASSERT_FLOAT_WITHIN(15.0, expectedAzimuth, azimuth);
+            }
+
+            String reply = MeadeCommandProcessor::instance()->processCommand(":GA");
+            TEST_ASSERT_EQUAL(10, reply.length());
+            TEST_ASSERT_EQUAL('\'', reply[6]);
+            reply = MeadeCommandProcessor::instance()->processCommand(":GZ");
+            TEST_ASSERT_EQUAL(10, reply.length());
+            TEST_ASSERT_EQUAL('*', reply[3]);
+        }
+
+        // Compares against the float functions on the host. On the Mega the difference is far larger,
+        // as it has no FPU (see FixedTrig.hpp for estimates).
+        void test_benchmark_against_float()
+        {
+            typedef std::chrono::steady_clock clock;
+            const long rounds = 1000000;
+            volatile long sink = 0;
+
+            clock::time_point start = clock::now();
+            for (long i = 0; i < rounds; i++)
+            {
+                float angle = i * 0.001f;
+                sink = sink + (long)(sinf(angle) * 32768.0f) + (long)(atan2f((float)(i & 0xFFF), 2048.0f) * 1000.0f);
+            }
+            long long floatNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+            start = clock::now();
+            for (long i = 0; i < rounds; i++)
+            {
+                FixedTrig::Angle angle = i * 683565u;
+                sink = sink + FixedTrig::sin(angle) + (long)(FixedTrig::atan2(i & 0xFFF, 2048) >> 16);
+            }
+            long long fixedNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+            char message[120];
+            sprintf(message, "sin+atan2: float %.1f ns, fixed point %.1f ns", 1.0 * floatNanos / rounds, 1.0 * fixedNanos / rounds);
+            TEST_MESSAGE(message);
+        }
+
+        void run() {
+            RUN_TEST(test_sin_and_cos_within_one_lsb);
+            RUN_TEST(test_atan2_within_arcseconds);
+            RUN_TEST(test_sqrt_and_conversions);
+            RUN_TEST(test_mount_alt_az);
+            RUN_TEST(test_benchmark_against_float);
+        }
+    }
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <stdio.h>
+#include "unity.h"
+#include "simulation.h"
+#include "StepRates.hpp"
+
+// Guide pulses from the ST-4 guide port, driven through the pin model of the host build
+namespace test {
+    namespace guide_port {
+
+        using simulation::command;
+
+        // The guider pulls a line to ground while it guides
+        void setLine(byte pin, bool active)
+        {
+            host::setPinState(pin, active ? LOW : HIGH);
+        }
+
+        int pulses()
+        {
+            int count;
+            TEST_ASSERT_EQUAL(1, sscanf(command(":XTG").c_str(), "%d,", &count));
+            return count;
+        }
+
+        // The main loop only gets to the edges 40 ms late (delay() runs the stepper interrupt, but not
+        // the loop), and the pulse still lasts as long as the line was active.
+        void test_pulse_length_comes_from_the_edges()
+        {
+            simulation::startFromHome();
+            command(":XTC");
+            command(":XTA0");
+            long trkSteps = simulation::mount.getCurrentStepperPosition(TRACKING);
+            unsigned long startedAt = micros();
+
+            setLine(GUIDE_PORT_WEST_PIN, true);
+            TEST_ASSERT_EQUAL(0, simulation::mount.guidePort().activeLines());
+            delay(40);
+            TEST_ASSERT_FALSE(simulation::mount.isGuiding());
+            simulation::run(1000);
+            TEST_ASSERT_TRUE(simulation::mount.isGuiding());
+            TEST_ASSERT_EQUAL(WEST, simulation::mount.guidePort().activeLines());
+
+            simulation::run(1234000 - 41000);
+            setLine(GUIDE_PORT_WEST_PIN, false);
+            delay(25);
+            simulation::run(1000);
+            TEST_ASSERT_TRUE(simulation::mount.isGuiding());
+            simulation::run(20000);
+            TEST_ASSERT_FALSE(simulation::mount.isGuiding());
+
+            TEST_ASSERT_EQUAL(1, pulses());
+            float west = RA_PULSE_MULTIPLIER * siderealDegreesInHour * 1.234f;
+            float raRMS;
+            sscanf(command(":XTG").c_str(), "%*d,%*f,%f", &raRMS);
+            TEST_ASSERT_FLOAT_WITHIN(0.01f, west, raRMS);
+
+            // TRK moved the pulse on top of tracking
+            simulation::run(2000000);
+            float tracked = simulation::mount.getSpeed(TRACKING) * (micros() - startedAt) / 1e6f;
+            float moved = simulation::mount.getCurrentStepperPosition(TRACKING) - trkSteps - tracked;
+            TEST_ASSERT_FLOAT_WITHIN(1.0f, RA_PULSE_MULTIPLIER * simulation::mount.getSpeed(TRACKING) * 1.234f, moved);
+        }
+
+        // DEC lines move DEC. A line that stays active stops at GUIDE_PORT_MAX_PULSE, and lines are left alone during slews.
+        void test_dec_stuck_lines_and_slews()
+        {
+            simulation::startFromHome();
+            command(":XTC");
+            long decSteps = simulation::mount.getCurrentStepperPosition(NORTH);
+            setLine(GUIDE_PORT_NORTH_PIN, true);
+            simulation::run(2000000);
+            setLine(GUIDE_PORT_NORTH_PIN, false);
+            simulation::run(1000000);
+            TEST_ASSERT_FALSE(simulation::mount.isGuiding());
+            // DEC guide pulses end with a step or two of ramp down
+            float decMoved = abs(simulation::mount.getCurrentStepperPosition(NORTH) - decSteps);
+            TEST_ASSERT_FLOAT_WITHIN(2.5f, DEC_PULSE_MULTIPLIER * siderealDegreesInHour * 2.0f * DEC_STEPS_PER_DEGREE / 3600.0f, decMoved);
+            TEST_ASSERT_EQUAL(1, pulses());
+
+            setLine(GUIDE_PORT_EAST_PIN, true);
+            simulation::run(GUIDE_PORT_MAX_PULSE * 1000UL - 500000UL);
+            TEST_ASSERT_TRUE(simulation::mount.isGuiding());
+            simulation::run(1000000);
+            TEST_ASSERT_FALSE(simulation::mount.isGuiding());
+            setLine(GUIDE_PORT_EAST_PIN, false);
+            simulation::run(100000);
+            TEST_ASSERT_EQUAL(2, pulses());
+
+            command(":Sd+45*00:00");
+            TEST_ASSERT_EQUAL_STRING("0", command(":MS").c_str());
+            simulation::run(100000);
+            setLine(GUIDE_PORT_WEST_PIN, true);
+            simulation::run(500000);
+            TEST_ASSERT_FALSE(simulation::mount.isGuiding());
+            setLine(GUIDE_PORT_WEST_PIN, false);
+            simulation::run(100000);
+            TEST_ASSERT_EQUAL(2, pulses());
+        }
+
+        // A :Mg pulse that takes over from the line runs its own length, whenever the line goes inactive
+        void test_serial_pulse_replaces_the_line()
+        {
+            simulation::startFromHome();
+            setLine(GUIDE_PORT_WEST_PIN, true);
+            simulation::run(200000);
+            TEST_ASSERT_TRUE(simulation::mount.isGuiding());
+            command(":MGw1500");
+            simulation::run(100000);
+            setLine(GUIDE_PORT_WEST_PIN, false);
+            simulation::run(1300000);
+            TEST_ASSERT_TRUE(simulation::mount.isGuiding());
+            simulation::run(200000);
+            TEST_ASSERT_FALSE(simulation::mount.isGuiding());
+        }
+
+        void run() {
+            RUN_TEST(test_pulse_length_comes_from_the_edges);
+            RUN_TEST(test_dec_stuck_lines_and_slews);
+            RUN_TEST(test_serial_pulse_replaces_the_line);
+        }
+    }
+}
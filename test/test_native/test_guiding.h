@@ -0,0 +1,138 @@
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include "unity.h"
+#include "simulation.h"
+#include "EPROMStore.hpp"
+#include "StepRates.hpp"
+
+// Guide statistics, and the tracking calibration that learns from them
+namespace test {
+    namespace guiding {
+
+        struct Statistics
+        {
+            int pulses;
+            float seconds, raRMS, decRMS, raDrift, decDrift;
+            int autoCalibration;
+        };
+
+        using simulation::command;
+
+        Statistics statistics()
+        {
+            Statistics result;
+            TEST_ASSERT_EQUAL(7, sscanf(command(":XTG").c_str(), "%d,%f,%f,%f,%f,%f,%d#", &result.pulses, &result.seconds,
+                &result.raRMS, &result.decRMS, &result.raDrift, &result.decDrift, &result.autoCalibration));
+            return result;
+        }
+
+        // Arcseconds a pulse of the given ms adds to tracking west (negative for east)
+        float westArcseconds(int ms) { return RA_PULSE_MULTIPLIER * siderealDegreesInHour * ms / 1000.0f; }
+        float eastArcseconds(int ms) { return (RA_PULSE_MULTIPLIER - 2.0f) * siderealDegreesInHour * ms / 1000.0f; }
+
+        // Runs 2 seconds, then guides like a guider that sees the star move from where the sky turns at the given
+        // TRK steps per second. The mount moves in whole steps, and TRK makes its first one straight away, so the
+        // guider takes the error from the middle of a step and leaves anything within half a step.
+        void guide(long startSteps, unsigned long long startedAt, float skySpeed)
+        {
+            simulation::run(2000000);
+            float trkStepsPerArcsecond = RA_STEPS_PER_DEGREE * (RA_TRACKING_MICROSTEPPING / RA_SLEW_MICROSTEPPING) / 3600.0f;
+            float sky = skySpeed * (host::currentMicros() - startedAt) / 1e6f;
+            float steps = sky - (simulation::mount.getCurrentStepperPosition(TRACKING) - startSteps) + 0.5f;
+            if (fabsf(steps) > 0.5f)
+            {
+                float error = steps / trkStepsPerArcsecond;
+                float perSecond = (error > 0) ? westArcseconds(1000) : eastArcseconds(1000);
+                char cmd[12];
+                sprintf(cmd, (error > 0) ? ":MGw%04d" : ":MGe%04d", (int)min(1900.0f, 1000.0f * error / perSecond));
+                command(cmd);
+            }
+        }
+
+        void test_pulses_add_up()
+        {
+            simulation::startFromHome();
+            command(":XTC");
+            command(":XTA0");
+            command(":MGw1500");
+            simulation::run(2000000);
+            command(":MGw1500");
+            simulation::run(2000000);
+            command(":MGe1000");
+            simulation::run(2000000);
+            command(":MGn2000");
+            simulation::run(3000000);
+
+            // Dithers are not the guider's
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XOS30").c_str());
+            simulation::run(1000000);
+
+            Statistics stats = statistics();
+            TEST_ASSERT_EQUAL(4, stats.pulses);
+            TEST_ASSERT_FLOAT_WITHIN(0.5f, 10.0f, stats.seconds);
+            float west = westArcseconds(1500);
+            float east = eastArcseconds(1000);
+            float north = DEC_PULSE_MULTIPLIER * siderealDegreesInHour * 2.0f;
+            TEST_ASSERT_FLOAT_WITHIN(0.01f, sqrtf((2 * west * west + east * east) / 3), stats.raRMS);
+            TEST_ASSERT_FLOAT_WITHIN(0.01f, north, stats.decRMS);
+            TEST_ASSERT_FLOAT_WITHIN(0.5f, (2 * west + east) * 60.0f / 10.0f, stats.raDrift);
+            TEST_ASSERT_FLOAT_WITHIN(0.5f, north * 60.0f / 10.0f, stats.decDrift);
+            TEST_ASSERT_EQUAL(0, stats.autoCalibration);
+
+            // Pulses while not tracking do not count either
+            simulation::mount.stopSlewing(TRACKING);
+            command(":MGw0500");
+            simulation::run(1000000);
+            TEST_ASSERT_EQUAL(4, statistics().pulses);
+
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XTC").c_str());
+            stats = statistics();
+            TEST_ASSERT_EQUAL(0, stats.pulses);
+            TEST_ASSERT_FLOAT_WITHIN(0.001f, 0.0f, stats.raRMS);
+        }
+
+        // A guider keeps the mount on a star whose sky turns 0.5% faster than the mount tracks. The
+        // calibration takes up the difference a bit every window, so in the end the mount keeps up by itself.
+        void test_calibration_learns_the_drift()
+        {
+            simulation::startFromHome();
+            command(":XTC");
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XTA1").c_str());
+            float calibration = simulation::mount.getSpeedCalibration();
+            float skySpeed = simulation::mount.getSpeed(TRACKING) * 1.005f;
+            long startSteps = simulation::mount.getCurrentStepperPosition(TRACKING);
+            unsigned long long startedAt = host::currentMicros();
+
+            for (int second = 2; second <= 40 * 60; second += 2)
+            {
+                guide(startSteps, startedAt, skySpeed);
+                if (second == 2 * GUIDE_CALIBRATION_INTERVAL)
+                {
+                    float learned = simulation::mount.getSpeedCalibration() / calibration;
+                    TEST_ASSERT_TRUE(learned > 1.0f);
+                    TEST_ASSERT_TRUE(learned < 1.0f + 2 * GUIDE_CALIBRATION_MAX_STEP + 0.00001f);
+                }
+            }
+
+            TEST_ASSERT_FLOAT_WITHIN(0.001f, 1.005f, simulation::mount.getSpeedCalibration() / calibration);
+            // EEPROM keeps the calibration to 1/10000
+            TEST_ASSERT_FLOAT_WITHIN(0.0001f, simulation::mount.getSpeedCalibration(), EEPROMStore::getSpeedFactor());
+
+            // Without the guider, TRK keeps up with the sky (it falls 5 steps behind in this time at the old speed)
+            command(":XTA0");
+            simulation::run(2000000);
+            startSteps = simulation::mount.getCurrentStepperPosition(TRACKING);
+            startedAt = host::currentMicros();
+            simulation::run(GUIDE_CALIBRATION_INTERVAL * 1000000UL);
+            float sky = skySpeed * (host::currentMicros() - startedAt) / 1e6f;
+            TEST_ASSERT_FLOAT_WITHIN(2.0f, sky, simulation::mount.getCurrentStepperPosition(TRACKING) - startSteps);
+        }
+
+        void run() {
+            RUN_TEST(test_pulses_add_up);
+            RUN_TEST(test_calibration_learns_the_drift);
+        }
+    }
+}
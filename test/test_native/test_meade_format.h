@@ -0,0 +1,138 @@
+#pragma once
+
+#include <chrono>
+#include "unity.h"
+#include "simulation.h"
+#include "MeadeCommandProcessor.hpp"
+
+namespace test {
+    namespace meade_format {
+
+        using simulation::command;
+
+        // The way RAString() built the Meade reply before
+        const char* formatRAWithSprintf(char* buffer, const DayTime& ra)
+        {
+            sprintf(buffer, "%02d:%02d:%02d#", ra.getHours(), ra.getMinutes(), ra.getSeconds());
+            return buffer;
+        }
+
+        void test_high_precision_matches_format_string()
+        {
+            char expected[24];
+            char actual[24];
+            for (long secs = 0; secs < 24L * 3600L; secs++)
+            {
+                DayTime ra(0, 0, 0);
+                ra.addSeconds(secs);
+                TEST_ASSERT_EQUAL_STRING(formatRAWithSprintf(expected, ra), ra.formatMeadeString(actual, true));
+            }
+            for (long secs = -180L * 3600L; secs <= 0; secs++)
+            {
+                Declination dec = Declination::FromSeconds(secs + 90L * 3600L);
+                dec.formatString(expected, "{d}*{m}'{s}#");
+                TEST_ASSERT_EQUAL_STRING(expected, dec.formatMeadeString(actual, true));
+            }
+        }
+
+        void test_low_precision()
+        {
+            char buffer[24];
+            TEST_ASSERT_EQUAL_STRING("12:34.9#", DayTime(12, 34, 59).formatMeadeString(buffer, false));
+            TEST_ASSERT_EQUAL_STRING("00:00.0#", DayTime(0, 0, 5).formatMeadeString(buffer, false));
+            TEST_ASSERT_EQUAL_STRING("23:59.5#", DayTime(23, 59, 30).formatMeadeString(buffer, false));
+            Declination dec;
+            Declination::ParseFromMeade("+45*30:59", dec);
+            TEST_ASSERT_EQUAL_STRING("+45*30#", dec.formatMeadeString(buffer, false));
+            Declination::ParseFromMeade("-05*01:02", dec);
+            TEST_ASSERT_EQUAL_STRING("-05*01#", dec.formatMeadeString(buffer, false));
+        }
+
+        void test_precision_toggle()
+        {
+            simulation::boot();
+
+            TEST_ASSERT_EQUAL_STRING("1", command(":Sr12:34:56").c_str());
+            TEST_ASSERT_EQUAL_STRING("1", command(":Sd-12*03:04").c_str());
+            TEST_ASSERT_EQUAL_STRING("12:34:56#", command(":Gr").c_str());
+            TEST_ASSERT_EQUAL_STRING("-12*03'04#", command(":Gd").c_str());
+
+            TEST_ASSERT_EQUAL_STRING("", command(":U").c_str());
+            TEST_ASSERT_EQUAL_STRING("12:34.9#", command(":Gr").c_str());
+            TEST_ASSERT_EQUAL_STRING("-12*03#", command(":Gd").c_str());
+
+            // Low precision coordinates are accepted in either mode
+            TEST_ASSERT_EQUAL_STRING("1", command(":Sr01:02.3").c_str());
+            TEST_ASSERT_EQUAL_STRING("1", command(":Sd+45*30").c_str());
+            TEST_ASSERT_EQUAL_STRING("01:02.3#", command(":Gr").c_str());
+            TEST_ASSERT_EQUAL_STRING("+45*30#", command(":Gd").c_str());
+
+            TEST_ASSERT_EQUAL_STRING("", command(":U").c_str());
+            TEST_ASSERT_EQUAL_STRING("01:02:18#", command(":Gr").c_str());
+            TEST_ASSERT_EQUAL_STRING("+45*30'00#", command(":Gd").c_str());
+        }
+
+        void test_alt_az_replies()
+        {
+            simulation::startFromHome();
+            long altitude, azimuth;
+            simulation::mount.currentAltAz(altitude, azimuth);
+            char expected[80];
+            snprintf(expected, sizeof(expected), "%c%02ld*%02ld'%02ld#", (altitude < 0) ? '-' : '+', labs(altitude) / 3600,
+                labs(altitude) / 60 % 60, labs(altitude) % 60);
+            TEST_ASSERT_EQUAL_STRING(expected, command(":GA").c_str());
+            snprintf(expected, sizeof(expected), "%03ld*%02ld'%02ld#", azimuth / 3600, azimuth / 60 % 60, azimuth % 60);
+            TEST_ASSERT_EQUAL_STRING(expected, command(":GZ").c_str());
+
+            command(":U");
+            snprintf(expected, sizeof(expected), "%03ld*%02ld#", azimuth / 3600, azimuth / 60 % 60);
+            TEST_ASSERT_EQUAL_STRING(expected, command(":GZ").c_str());
+            command(":U");
+        }
+
+        // Compares the integer formatting against the sprintf() path it replaced for RA
+        // and the format string path it replaced for DEC.
+        void test_benchmark_against_format_string()
+        {
+            typedef std::chrono::steady_clock clock;
+            char buffer[24];
+            volatile char sink = 0;
+            const long rounds = 200000;
+
+            clock::time_point start = clock::now();
+            for (long i = 0; i < rounds; i++)
+            {
+                DayTime ra(0, 0, 0);
+                ra.addSeconds(i * 7);
+                Declination dec = Declination::FromSeconds(i % (90L * 3600L));
+                sink = sink + formatRAWithSprintf(buffer, ra)[1];
+                sink = sink + dec.formatString(buffer, "{d}*{m}'{s}#")[1];
+            }
+            long long formatStringNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+            start = clock::now();
+            for (long i = 0; i < rounds; i++)
+            {
+                DayTime ra(0, 0, 0);
+                ra.addSeconds(i * 7);
+                Declination dec = Declination::FromSeconds(i % (90L * 3600L));
+                sink = sink + ra.formatMeadeString(buffer, true)[1];
+                sink = sink + dec.formatMeadeString(buffer, true)[1];
+            }
+            long long integerNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(clock::now() - start).count();
+
+            char message[120];
+            sprintf(message, "RA+DEC reply: format string %lld ns, integer %lld ns", formatStringNanos / rounds, integerNanos / rounds);
+            TEST_MESSAGE(message);
+            TEST_ASSERT_LESS_THAN(formatStringNanos, integerNanos);
+        }
+
+        void run() {
+            RUN_TEST(test_high_precision_matches_format_string);
+            RUN_TEST(test_low_precision);
+            RUN_TEST(test_precision_toggle);
+            RUN_TEST(test_alt_az_replies);
+            RUN_TEST(test_benchmark_against_format_string);
+        }
+    }
+}
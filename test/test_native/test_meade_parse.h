@@ -0,0 +1,144 @@
+#pragma once
+
+#include <random>
+#include "unity.h"
+#include "simulation.h"
+#include "Declination.hpp"
+#include "Latitude.hpp"
+#include "Longitude.hpp"
+#include "MeadeCommandProcessor.hpp"
+
+namespace test {
+    namespace meade_parse {
+
+        long parseSeconds(const char* s, DayTime::ParseResult expected)
+        {
+            DayTime result(0, 0, 0);
+            TEST_ASSERT_EQUAL(expected, DayTime::ParseFromMeade(s, result));
+            return result.getTotalSeconds();
+        }
+
+        void test_accepted_formats()
+        {
+            TEST_ASSERT_EQUAL(12L * 3600L + 34L * 60L + 56L, parseSeconds("12:34:56", DayTime::PARSE_OK));
+            TEST_ASSERT_EQUAL(12L * 3600L + 34L * 60L + 30L, parseSeconds("12:34.5", DayTime::PARSE_OK));
+            TEST_ASSERT_EQUAL(-(45L * 3600L + 32L * 60L + 11L), parseSeconds("-45*32:11", DayTime::PARSE_OK));
+            TEST_ASSERT_EQUAL(45L * 3600L + 32L * 60L + 11L, parseSeconds("+45*32'11", DayTime::PARSE_OK));
+            TEST_ASSERT_EQUAL(45L * 3600L + 32L * 60L, parseSeconds("+45\xDF" "32", DayTime::PARSE_OK));
+            TEST_ASSERT_EQUAL(97L * 3600L + 34L * 60L, parseSeconds("097*34", DayTime::PARSE_OK));
+            TEST_ASSERT_EQUAL(19L * 3600L + 33L * 60L + 3L, parseSeconds("19:33:03#", DayTime::PARSE_OK));
+        }
+
+        void test_rejected_formats()
+        {
+            parseSeconds("", DayTime::PARSE_MISSING_DIGIT);
+            parseSeconds("1:23:45", DayTime::PARSE_MISSING_DIGIT);
+            parseSeconds("12:3:45", DayTime::PARSE_MISSING_DIGIT);
+            parseSeconds("12:34:5", DayTime::PARSE_MISSING_DIGIT);
+            parseSeconds("12:34.", DayTime::PARSE_MISSING_DIGIT);
+            parseSeconds("1a:34:56", DayTime::PARSE_MISSING_DIGIT);
+            parseSeconds("12;34:56", DayTime::PARSE_BAD_SEPARATOR);
+            parseSeconds("+", DayTime::PARSE_MISSING_DIGIT);
+            parseSeconds("12:34:567", DayTime::PARSE_TRAILING_CHARACTERS);
+            parseSeconds("12:34:56 ", DayTime::PARSE_TRAILING_CHARACTERS);
+            parseSeconds("12:34;56", DayTime::PARSE_TRAILING_CHARACTERS);
+            parseSeconds("12:60:00", DayTime::PARSE_OUT_OF_RANGE);
+            parseSeconds("12:00:60", DayTime::PARSE_OUT_OF_RANGE);
+
+            Declination dec;
+            TEST_ASSERT_EQUAL(DayTime::PARSE_OUT_OF_RANGE, Declination::ParseFromMeade("+90*00:01", dec));
+            TEST_ASSERT_EQUAL(DayTime::PARSE_OK, Declination::ParseFromMeade("-90*00:00", dec));
+            Latitude lat;
+            TEST_ASSERT_EQUAL(DayTime::PARSE_OUT_OF_RANGE, Latitude::ParseFromMeade("+91*00", lat));
+            Longitude lon;
+            TEST_ASSERT_EQUAL(DayTime::PARSE_OUT_OF_RANGE, Longitude::ParseFromMeade("361*00", lon));
+        }
+
+        void test_malformed_set_commands_are_refused()
+        {
+            simulation::boot();
+            MeadeCommandProcessor* processor = MeadeCommandProcessor::instance();
+
+            TEST_ASSERT_EQUAL_STRING("1", processor->processCommand(":Sr04:03:02").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", processor->processCommand(":Sr04:0x:02").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", processor->processCommand(":Sr24:00:00").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", processor->processCommand(":Sd+84*03:0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", processor->processCommand(":St+3a*29").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", processor->processCommand(":Sg097*3").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", processor->processCommand(":SL19:33:3").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", processor->processCommand(":SL24:00:00").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", processor->processCommand(":SL123:00:00").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", processor->processCommand(":SL-01:00:00").c_str());
+            TEST_ASSERT_EQUAL_STRING("1", processor->processCommand(":SL23:59:59").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", processor->processCommand(":SY+84*03:02.18:34:1x").c_str());
+
+            // Refused coordinates leave the target alone
+            TEST_ASSERT_EQUAL_STRING("04:03:02#", processor->processCommand(":Gr").c_str());
+        }
+
+        // Feeds random, mostly coordinate-like, input to the parser and the Set commands. Whatever
+        // the parser accepts has to survive formatting and parsing again unchanged.
+        void test_fuzz_parse_and_set_commands()
+        {
+            simulation::boot();
+            MeadeCommandProcessor* processor = MeadeCommandProcessor::instance();
+            const char alphabet[] = "0123456789:*'.+-#\xDF x";
+            const char* families[] = { ":Sr", ":Sd", ":St", ":Sg", ":SL", ":SY" };
+            std::mt19937 random(78);
+
+            char input[32];
+            char formatted[32];
+            int accepted = 0;
+            for (int i = 0; i < 50000; i++)
+            {
+                // Start from something shaped like a coordinate, then break it in a few places
+                const char* shapes[] = { "+00*00:00", "00:00:00", "00:00.0", "-00*00", "000*00", "+00*00:00.00:00:00" };
+                strcpy(input, shapes[random() % 6]);
+                int length = strlen(input);
+                for (int c = 0; c < length; c++)
+                {
+                    if ((input[c] == '0') && (c > 0))
+                    {
+                        input[c] = '0' + random() % 10;
+                    }
+                }
+                for (int mutations = random() % 3; mutations > 0; mutations--)
+                {
+                    int at = random() % (length + 1);
+                    switch (random() % 3)
+                    {
+                        case 0: input[at] = alphabet[random() % (sizeof(alphabet) - 1)]; break;   // Replace
+                        case 1: memmove(input + at, input + at + 1, length - at); length--; break; // Delete
+                        case 2: memmove(input + at + 1, input + at, length - at + 1); input[at] = alphabet[random() % (sizeof(alphabet) - 1)]; length++; break;
+                    }
+                    if (length < 0)
+                    {
+                        length = 0;
+                    }
+                    input[length] = '\0';
+                }
+
+                DayTime parsed;
+                if (DayTime::ParseFromMeade(input, parsed) == DayTime::PARSE_OK)
+                {
+                    accepted++;
+                    DayTime reparsed;
+                    parsed.formatString(formatted, "{d}:{m}:{s}");
+                    TEST_ASSERT_EQUAL(DayTime::PARSE_OK, DayTime::ParseFromMeade(formatted, reparsed));
+                    TEST_ASSERT_EQUAL(parsed.getTotalSeconds(), reparsed.getTotalSeconds());
+                }
+
+                String reply = processor->processCommand(String(families[i % 6]) + input);
+                TEST_ASSERT_TRUE((reply == "0") || (reply == "1"));
+            }
+            TEST_ASSERT_GREATER_THAN(5000, accepted);
+        }
+
+        void run() {
+            RUN_TEST(test_accepted_formats);
+            RUN_TEST(test_rejected_formats);
+            RUN_TEST(test_malformed_set_commands_are_refused);
+            RUN_TEST(test_fuzz_parse_and_set_commands);
+        }
+    }
+}
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <string.h>
+#include "unity.h"
+#include "simulation.h"
+#include "Parameters.hpp"
+
+// The parameter registry and its :XP commands
+namespace test {
+    namespace parameters {
+
+        using simulation::command;
+
+        // Sends an image in parts of whole parameters, each fitting a command
+        void restore(const String& image)
+        {
+            const char* hex = image.c_str();
+            while (*hex != '\0')
+            {
+                String part;
+                while ((*hex != '\0') && (part.length() < MEADE_COMMAND_BUFFER_SIZE - 14))
+                {
+                    Parameter parameter;
+                    char id[3] = { hex[0], hex[1], '\0' };
+                    TEST_ASSERT_TRUE(Parameters::find(strtol(id, nullptr, 16), parameter));
+                    int length = 2 + 2 * PARAMETER_TYPE_SIZE(parameter.type);
+                    part += image.substring(hex - image.c_str(), hex - image.c_str() + length);
+                    hex += length;
+                }
+                TEST_ASSERT_LESS_OR_EQUAL(MEADE_COMMAND_BUFFER_SIZE, part.length() + 4);
+                TEST_ASSERT_EQUAL_STRING("1#", command((":XPW" + part).c_str()).c_str());
+            }
+        }
+
+        void test_get_and_set_over_the_wire()
+        {
+            simulation::boot();
+            String backlash = command(":XGB");
+            String latitude = command(":XPG5");
+
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XPS4,42").c_str());
+            TEST_ASSERT_EQUAL_STRING("42#", command(":XPG4").c_str());
+            TEST_ASSERT_EQUAL_STRING("42#", command(":XGB").c_str());
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XPS4,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XPG4").c_str());
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XPS4,42").c_str());
+
+            // Out of range, read-only, unknown or not a number
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XPS4,-1").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XPS13,1.0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XPS99,1").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XPS4,many").c_str());
+            TEST_ASSERT_EQUAL_STRING("E#", command(":XPG99").c_str());
+            TEST_ASSERT_EQUAL_STRING("42#", command(":XPG4").c_str());
+
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XPS5,-33.5").c_str());
+            TEST_ASSERT_FLOAT_WITHIN(0.01f, -33.5f, simulation::mount.latitude().getTotalHours());
+
+            command((":XSB" + backlash.substring(0, backlash.length() - 1)).c_str());
+            command((":XPS5," + latitude.substring(0, latitude.length() - 1)).c_str());
+        }
+
+        void test_list_describes_every_parameter()
+        {
+            String list = command(":XPL");
+            TEST_ASSERT_EQUAL('#', list[list.length() - 1]);
+            int entries = 0;
+            for (unsigned int i = 0; i < list.length(); i++)
+            {
+                entries += (list[i] == ';') ? 1 : 0;
+            }
+            TEST_ASSERT_EQUAL(Parameters::count(), entries);
+            TEST_ASSERT_TRUE(list.indexOf("3,SpeedCalibration,F,P,") >= 0);
+            TEST_ASSERT_TRUE(list.indexOf("13,TrackingSpeed,F,R,") >= 0);
+        }
+
+        // An image read from the mount restores every setting, sent in command sized parts
+        void test_image_restores_the_configuration()
+        {
+            simulation::boot();
+            String image = command(":XPR");
+            TEST_ASSERT_EQUAL('#', image[image.length() - 1]);
+            image = image.substring(0, image.length() - 1);
+            float raSteps = simulation::mount.getStepsPerDegree(RA_STEPS);
+            long lowerLimit, upperLimit;
+            simulation::mount.getDecLimitPositions(lowerLimit, upperLimit);
+
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XPS1,123.5").c_str());
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XPS11,-70000").c_str());
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XPS4,7").c_str());
+
+            restore(image);
+
+            TEST_ASSERT_FLOAT_WITHIN(0.001f, raSteps, simulation::mount.getStepsPerDegree(RA_STEPS));
+            long restoredLower, restoredUpper;
+            simulation::mount.getDecLimitPositions(restoredLower, restoredUpper);
+            TEST_ASSERT_EQUAL(lowerLimit, restoredLower);
+            TEST_ASSERT_EQUAL(upperLimit, restoredUpper);
+            TEST_ASSERT_EQUAL_STRING((image + "#").c_str(), command(":XPR").c_str());
+
+            // A negative 32-bit value, and parts that are not whole parameters
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XPW0B90EEFEFF").c_str());
+            simulation::mount.getDecLimitPositions(restoredLower, restoredUpper);
+            TEST_ASSERT_EQUAL(-70000, restoredLower);
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XPW0B90EE").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XPW0DFFFFFFFF").c_str());
+            restore(image);
+        }
+
+        // Goes from home to DEC 60 within the given DEC limits and returns where DEC ended up
+        long gotoDec60(long lowerLimit, long upperLimit)
+        {
+            simulation::startFromHome();
+            simulation::mount.setDecLimitPositions(lowerLimit, upperLimit);
+            simulation::mount.targetRA() = simulation::mount.currentRA();
+            TEST_ASSERT_EQUAL_STRING("1", command(":Sd+60*00:00").c_str());
+            TEST_ASSERT_EQUAL_STRING("0", command(":MS").c_str());
+            for (int waited = 0; simulation::mount.isSlewingRAorDEC() && (waited < 60000); waited++)
+            {
+                simulation::run(10000);
+            }
+            TEST_ASSERT_FALSE(simulation::mount.isSlewingRAorDEC());
+            return simulation::mount.getCurrentStepperPosition(NORTH);
+        }
+
+        // A goto past a DEC limit stops at the limit, and does not report the target reached
+        void test_goto_stops_at_the_dec_limit()
+        {
+            long unlimited = gotoDec60(0, 0);
+            TEST_ASSERT_TRUE(simulation::mount.slewReachedTarget());
+
+            long limit = unlimited / 2;
+            TEST_ASSERT_EQUAL(limit, (unlimited > 0) ? gotoDec60(0, limit) : gotoDec60(limit, 0));
+            TEST_ASSERT_FALSE(simulation::mount.slewReachedTarget());
+            simulation::mount.setDecLimitPositions(0, 0);
+        }
+
+        void run() {
+            RUN_TEST(test_get_and_set_over_the_wire);
+            RUN_TEST(test_list_describes_every_parameter);
+            RUN_TEST(test_image_restores_the_configuration);
+            RUN_TEST(test_goto_stops_at_the_dec_limit);
+        }
+    }
+}
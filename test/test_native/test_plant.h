@@ -0,0 +1,136 @@
+#pragma once
+
+#include <math.h>
+#include <stdlib.h>
+#include "unity.h"
+#include "plant.h"
+#include "test_trajectory.h"
+
+// Runs the simulated mount against the mechanical model in plant.h. Set OAT_PLANT_CSV
+// to a path in the environment to get the pointing error of the last test over time.
+namespace test {
+    namespace plant_model {
+
+        struct Summary
+        {
+            float maxRAError;     // arcsec, over the whole run
+            float maxDECError;
+            float trackingRMS;    // arcsec of RA, from the given time on
+            float trackingPeakToPeak;
+        };
+
+        Summary summarize(const char* name, float trackingFrom)
+        {
+            Summary summary = { 0, 0, 0, 0 };
+            float low = 1e9f, high = -1e9f, sum = 0, sumOfSquares = 0;
+            int count = 0;
+            for (const plant::Sample& sample : plant::samples)
+            {
+                summary.maxRAError = max(summary.maxRAError, fabsf(sample.raErrorArcsec));
+                summary.maxDECError = max(summary.maxDECError, fabsf(sample.decErrorArcsec));
+                if (sample.seconds >= trackingFrom)
+                {
+                    low = min(low, sample.raErrorArcsec);
+                    high = max(high, sample.raErrorArcsec);
+                    sum += sample.raErrorArcsec;
+                    sumOfSquares += sample.raErrorArcsec * sample.raErrorArcsec;
+                    count++;
+                }
+            }
+            if (count > 0)
+            {
+                float mean = sum / count;
+                summary.trackingRMS = sqrtf(max(0.0f, sumOfSquares / count - mean * mean));
+                summary.trackingPeakToPeak = high - low;
+            }
+
+            char message[200];
+            const plant::Sample& last = plant::samples.back();
+            sprintf(message, "%s: max error RA %.0f\" DEC %.0f\", tracking RMS %.2f\" p-p %.2f\", lost steps RA %ld DEC %ld", name,
+                summary.maxRAError, summary.maxDECError, summary.trackingRMS, summary.trackingPeakToPeak, last.raLostSteps, last.decLostSteps);
+            TEST_MESSAGE(message);
+
+            const char* csv = getenv("OAT_PLANT_CSV");
+            if (csv != nullptr)
+            {
+                plant::writeSamples(csv);
+            }
+            return summary;
+        }
+
+        float secondsSinceAttached()
+        {
+            return (host::currentMicros() - plant::startedAt) / 1000000.0f;
+        }
+
+        // With the default model the motors keep up with the default speeds and accelerations,
+        // and the axes follow the steps to within the play in the belts.
+        void test_default_mount_keeps_its_steps()
+        {
+            simulation::startFromHome();
+            plant::attach(plant::defaultRAModel(), plant::defaultDECModel());
+            plant::raModel.periodicErrorArcsec = 0;
+
+            trajectory::slewTo(-2.0f, 40);
+            trajectory::runUntilTracking(600);
+            float trackingFrom = secondsSinceAttached() + 5;
+            trajectory::runFor(65);
+            plant::detach();
+
+            Summary summary = summarize("default_mount", trackingFrom);
+            const plant::Sample& last = plant::samples.back();
+            TEST_ASSERT_EQUAL(0, last.raLostSteps);
+            TEST_ASSERT_EQUAL(0, last.decLostSteps);
+            TEST_ASSERT_LESS_THAN(plant::raModel.backlash * 3600, summary.trackingPeakToPeak);
+        }
+
+        // A motor with a third of the torque stalls when the slew speeds up, and the mount
+        // ends up pointing somewhere else than the firmware thinks.
+        void test_weak_motor_loses_steps()
+        {
+            simulation::startFromHome();
+            plant::AxisModel ra = plant::defaultRAModel();
+            ra.holdingAcceleration /= 3;
+            plant::attach(ra, plant::defaultDECModel());
+
+            trajectory::slewTo(-3.0f, 90);
+            trajectory::runUntilTracking(600);
+            trajectory::runFor(2);
+            plant::detach();
+
+            summarize("weak_ra_motor", 1e9f);
+            const plant::Sample& last = plant::samples.back();
+            TEST_ASSERT_NOT_EQUAL(0, last.raLostSteps);
+            TEST_ASSERT_EQUAL(0, last.decLostSteps);
+            float play = plant::raModel.backlash * 3600.0f + plant::raModel.periodicErrorArcsec;
+            TEST_ASSERT_FLOAT_WITHIN(play, last.raLostSteps / plant::raModel.stepsPerDegree * 3600.0f, -last.raErrorArcsec);
+        }
+
+        // While tracking, the error is the periodic error of the pulley, plus the step the axis
+        // is waiting for next
+        void test_periodic_error_while_tracking()
+        {
+            simulation::startFromHome();
+            plant::AxisModel ra = plant::defaultRAModel();
+            ra.periodicErrorArcsec = 10.0f;
+            ra.periodicErrorPeriod = 0.25f; // A minute of tracking, to keep the test short
+            plant::attach(ra, plant::defaultDECModel());
+
+            trajectory::runFor(5);
+            float trackingFrom = secondsSinceAttached();
+            trajectory::runFor(60);
+            plant::detach();
+
+            Summary summary = summarize("periodic_error", trackingFrom);
+            float step = 3600.0f / plant::raModel.stepsPerDegree * RA_SLEW_MICROSTEPPING / RA_TRACKING_MICROSTEPPING;
+            TEST_ASSERT_FLOAT_WITHIN(step, 20.0f + step / 2, summary.trackingPeakToPeak);
+            TEST_ASSERT_FLOAT_WITHIN(1.5f, 10.0f / sqrtf(2.0f), summary.trackingRMS);
+        }
+
+        void run() {
+            RUN_TEST(test_default_mount_keeps_its_steps);
+            RUN_TEST(test_weak_motor_loses_steps);
+            RUN_TEST(test_periodic_error_while_tracking);
+        }
+    }
+}
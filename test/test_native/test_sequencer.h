@@ -0,0 +1,176 @@
+#pragma once
+
+#include "unity.h"
+#include "simulation.h"
+
+// Sequences of targets that the mount runs by itself
+namespace test {
+    namespace sequencer {
+
+        using simulation::command;
+
+        // Sets the target to the given hour angle (seconds) from the meridian, at DEC +80
+        void setTarget(long hourAngle)
+        {
+            TEST_ASSERT_EQUAL_STRING("1", simulation::setTargetHourAngle(hourAngle).c_str());
+            TEST_ASSERT_EQUAL_STRING("1", command(":Sd+80*00:00").c_str());
+        }
+
+        // Runs the mount until the sequence is in the state, at most the given seconds. Returns the seconds it took.
+        float runUntil(Sequencer::State state, float maxSeconds)
+        {
+            float seconds = 0;
+            while ((simulation::mount.sequencer().state() != state) && (seconds < maxSeconds))
+            {
+                simulation::run(50000);
+                seconds += 0.05f;
+            }
+            TEST_ASSERT_EQUAL_INT(state, simulation::mount.sequencer().state());
+            return seconds;
+        }
+
+        void test_commands_are_checked()
+        {
+            simulation::startFromHome();
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XQC").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQS").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAN0,10,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAZ0,10,0,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAA30,10x,0,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAT246000,10,0,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAT226100,10,0,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAT223060,10,0,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAA91,10,0,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAM-721,10,0,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAN0,-10,0,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAN0,10,65536,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAN0,10,0,-1").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQEX").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQE").c_str());
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XQET").c_str());
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XQEP").c_str());
+            TEST_ASSERT_EQUAL_STRING("I,1,0,0#", command(":XQG").c_str());
+            for (int i = 0; i < SEQUENCE_MAX_TARGETS; i++)
+            {
+                TEST_ASSERT_EQUAL_STRING("1#", command(":XQAT223000,10,0,0").c_str());
+            }
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAN0,10,0,0").c_str());
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XQC").c_str());
+            TEST_ASSERT_EQUAL_STRING("I,1,0,0#", command(":XQG").c_str());
+        }
+
+        // Two targets, the second waiting for the meridian, then park. No client is needed once it runs.
+        void test_runs_targets_and_parks()
+        {
+            simulation::startFromHome();
+            command(":XQC");
+            setTarget(3600);
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XQAN0,20,5,20").c_str());
+            setTarget(-600);
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XQAM-8,10,0,0").c_str());
+            DayTime secondRA = simulation::mount.targetRA();
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XQEP").c_str());
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XQS").c_str());
+            TEST_ASSERT_EQUAL_STRING("0#", command(":XQAN0,20,5,20").c_str());
+
+            runUntil(Sequencer::SLEWING, 2.0f);
+            runUntil(Sequencer::ON_TARGET, 120.0f);
+            TEST_ASSERT_FALSE(simulation::mount.isSlewingRAorDEC());
+            TEST_ASSERT_TRUE(simulation::mount.isSlewingTRK());
+            TEST_ASSERT_EQUAL_STRING("T,1,2,20#", command(":XQG").c_str());
+
+            // A dither every 5 seconds
+            float sinceGuide = 0;
+            while (!simulation::mount.isGuiding() && (sinceGuide < 6.0f))
+            {
+                simulation::run(50000);
+                sinceGuide += 0.05f;
+            }
+            TEST_ASSERT_TRUE(simulation::mount.isGuiding());
+            TEST_ASSERT_FLOAT_WITHIN(0.1f, 5.0f, sinceGuide);
+
+            // The second target waits until it is 8 minutes from the meridian
+            runUntil(Sequencer::WAITING, 20.0f);
+            TEST_ASSERT_EQUAL(2, simulation::mount.sequencer().currentTarget() + 1);
+            TEST_ASSERT_LESS_THAN(-480L, simulation::mount.hourAngleOf(secondRA));
+            runUntil(Sequencer::SLEWING, 240.0f);
+            TEST_ASSERT_INT_WITHIN(2, -480L, simulation::mount.hourAngleOf(secondRA));
+
+            runUntil(Sequencer::ON_TARGET, 120.0f);
+            runUntil(Sequencer::DONE, 11.0f);
+            TEST_ASSERT_TRUE(simulation::mount.isParking());
+            float parking = 0;
+            while (!simulation::mount.isParked() && (parking < 120.0f))
+            {
+                simulation::run(100000);
+                parking += 0.1f;
+            }
+            TEST_ASSERT_TRUE(simulation::mount.isParked());
+            TEST_ASSERT_EQUAL_INT('D', command(":XQG")[0]);
+        }
+
+        // Parking the mount (or stopping it) ends the sequence
+        void test_parking_stops_it()
+        {
+            simulation::startFromHome();
+            command(":XQC");
+            setTarget(0);
+            command(":XQAA89,20,0,0");
+            command(":XQS");
+            simulation::run(2000000);
+            TEST_ASSERT_EQUAL_INT(Sequencer::WAITING, simulation::mount.sequencer().state());
+            command(":hP");
+            simulation::run(100000);
+            TEST_ASSERT_EQUAL_INT(Sequencer::IDLE, simulation::mount.sequencer().state());
+            command(":XQC");
+            for (int i = 0; (i < 1200) && !simulation::mount.isParked(); i++)
+            {
+                simulation::run(100000);
+            }
+        }
+
+        // A slew that is stopped or taken over by a manual move does not count as getting to the target.
+        // The mount keeps tracking, so it is not taken for parked.
+        void test_stopped_slew_stops_it()
+        {
+            const char* interruptions[] = { ":Qa", ":Mn" };
+            for (const char* interruption : interruptions)
+            {
+                simulation::startFromHome();
+                command(":XQC");
+                setTarget(3600);
+                command(":XQAN0,20,0,0");
+                command(":XQS");
+                runUntil(Sequencer::SLEWING, 2.0f);
+                simulation::run(1000000);
+                command(interruption);
+                simulation::run(500000);
+                command(":Qa");
+                for (int i = 0; (i < 1200) && simulation::mount.isSlewingRAorDEC(); i++)
+                {
+                    simulation::run(100000);
+                }
+                simulation::run(100000);
+                TEST_ASSERT_FALSE(simulation::mount.slewReachedTarget());
+                TEST_ASSERT_EQUAL_INT(Sequencer::IDLE, simulation::mount.sequencer().state());
+            }
+
+            // Running to its end, it does
+            simulation::startFromHome();
+            setTarget(3600);
+            command(":MS");
+            for (int i = 0; (i < 1200) && simulation::mount.isSlewingRAorDEC(); i++)
+            {
+                simulation::run(100000);
+            }
+            TEST_ASSERT_TRUE(simulation::mount.slewReachedTarget());
+        }
+
+        void run() {
+            RUN_TEST(test_commands_are_checked);
+            RUN_TEST(test_runs_targets_and_parks);
+            RUN_TEST(test_parking_stops_it);
+            RUN_TEST(test_stopped_slew_stops_it);
+        }
+    }
+}
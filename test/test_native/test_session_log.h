@@ -0,0 +1,225 @@
+#pragma once
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <vector>
+#include "unity.h"
+#include "simulation.h"
+
+// The session log, downloaded with :XR commands in chunks and decoded like session_log.py does
+namespace test {
+    namespace session_log {
+
+        using simulation::command;
+
+        struct Decoded
+        {
+            unsigned long start, end;
+            unsigned long tick;
+            long ra, dec, trk;
+            int status;
+            unsigned long rate, rateTick;
+            int guidePulses, dithers, slews, statusChanges;
+            byte lastGuideDirection;
+            unsigned long lastGuideMs;
+            long slewRA, slewDEC;
+        };
+
+        unsigned long readValue(const std::vector<byte>& bytes, size_t& i)
+        {
+            unsigned long value = 0;
+            int shift = 0;
+            byte b;
+            do
+            {
+                TEST_ASSERT_TRUE(i < bytes.size());
+                b = bytes[i++];
+                value |= (unsigned long)(b & 0x7F) << shift;
+                shift += 7;
+            } while (b & 0x80);
+            return value;
+        }
+
+        long readSignedValue(const std::vector<byte>& bytes, size_t& i)
+        {
+            unsigned long value = readValue(bytes, i);
+            return (long)(value >> 1) ^ -(long)(value & 1);
+        }
+
+        // The TRK steps the tracking rate moves in the given ticks
+        long predictedSteps(unsigned long rate, unsigned long ticks)
+        {
+            return (rate * std::min(ticks, SESSION_LOG_PREDICT_TICKS) + 50000) / 100000;
+        }
+
+        Decoded download()
+        {
+            Decoded log = {};
+            int recording;
+            TEST_ASSERT_EQUAL(10, sscanf(command(":XRI").c_str(), "%d,%lu,%lu,%lu,%ld,%ld,%ld,%d,%lu,%lu#", &recording, &log.start, &log.end,
+                &log.tick, &log.ra, &log.dec, &log.trk, &log.status, &log.rate, &log.rateTick));
+
+            std::vector<byte> bytes;
+            unsigned long offset = log.start;
+            while (offset < log.end)
+            {
+                char cmd[32];
+                snprintf(cmd, sizeof(cmd), ":XRG%lu", offset);
+                String reply = command(cmd);
+                const char* hex = strchr(reply.c_str(), ',') + 1;
+                TEST_ASSERT_EQUAL(offset, strtoul(reply.c_str(), nullptr, 10));
+                int count = 0;
+                while (hex[0] != '#')
+                {
+                    char digits[3] = { hex[0], hex[1], 0 };
+                    bytes.push_back((byte)strtoul(digits, nullptr, 16));
+                    hex += 2;
+                    count++;
+                }
+                TEST_ASSERT_TRUE(count > 0);
+                TEST_ASSERT_TRUE(count <= 32);
+                offset += count;
+            }
+
+            size_t i = 0;
+            while (i < bytes.size())
+            {
+                char type = bytes[i++];
+                log.tick += readValue(bytes, i);
+                if ((type == 'S') || (type == 'R'))
+                {
+                    log.trk += predictedSteps(log.rate, log.tick - log.rateTick);
+                    log.rateTick = log.tick;
+                }
+                switch (type)
+                {
+                case 'S':
+                    log.ra += readSignedValue(bytes, i);
+                    log.dec += readSignedValue(bytes, i);
+                    log.trk += readSignedValue(bytes, i);
+                    break;
+                case 'R':
+                    log.rate = readValue(bytes, i);
+                    break;
+                case 'G':
+                    log.lastGuideDirection = readValue(bytes, i);
+                    log.lastGuideMs = readValue(bytes, i);
+                    if (log.lastGuideDirection & SESSION_LOG_DITHER)
+                    {
+                        log.dithers++;
+                    }
+                    else
+                    {
+                        log.guidePulses++;
+                    }
+                    break;
+                case 'M':
+                    log.slewRA = readSignedValue(bytes, i);
+                    log.slewDEC = readSignedValue(bytes, i);
+                    log.slews++;
+                    break;
+                case 'T':
+                    log.status = readValue(bytes, i);
+                    log.statusChanges++;
+                    break;
+                default:
+                    TEST_FAIL_MESSAGE("Unknown record type");
+                }
+            }
+            return log;
+        }
+
+        // RA and DEC are sampled at most SESSION_LOG_INTERVAL ago, so they must be still. TRK is predicted from the tracking rate up to now.
+        void assertAtMount(const Decoded& log)
+        {
+            TEST_ASSERT_EQUAL(simulation::mount.getCurrentStepperPosition(EAST), log.ra);
+            TEST_ASSERT_EQUAL(simulation::mount.getCurrentStepperPosition(NORTH), log.dec);
+            unsigned long now = millis() / SESSION_LOG_TICK;
+            float trkPerSample = simulation::mount.getSpeed(TRACKING) * SESSION_LOG_INTERVAL / 1000.0f;
+            TEST_ASSERT_INT_WITHIN(trkPerSample + 1, simulation::mount.getCurrentStepperPosition(TRACKING),
+                log.trk + predictedSteps(log.rate, now - log.rateTick));
+            TEST_ASSERT_TRUE(log.tick <= now);
+        }
+
+        void test_records_guiding_and_slews()
+        {
+            simulation::startFromHome();
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XRC").c_str());
+            simulation::run(1000000);
+            command(":MGw0500");
+            simulation::run(2000000);
+            command(":Sd+45*00:00");
+            TEST_ASSERT_EQUAL_STRING("0", command(":MS").c_str());
+            simulation::run(1500000);
+
+            Decoded log = download();
+            TEST_ASSERT_EQUAL(0, log.start);
+            TEST_ASSERT_EQUAL(1, log.guidePulses);
+            TEST_ASSERT_EQUAL(WEST, log.lastGuideDirection);
+            TEST_ASSERT_EQUAL(500, log.lastGuideMs);
+            TEST_ASSERT_EQUAL(1, log.slews);
+            TEST_ASSERT_TRUE(log.statusChanges >= 1);
+            TEST_ASSERT_TRUE(log.status & 0x2);   // Slewing
+            long slewDEC = log.slewDEC;
+
+            // Slews make the largest samples, a long one can fill a small ring
+            for (int i = 0; (i < 1200) && simulation::mount.isSlewingRAorDEC(); i++)
+            {
+                simulation::run(100000);
+            }
+            simulation::run(10000000);
+            log = download();
+            TEST_ASSERT_FALSE(log.status & 0x2);
+            TEST_ASSERT_EQUAL(simulation::mount.getCurrentStepperPosition(NORTH), slewDEC);
+            assertAtMount(log);
+
+            // Steady tracking takes about one sample a minute
+            TEST_ASSERT_EQUAL((unsigned long)(simulation::mount.getSpeed(TRACKING) * 1000.0f + 0.5f), log.rate);
+            unsigned long end = log.end;
+            simulation::run(300000000);
+            log = download();
+            TEST_ASSERT_TRUE(log.end - end <= 6 * 8);
+            assertAtMount(log);
+
+            // Its steps still add up once tracking stops
+            simulation::mount.stopSlewing(TRACKING);
+            simulation::run(1500000);
+            log = download();
+            TEST_ASSERT_EQUAL(0, log.rate);
+            TEST_ASSERT_INT_WITHIN(1, simulation::mount.getCurrentStepperPosition(TRACKING), log.trk);
+            simulation::mount.startSlewing(TRACKING);
+        }
+
+        // Once the ring is full the oldest records make room, and the log still decodes to where the mount is
+        void test_full_log_drops_the_oldest()
+        {
+            simulation::startFromHome();
+            command(":XRC");
+            for (int second = 0; second < SESSION_LOG_SIZE; second += 10)
+            {
+                command((second % 20 == 0) ? ":MGn0300" : ":MGs0300");
+                simulation::run(10000000);
+            }
+            Decoded log = download();
+            TEST_ASSERT_TRUE(log.start > 0);
+            TEST_ASSERT_TRUE(log.end - log.start <= SESSION_LOG_SIZE);
+            TEST_ASSERT_TRUE(log.end - log.start > SESSION_LOG_SIZE - 24);
+            assertAtMount(log);
+
+            // Paused, it keeps what it has
+            TEST_ASSERT_EQUAL_STRING("1#", command(":XRS0").c_str());
+            simulation::run(20000000);
+            TEST_ASSERT_EQUAL_STRING("0", command(":XRI").substring(0, 1).c_str());
+            TEST_ASSERT_EQUAL(log.end, download().end);
+            command(":XRS1");
+            simulation::run(2000000);
+            assertAtMount(download());
+        }
+
+        void run() {
+            RUN_TEST(test_records_guiding_and_slews);
+            RUN_TEST(test_full_log_drops_the_oldest);
+        }
+    }
+}
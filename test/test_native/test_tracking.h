@@ -0,0 +1,144 @@
+#pragma once
+
+#include <math.h>
+#include <stdlib.h>
+#include <vector>
+#include "unity.h"
+#include "simulation.h"
+#include "tracking_analysis.h"
+#include "StepRates.hpp"
+#include "TrackingTimer.hpp"
+
+// Benchmarks the TRK steps the stepper interrupt makes while tracking. Set OAT_TRACKING_LOG
+// to a file of step times (one microsecond count per line, e.g. logged on a mount) to have
+// it analyzed alongside the simulation.
+namespace test {
+    namespace tracking {
+
+        std::vector<unsigned long long> trackingSteps;
+        long lastTrackingPosition = 0;
+
+        void recordTrackingStep(unsigned long long interruptMicros)
+        {
+            long position = simulation::mount.getCurrentStepperPosition(TRACKING);
+            if (position != lastTrackingPosition)
+            {
+                trackingSteps.push_back(interruptMicros);
+                lastTrackingPosition = position;
+            }
+        }
+
+        float arcsecPerTrackingStep()
+        {
+            return 3600.0f / simulation::mount.getStepsPerDegree(RA_STEPS) * RA_SLEW_MICROSTEPPING / RA_TRACKING_MICROSTEPPING;
+        }
+
+        void report(const char* name, const tracking_analysis::Report& report)
+        {
+            char message[600];
+            FILE* file = fmemopen(message, sizeof(message), "w");
+            tracking_analysis::print(file, name, report);
+            fclose(file);
+            TEST_MESSAGE(message);
+        }
+
+        // Steps with a known periodic timing error come out of the analyzer as that error
+        void test_analyzer_finds_periodic_error()
+        {
+            const float rate = 4.0f;           // steps/s
+            const float arcsecPerStep = 4.0f;  // so 16"/s
+            const float periodSeconds = 40.0f;
+            std::vector<unsigned long long> steps;
+            for (int i = 0; i < 4000; i++)
+            {
+                // 0.25s late at the peak is a step of 4"
+                float late = 0.25f * sinf(2.0f * (float)M_PI * (i / rate) / periodSeconds);
+                steps.push_back(1000000ULL + (unsigned long long)((i / rate + late) * 1000000.0f));
+            }
+
+            tracking_analysis::Report result = tracking_analysis::analyze(steps, rate, arcsecPerStep);
+            report("synthetic", result);
+            TEST_ASSERT_FLOAT_WITHIN(50.0f, 0.0f, result.rateErrorPPM);
+            TEST_ASSERT_FLOAT_WITHIN(0.01f, periodSeconds, result.peaks[0].periodSeconds);
+            TEST_ASSERT_FLOAT_WITHIN(0.05f, 4.0f, result.peaks[0].amplitudeArcsec);
+            TEST_ASSERT_FLOAT_WITHIN(0.05f, 4.0f / sqrtf(2.0f), result.residualRMS);
+            TEST_ASSERT_LESS_THAN(result.peaks[0].amplitudeArcsec * 100, result.peaks[1].amplitudeArcsec * 1000); // Under a tenth
+        }
+
+        // Twenty minutes of tracking from home. Each step waits for the next interrupt, which
+        // comes every STEPPER_INTERRUPT_MAX_PERIOD while tracking, but the axis times the
+        // following step from when this one was due. Steps are late by up to a period, and
+        // the rate holds.
+        void test_simulated_tracking()
+        {
+            simulation::startFromHome();
+            trackingSteps.clear();
+            lastTrackingPosition = simulation::mount.getCurrentStepperPosition(TRACKING);
+            simulation::interruptObserver = recordTrackingStep;
+            simulation::run(20ULL * 60ULL * 1000000ULL);
+            simulation::interruptObserver = nullptr;
+
+            tracking_analysis::Report result = tracking_analysis::analyze(trackingSteps, simulation::mount.getSpeed(TRACKING), arcsecPerTrackingStep());
+            report("simulated", result);
+            TEST_ASSERT_GREATER_THAN(1000, result.steps);
+            TEST_ASSERT_FLOAT_WITHIN(500.0f * result.commandedRate, 0.0f, result.rateErrorPPM); // Less than a whole interrupt period per step
+            TEST_ASSERT_LESS_THAN(arcsecPerTrackingStep() * 1000, result.residualPeak * 1000);
+
+            const char* log = getenv("OAT_TRACKING_LOG");
+            if (log != nullptr)
+            {
+                std::vector<unsigned long long> logged;
+                TEST_ASSERT_TRUE_MESSAGE(tracking_analysis::readSteps(log, logged), log);
+                report("logged", tracking_analysis::analyze(logged, result.commandedRate, arcsecPerTrackingStep()));
+            }
+        }
+
+        // The rates RA_HARDWARE_TRACKING runs the timer at, from the half periods it alternates between
+        void test_hardware_timer_rates()
+        {
+            const unsigned int prescalers[] = { 0, 1, 8, 64, 256, 1024 };
+            const float rates[] = { 0.5f, 3.36f, 15.0f, 80.2f, 400.0f, 3500.0f, 20000.0f };
+            for (float rate : rates)
+            {
+                byte clockSelect;
+                unsigned long halfPeriod;
+                TEST_ASSERT_TRUE(TrackingTimer::timing(rate, clockSelect, halfPeriod));
+                TEST_ASSERT_LESS_THAN(65536UL * 256UL, halfPeriod);
+                if (clockSelect > 1)
+                {
+                    // The smallest prescaler that fits, for the finest steps
+                    TEST_ASSERT_GREATER_OR_EQUAL(65536UL * 256UL, halfPeriod * prescalers[clockSelect] / prescalers[clockSelect - 1]);
+                }
+                double actual = 16000000.0 * 128.0 / ((double)prescalers[clockSelect] * halfPeriod);
+                TEST_ASSERT_FLOAT_WITHIN(rate * 1e-6, rate, actual);
+            }
+
+            byte clockSelect;
+            unsigned long halfPeriod;
+            TEST_ASSERT_FALSE(TrackingTimer::timing(0.0f, clockSelect, halfPeriod));
+            TEST_ASSERT_FALSE(TrackingTimer::timing(0.05f, clockSelect, halfPeriod));
+            TEST_ASSERT_FALSE(TrackingTimer::timing(60000.0f, clockSelect, halfPeriod));
+        }
+
+        // The build checks the rates in StepRates.hpp, so they have to be the ones the mount runs at
+        void test_compile_time_rates_match_mount()
+        {
+            float tracking = simulation::mount.getSpeed(TRACKING) / simulation::mount.getSpeedCalibration();
+            TEST_ASSERT_FLOAT_WITHIN(StepRates::raTracking * 1e-5f, StepRates::raTracking, tracking);
+            TEST_ASSERT_GREATER_THAN(StepRates::raTracking, StepRates::raGuiding);
+
+            // Halving the rate doubles the microstepping that fits, up to 256
+            TEST_ASSERT_EQUAL(256, StepRates::highestMicrostepping(1.0f));
+            TEST_ASSERT_EQUAL(128, StepRates::highestMicrostepping(STEPPER_MAX_STEP_RATE / 128.0f));
+            TEST_ASSERT_EQUAL(64, StepRates::highestMicrostepping(STEPPER_MAX_STEP_RATE / 100.0f));
+            TEST_ASSERT_EQUAL(1, StepRates::highestMicrostepping(STEPPER_MAX_STEP_RATE * 2.0f));
+        }
+
+        void run() {
+            RUN_TEST(test_analyzer_finds_periodic_error);
+            RUN_TEST(test_simulated_tracking);
+            RUN_TEST(test_hardware_timer_rates);
+            RUN_TEST(test_compile_time_rates_match_mount);
+        }
+    }
+}
@@ -0,0 +1,366 @@
+#pragma once
+
+#include <chrono>
+#include <stdio.h>
+#include <stdlib.h>
+#include <vector>
+#include "unity.h"
+#include "simulation.h"
+#include "MeadeCommandProcessor.hpp"
+
+// Golden trajectories are read from this directory, relative to the project root the
+// tests run in. Run the tests with OAT_WRITE_GOLDEN=1 in the environment to write
+// them instead, after a change that is meant to move the motors differently.
+#define TRAJECTORY_GOLDEN_DIR "test/test_native/golden/"
+
+// How far a step may move in time and still be the same step. Changes to how often
+// the steppers are serviced shift steps by up to an interrupt period.
+#define TRAJECTORY_TOLERANCE_MICROS 1000
+
+namespace test {
+    namespace trajectory {
+
+        // A position an axis moved to, and when
+        struct Sample
+        {
+            unsigned long long micros; // Since the start of the scenario
+            long position;
+        };
+
+        const char axisNames[] = { 'R', 'D', 'T' };
+        const int axisDirections[] = { EAST, NORTH, TRACKING };
+
+        std::vector<Sample> recorded[3];
+        long lastPosition[3];
+        unsigned long long recordingStartedAt = 0;
+
+        void recordSteps(unsigned long long interruptMicros)
+        {
+            for (int axis = 0; axis < 3; axis++)
+            {
+                long position = simulation::mount.getCurrentStepperPosition(axisDirections[axis]);
+                if (position != lastPosition[axis])
+                {
+                    recorded[axis].push_back({ interruptMicros - recordingStartedAt, position });
+                    lastPosition[axis] = position;
+                }
+            }
+        }
+
+        using simulation::command;
+
+        // Sends a goto to the given offset from the LST, in hours
+        void slewTo(float hoursFromLST, int decDegrees)
+        {
+            char buffer[24];
+            DayTime ra = simulation::mount.LST();
+            ra.addHours(hoursFromLST);
+            String cmd = String(":Sr") + ra.formatMeadeString(buffer, true);
+            TEST_ASSERT_EQUAL_STRING("1", command(cmd.substring(0, cmd.length() - 1).c_str()).c_str());
+            sprintf(buffer, ":Sd%+03d*00:00", decDegrees);
+            TEST_ASSERT_EQUAL_STRING("1", command(buffer).c_str());
+            TEST_ASSERT_EQUAL_STRING("0", command(":MS").c_str());
+        }
+
+        void runFor(float seconds)
+        {
+            simulation::run((unsigned long long)(seconds * 1000000.0f));
+        }
+
+        // Runs until the mount is tracking again after a slew
+        void runUntilTracking(float maxSeconds)
+        {
+            for (float waited = 0; waited < maxSeconds; waited += 0.01f)
+            {
+                if (!simulation::mount.isSlewingRAorDEC() && simulation::mount.isSlewingTRK())
+                {
+                    return;
+                }
+                runFor(0.01f);
+            }
+            TEST_FAIL_MESSAGE("The slew did not finish");
+        }
+
+        // Starts recording the steps of a scenario from home
+        void startScenario()
+        {
+            // Steps are timed from the last one, so a motor that stopped only just now would
+            // start in step with whatever the tests before it did
+            simulation::mount.stopSlewing(ALL_DIRECTIONS | TRACKING);
+            simulation::mount.waitUntilStopped(ALL_DIRECTIONS);
+            simulation::run(2000000);
+            simulation::startFromHome();
+            Mount& mount = simulation::mount;
+
+            recordingStartedAt = host::currentMicros();
+            for (int axis = 0; axis < 3; axis++)
+            {
+                recorded[axis].clear();
+                lastPosition[axis] = mount.getCurrentStepperPosition(axisDirections[axis]);
+            }
+            simulation::interruptObserver = recordSteps;
+        }
+
+        // Writes runs of evenly spaced single steps as one line each:
+        //   axis  first-step-micros  first-position  steps  interval-micros  step
+        void writeGolden(FILE* file)
+        {
+            fprintf(file, "# axis first-step-micros first-position steps interval-micros step\n");
+            for (int axis = 0; axis < 3; axis++)
+            {
+                std::vector<Sample>& samples = recorded[axis];
+                for (size_t start = 0; start < samples.size();)
+                {
+                    size_t end = start + 1;
+                    unsigned long long interval = 0;
+                    long step = 0;
+                    if (end < samples.size())
+                    {
+                        interval = samples[end].micros - samples[start].micros;
+                        step = samples[end].position - samples[start].position;
+                    }
+                    while ((end < samples.size()) && (abs(step) == 1)
+                        && (samples[end].micros - samples[end - 1].micros == interval)
+                        && (samples[end].position - samples[end - 1].position == step))
+                    {
+                        end++;
+                    }
+                    if ((end == start + 1) || (abs(step) != 1))
+                    {
+                        end = start + 1;
+                        interval = 0;
+                        step = 0;
+                    }
+                    fprintf(file, "%c %llu %ld %d %llu %ld\n", axisNames[axis], samples[start].micros, samples[start].position, (int)(end - start), interval, step);
+                    start = end;
+                }
+            }
+        }
+
+        bool readGolden(FILE* file, std::vector<Sample> golden[3])
+        {
+            char line[120];
+            while (fgets(line, sizeof(line), file) != nullptr)
+            {
+                char name;
+                unsigned long long micros, interval;
+                long position, step;
+                int count;
+                if (line[0] == '#')
+                {
+                    continue;
+                }
+                if (sscanf(line, "%c %llu %ld %d %llu %ld", &name, &micros, &position, &count, &interval, &step) != 6)
+                {
+                    return false;
+                }
+                int axis = (name == 'R') ? 0 : ((name == 'D') ? 1 : 2);
+                for (int i = 0; i < count; i++)
+                {
+                    golden[axis].push_back({ micros + i * interval, position + i * step });
+                }
+            }
+            return true;
+        }
+
+        void compareWithGolden(const char* scenario, long long hostMicros)
+        {
+            simulation::interruptObserver = nullptr;
+
+            char message[160];
+            unsigned long long lastSlewStep = 0;
+            for (int axis = 0; axis < 2; axis++)
+            {
+                if (!recorded[axis].empty())
+                {
+                    lastSlewStep = max(lastSlewStep, recorded[axis].back().micros);
+                }
+            }
+            sprintf(message, "%s: %d RA, %d DEC and %d TRK steps, last slew step at %.3f s, simulated in %lld ms", scenario,
+                (int)recorded[0].size(), (int)recorded[1].size(), (int)recorded[2].size(), lastSlewStep / 1000000.0, hostMicros / 1000);
+            TEST_MESSAGE(message);
+
+            String path = String(TRAJECTORY_GOLDEN_DIR) + scenario + ".txt";
+            if (getenv("OAT_WRITE_GOLDEN") != nullptr)
+            {
+                FILE* file = fopen(path.c_str(), "w");
+                TEST_ASSERT_NOT_NULL_MESSAGE(file, path.c_str());
+                fprintf(file, "# Golden trajectory of the %s scenario in test_trajectory.h\n", scenario);
+                writeGolden(file);
+                fclose(file);
+                return;
+            }
+
+            FILE* file = fopen(path.c_str(), "r");
+            TEST_ASSERT_NOT_NULL_MESSAGE(file, path.c_str());
+            std::vector<Sample> golden[3];
+            bool readable = readGolden(file, golden);
+            fclose(file);
+            TEST_ASSERT_TRUE_MESSAGE(readable, path.c_str());
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                for (size_t i = 0; i < min(golden[axis].size(), recorded[axis].size()); i++)
+                {
+                    const Sample& expected = golden[axis][i];
+                    const Sample& actual = recorded[axis][i];
+                    long long drift = (long long)actual.micros - (long long)expected.micros;
+                    if ((actual.position != expected.position) || (llabs(drift) > TRAJECTORY_TOLERANCE_MICROS))
+                    {
+                        sprintf(message, "%c step %d: expected position %ld at %llu us, got %ld at %llu us", axisNames[axis], (int)i,
+                            expected.position, expected.micros, actual.position, actual.micros);
+                        TEST_FAIL_MESSAGE(message);
+                    }
+                }
+                sprintf(message, "%c axis step count", axisNames[axis]);
+                TEST_ASSERT_EQUAL_MESSAGE(golden[axis].size(), recorded[axis].size(), message);
+            }
+        }
+
+        typedef std::chrono::steady_clock clock;
+
+        long long hostMicrosSince(clock::time_point start)
+        {
+            return std::chrono::duration_cast<std::chrono::microseconds>(clock::now() - start).count();
+        }
+
+        // A goto to the east, then one that passes 6 hours to the west and flips both axes.
+        // Covers the backlash correction at the end of each slew.
+        void test_goto_across_meridian()
+        {
+            startScenario();
+            clock::time_point start = clock::now();
+
+            slewTo(-2.0f, 30);
+            runUntilTracking(600);
+            runFor(2);
+            slewTo(7.0f, 60);
+            runUntilTracking(600);
+            runFor(2);
+
+            compareWithGolden("goto_across_meridian", hostMicrosSince(start));
+        }
+
+        // Parks after tracking for a while, so the tracked time goes into the way home.
+        void test_park_from_tracking()
+        {
+            startScenario();
+            clock::time_point start = clock::now();
+
+            slewTo(2.0f, 45);
+            runUntilTracking(600);
+            runFor(20);
+            command(":hP");
+            for (int waited = 0; !simulation::mount.isParked() && (waited < 60000); waited++)
+            {
+                runFor(0.01f);
+            }
+            TEST_ASSERT_TRUE(simulation::mount.isParked());
+            runFor(2);
+
+            compareWithGolden("park_from_tracking", hostMicrosSince(start));
+        }
+
+        // Goes home after guide pulses on both axes, then tracks from home.
+        void test_home_after_guiding()
+        {
+            startScenario();
+            clock::time_point start = clock::now();
+
+            slewTo(-1.0f, 70);
+            runUntilTracking(600);
+            const char* pulses[] = { ":Mgn0500", ":Mge0800", ":Mgs0300", ":Mgw0400" };
+            for (const char* pulse : pulses)
+            {
+                TEST_ASSERT_EQUAL_STRING("1", command(pulse).c_str());
+                runFor(1);
+            }
+            command(":hF");
+            runUntilTracking(600);
+            runFor(2);
+
+            compareWithGolden("home_after_guiding", hostMicrosSince(start));
+        }
+
+        // Tracks, slews, guides and parks, noting the interrupt period in each phase. Returns
+        // where each axis ended up and the TRK steps made on the way.
+        void runThroughTransitions(unsigned long periods[4], long positions[3], long& trackingSteps)
+        {
+            startScenario();
+            long previous = lastPosition[2];
+            runFor(5);
+            periods[0] = simulation::interruptPeriod;
+
+            slewTo(-1.0f, 70);
+            runFor(1);
+            periods[1] = simulation::interruptPeriod;
+            runUntilTracking(600);
+
+            TEST_ASSERT_EQUAL_STRING("1", command(":Mge2000").c_str());
+            runFor(1);
+            periods[2] = simulation::interruptPeriod;
+            runFor(2);
+            TEST_ASSERT_EQUAL_STRING("1", command(":Mgn0500").c_str());
+            runFor(1);
+
+            command(":hP");
+            for (float waited = 0; simulation::mount.isParking() && (waited < 600); waited += 0.01f)
+            {
+                runFor(0.01f);
+            }
+            TEST_ASSERT_FALSE_MESSAGE(simulation::mount.isParking(), "The mount did not park");
+            runFor(1);
+            periods[3] = simulation::interruptPeriod;
+            simulation::interruptObserver = nullptr;
+
+            for (int axis = 0; axis < 3; axis++)
+            {
+                positions[axis] = simulation::mount.getCurrentStepperPosition(axisDirections[axis]);
+            }
+            trackingSteps = 0;
+            for (const Sample& sample : recorded[2])
+            {
+                trackingSteps += labs(sample.position - previous);
+                previous = sample.position;
+            }
+            trackingSteps += labs(positions[2] - previous); // Set after the interrupt stopped, as parking does
+        }
+
+        // The interrupt slows down while tracking and stops when parked, and loses no steps over
+        // it: the TRK stepper makes the same steps as with the interrupt fixed at its fastest, and
+        // every axis ends up in the same place. A TRK step can come up to a period later, which a
+        // slew that starts in between makes up for, so the slew steps themselves may differ.
+        void test_adaptive_interrupt_drops_no_steps()
+        {
+            unsigned long periods[4];
+            long fixedPositions[3];
+            long fixedTrackingSteps;
+            simulation::fixedInterruptPeriod = STEPPER_INTERRUPT_MIN_PERIOD;
+            runThroughTransitions(periods, fixedPositions, fixedTrackingSteps);
+            simulation::fixedInterruptPeriod = 0;
+
+            long positions[3];
+            long trackingSteps;
+            runThroughTransitions(periods, positions, trackingSteps);
+
+            TEST_ASSERT_EQUAL(STEPPER_INTERRUPT_MAX_PERIOD, periods[0]); // Tracking
+            TEST_ASSERT_EQUAL(STEPPER_INTERRUPT_MIN_PERIOD, periods[1]); // Slewing
+            TEST_ASSERT_GREATER_THAN(STEPPER_INTERRUPT_MIN_PERIOD, periods[2]); // Guiding
+            TEST_ASSERT_LESS_OR_EQUAL(STEPPER_INTERRUPT_MAX_PERIOD, periods[2]);
+            TEST_ASSERT_EQUAL(0, periods[3]); // Parked
+            TEST_ASSERT_EQUAL(fixedTrackingSteps, trackingSteps);
+            for (int axis = 0; axis < 3; axis++)
+            {
+                char name[] = { axisNames[axis], 0 };
+                TEST_ASSERT_EQUAL_MESSAGE(fixedPositions[axis], positions[axis], name);
+            }
+        }
+
+        void run() {
+            RUN_TEST(test_goto_across_meridian);
+            RUN_TEST(test_park_from_tracking);
+            RUN_TEST(test_home_after_guiding);
+            RUN_TEST(test_adaptive_interrupt_drops_no_steps);
+        }
+    }
+}
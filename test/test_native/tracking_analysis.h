@@ -0,0 +1,164 @@
+#pragma once
+
+#include <math.h>
+#include <stdio.h>
+#include <vector>
+
+// Measures how smoothly a list of step times (in microseconds) follows a constant rate,
+// e.g. the TRK steps the stepper interrupt makes while tracking. Step times come from
+// the simulation, or from a log with one time per line.
+//
+// Errors are positions in arcseconds of the axis:
+//   - against the commanded rate, which shows a rate that is off as a growing drift,
+//   - against the rate that fits the steps best, which leaves what varies from step to
+//     step (the jitter of the interrupt, periodic errors of the step generator).
+// The spectrum is of the second, so periodic errors stand out as peaks.
+namespace test {
+    namespace tracking_analysis {
+
+        #define TRACKING_SPECTRUM_PEAKS 3
+
+        struct Peak
+        {
+            float periodSeconds;
+            float amplitudeArcsec;
+        };
+
+        struct Report
+        {
+            int steps;
+            float seconds;
+            float commandedRate;       // Steps per second
+            float measuredRate;        // Best fit through the steps
+            float rateErrorPPM;        // Measured against commanded
+            float driftArcsecPerHour;  // What the rate error adds up to
+            float commandedRMS;        // Arcsec from the commanded rate, after removing the mean
+            float commandedPeak;
+            float residualRMS;         // Arcsec from the best fit rate
+            float residualPeak;
+            float intervalErrorRMS;    // Each step interval against the commanded one, in percent
+            float intervalErrorPeak;
+            Peak peaks[TRACKING_SPECTRUM_PEAKS];
+        };
+
+        float rms(const std::vector<float>& values, float* peak)
+        {
+            float sum = 0, mean, squares = 0;
+            for (float value : values)
+            {
+                sum += value;
+            }
+            mean = sum / values.size();
+            *peak = 0;
+            for (float value : values)
+            {
+                squares += (value - mean) * (value - mean);
+                *peak = max(*peak, fabsf(value - mean));
+            }
+            return sqrtf(squares / values.size());
+        }
+
+        // The step times should be of consecutive steps in one direction. arcsecPerStep is what
+        // one step moves the axis by.
+        Report analyze(const std::vector<unsigned long long>& stepMicros, float commandedRate, float arcsecPerStep)
+        {
+            Report report = {};
+            int count = stepMicros.size();
+            report.steps = count;
+            report.commandedRate = commandedRate;
+            if (count < 4)
+            {
+                return report;
+            }
+            unsigned long long first = stepMicros[0];
+            report.seconds = (stepMicros[count - 1] - first) / 1000000.0f;
+
+            // Least squares fit of step number against time
+            double sumT = 0, sumN = 0, sumTT = 0, sumTN = 0;
+            for (int i = 0; i < count; i++)
+            {
+                double t = (stepMicros[i] - first) / 1000000.0;
+                sumT += t;
+                sumN += i;
+                sumTT += t * t;
+                sumTN += t * i;
+            }
+            double rate = (count * sumTN - sumT * sumN) / (count * sumTT - sumT * sumT);
+            double offset = (sumN - rate * sumT) / count;
+            report.measuredRate = rate;
+            report.rateErrorPPM = (rate / commandedRate - 1.0) * 1000000.0;
+            report.driftArcsecPerHour = (rate - commandedRate) * 3600.0 * arcsecPerStep;
+
+            std::vector<float> commanded, residual, intervals;
+            for (int i = 0; i < count; i++)
+            {
+                double t = (stepMicros[i] - first) / 1000000.0;
+                commanded.push_back((i - commandedRate * t) * arcsecPerStep);
+                residual.push_back((i - offset - rate * t) * arcsecPerStep);
+                if (i > 0)
+                {
+                    double interval = (stepMicros[i] - stepMicros[i - 1]) / 1000000.0;
+                    intervals.push_back((interval * commandedRate - 1.0) * 100.0);
+                }
+            }
+            report.commandedRMS = rms(commanded, &report.commandedPeak);
+            report.residualRMS = rms(residual, &report.residualPeak);
+            report.intervalErrorRMS = rms(intervals, &report.intervalErrorPeak);
+
+            // The steps are close enough to evenly spaced to take the residual as sampled once
+            // per fitted step interval. A plain DFT is fast enough for an hour of tracking.
+            for (int k = 1; k <= count / 2; k++)
+            {
+                double re = 0, im = 0;
+                for (int i = 0; i < count; i++)
+                {
+                    double angle = 2.0 * M_PI * k * i / count;
+                    re += residual[i] * cos(angle);
+                    im -= residual[i] * sin(angle);
+                }
+                Peak peak = { (float)(count / rate / k), (float)(2.0 * sqrt(re * re + im * im) / count) };
+                for (int p = 0; p < TRACKING_SPECTRUM_PEAKS; p++)
+                {
+                    if (peak.amplitudeArcsec > report.peaks[p].amplitudeArcsec)
+                    {
+                        Peak smaller = report.peaks[p];
+                        report.peaks[p] = peak;
+                        peak = smaller;
+                    }
+                }
+            }
+            return report;
+        }
+
+        void print(FILE* file, const char* name, const Report& report)
+        {
+            fprintf(file, "%s: %d steps over %.0f s at %.5f steps/s, commanded %.5f (%+.0f ppm, %+.1f\"/h)\n", name, report.steps,
+                report.seconds, report.measuredRate, report.commandedRate, report.rateErrorPPM, report.driftArcsecPerHour);
+            fprintf(file, "%s: error RMS %.3f\" peak %.3f\" against the commanded rate, RMS %.3f\" peak %.3f\" against the fit\n", name,
+                report.commandedRMS, report.commandedPeak, report.residualRMS, report.residualPeak);
+            fprintf(file, "%s: step interval error RMS %.3f%% peak %.3f%%, spectrum peaks", name, report.intervalErrorRMS, report.intervalErrorPeak);
+            for (const Peak& peak : report.peaks)
+            {
+                fprintf(file, " %.3f\" at %.1f s", peak.amplitudeArcsec, peak.periodSeconds);
+            }
+            fprintf(file, "\n");
+        }
+
+        // Reads step times, one number of microseconds per line
+        bool readSteps(const char* path, std::vector<unsigned long long>& stepMicros)
+        {
+            FILE* file = fopen(path, "r");
+            if (file == nullptr)
+            {
+                return false;
+            }
+            unsigned long long micros;
+            while (fscanf(file, "%llu", &micros) == 1)
+            {
+                stepMicros.push_back(micros);
+            }
+            fclose(file);
+            return true;
+        }
+    }
+}